@@ -7,8 +7,8 @@ def print_and_run(cmd):
 
 
 def setting():
-    global model, simustep, nthreads, cutoff, toolbox, solver
-    model, simustep = '', int(1e5)
+    global model, simustep, exact, nthreads, cutoff, toolbox, solver
+    model, simustep, exact = '', int(1e5), False
     nthreads, cutoff = 8, 600
     toolbox, solver = '../build/bin', '../deps/kissat/build/kissat'
 
@@ -36,6 +36,8 @@ def setting():
         elif args[idx] == '--step':
             check('step')
             simustep = parse_int('step')
+        elif args[idx] == '--exact':
+            exact = True
         elif args[idx] == '--nThreads':
             check('nThreads')
             nthreads = parse_int('nThreads')
@@ -56,6 +58,7 @@ def setting():
                 "\n"
                 "  --model <model>         load model from <model> in 'AIG' format\n"
                 "  --step <n>              generate <n> random transitions (default 100000)\n"
+                "  --exact                 group the candidates by the exact simulation vectors (default: off)\n"
                 "  --nThreads <t>          number of <t> threads allowed (default 8)\n"
                 "  --cutoff <s>            the wall time for SAT solving is set to <s> (default 600 seconds)\n"
                 "  --toolbox <path>        the path of the toolbox is set to <path> (default '../build/bin')\n"
@@ -79,9 +82,11 @@ def simulate():
     out, log = fold + '/{}@res'.format(prefix), fold + '/{}@log'.format(prefix)
 
     s = random.randint(0, (2 ** 16) - 1)
-    print_and_run(
-        ['{}/simuaiger'.format(toolbox), '--model', model, '-s', str(s), '-r', str(simustep), '--log', log,
-         '--output', out])
+    cmd = ['{}/simuaiger'.format(toolbox), '--model', model, '-s', str(s), '-r', str(simustep), '--log', log,
+           '--output', out]
+    if exact:
+        cmd += ['--exact']
+    print_and_run(cmd)
 
 
 def solve():
@@ -7,8 +7,8 @@ def print_and_run(cmd):
 
 
 def setting():
-    global model, bound, simustep, nthreads, cutoff, toolbox, solver
-    model, bound, simustep = '', 0, int(1e5)
+    global model, bound, simustep, slices, exact, nthreads, cutoff, toolbox, solver
+    model, bound, simustep, slices, exact = '', 0, int(1e5), 0, False
     nthreads, cutoff = 8, 600
     toolbox, solver = '../build/bin', '../deps/kissat/build/kissat'
 
@@ -39,6 +39,11 @@ def setting():
         elif args[idx] == '--step':
             check('step')
             simustep = parse_int('step')
+        elif args[idx] == '--slices':
+            check('slices')
+            slices = parse_int('slices')
+        elif args[idx] == '--exact':
+            exact = True
         elif args[idx] == '--nThreads':
             check('nThreads')
             nthreads = parse_int('nThreads')
@@ -60,6 +65,8 @@ def setting():
                 "  --model <model>         load model from <model> in 'BTOR' format\n"
                 "  --bound <b>             Bound to check up until <b> (default: 0)\n"
                 "  --step <n>              generate <n> random transitions (default 100000)\n"
+                "  --slices <w>            also check the <w>-bit slices of wider nodes (default: off)\n"
+                "  --exact                 group the candidates by the exact simulation vectors (default: off)\n"
                 "  --nThreads <t>          number of <t> threads allowed (default 8)\n"
                 "  --cutoff <s>            the wall time for SAT solving is set to <s> (default 600 seconds)\n"
                 "  --toolbox <path>        the path of the toolbox is set to <path> (default '../build/bin')\n"
@@ -87,21 +94,27 @@ def simulate():
     s = random.randint(0, (2 ** 16) - 1)
     print_and_run(['{}/btorexpand'.format(toolbox), '--model', model, '--output', enm, '-e', str(bound)])
     print_and_run(['{}/btoreliminate'.format(toolbox), '--model', enm, '--output', gnm])
-    print_and_run(
-        ['{}/simubtor'.format(toolbox), '--model', gnm, '-s', str(s), '-r', str(simustep), '--log', log, '--output',
-         out, '--check-all'])
+    cmd = ['{}/simubtor'.format(toolbox), '--model', gnm, '-s', str(s), '-r', str(simustep), '--log', log, '--output',
+           out, '--check-all']
+    if slices:
+        cmd += ['--slices', str(slices)]
+    if exact:
+        cmd += ['--exact']
+    print_and_run(cmd)
 
 
 def solve():
     tans, unsat_cnt, timeout_cnt, total = [], 0, 0, 0
+    refuted = set()
 
     def run_cmd(x, y):
         nonlocal unsat_cnt, timeout_cnt, total, tans
         total += 1
-        fnm = str(x) + '+' + str(y)
-        onm = fold + '/{}@{}+{}'.format(prefix, x, y)
+        # a candidate is a node 'n' or a slice 'n[u:l]' of it
+        fnm = re.sub(r'\W', '_', x) + '+' + re.sub(r'\W', '_', y)
+        onm = fold + '/{}@{}'.format(prefix, fnm)
         try:
-            cmd = ['{}/btorextract'.format(toolbox), '--model', enm, '--node', str(x), str(y), '0', '--output',
+            cmd = ['{}/btorextract'.format(toolbox), '--model', enm, '--node', x, y, '0', '--output',
                    onm + '.btor2']
             res = subprocess.check_output(cmd, timeout=cutoff).decode()
             print('{} >> {}'.format(' '.join(cmd), res.strip()), file=sys.stderr)
@@ -131,6 +144,7 @@ def solve():
                     tans.append((x, y))
                 elif e.count('exit status 10'):
                     res = 'SATISFIABLE'
+                    refuted.add((x, y))
                 else:
                     exit(1)
                 print('--> solve {} >> {}'.format(fnm, res), file=sys.stderr)
@@ -138,18 +152,35 @@ def solve():
             print('--> error {}'.format(fnm), file=sys.stderr)
         semaphore.release()
 
-    pool = []
+    # simubtor writes every class as a star, each member paired with the
+    # representative, so the pairs of one representative form a class
+    classes = {}
     with open(out, 'r') as f:
         for pir in f.readlines():
-            x, y = map(int, pir.split(' '))
-            t = threading.Thread(target=run_cmd, args=(x, y,))
-            t.daemon = True
-            pool.append(t)
-
-            semaphore.acquire()
-            t.start()
-    for t in pool:
-        t.join()
+            x, y = pir.split()
+            classes.setdefault(x, []).append(y)
+
+    while classes:
+        pool = []
+        for x, members in classes.items():
+            for y in members:
+                t = threading.Thread(target=run_cmd, args=(x, y,))
+                t.daemon = True
+                pool.append(t)
+
+                semaphore.acquire()
+                t.start()
+        for t in pool:
+            t.join()
+
+        # the members refuted against their representative may still be
+        # equivalent to each other and form the classes of the next round
+        rounds = {}
+        for x, members in classes.items():
+            rest = [y for y in members if (x, y) in refuted]
+            if len(rest) > 1:
+                rounds[rest[0]] = rest[1:]
+        classes = rounds
 
     global listname
     listname = fold + '/{}@list'.format(prefix)
@@ -0,0 +1,333 @@
+//
+// Created by CSHwang on 2026/10/18.
+//
+
+#include <cctype>
+#include <cstdio>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+#include <cinttypes>
+
+#include <cassert>
+#include <chrono>
+#include <vector>
+
+#include "btorsim/btorsimbv.h"
+#include "btorsim/btorsimrng.h"
+#include "util/btor2mem.h"
+
+/*------------------------------------------------------------------------*/
+
+/* counted by 'btorsim_malloc' and friends, see 'BTOR2_MEM_STATS' */
+size_t btor2_mem_allocs, btor2_mem_bytes;
+
+static const char *usage =
+    "usage: bench_btorsimbv [ <option> ... ] [ <op> ... ]\n"
+    "\n"
+    "where <option> is one of the following\n"
+    "\n"
+    "  -h                      print this command line option summary\n"
+    "  -s <s>                  random seed of the operands (default 0)\n"
+    "  -t <t>                  run every operator for at least <t> ms (default 10)\n"
+    "  -w <w>                  benchmark width <w>, may be given several times\n"
+    "                          (default 1, 8, 32, 64, 65, 128, 256 and 1024)\n"
+    "  --output <output>       write results to <output>\n"
+    "\n"
+    "and <op> restricts the benchmark to the operators of that name, where\n"
+    "'<op>_into' is the variant writing into a preallocated bit-vector.\n"
+    "\n"
+    "The results are written as CSV with the columns\n"
+    "\n"
+    "  op,width,iterations,ns_per_op,allocs_per_op,bytes_per_op\n";
+
+static FILE *output_file;
+static const char *output_path;
+static int32_t seed;
+static int32_t target_ms = 10;
+static std::vector<uint32_t> widths;
+static std::vector<const char *> selected_ops;
+
+/* operands are cycled through to keep the branches of the operators honest */
+static const uint32_t num_operands = 64;
+
+/*------------------------------------------------------------------------*/
+
+static int32_t parse_int(const char *str, int32_t *res_ptr) {
+  const char *p = str;
+  if (!*p) return 0;
+  if (*p == '0' && p[1]) return 0;
+  int32_t res = 0;
+  while (*p) {
+    const int32_t ch = *p++;
+    if (!isdigit(ch)) return 0;
+    if (INT_MAX / 10 < res) return 0;
+    res *= 10;
+    const int32_t digit = ch - '0';
+    if (INT_MAX - digit < res) return 0;
+    res += digit;
+  }
+  *res_ptr = res;
+  return 1;
+}
+
+static bool selected(const char *name) {
+  if (selected_ops.empty()) return true;
+  for (auto op : selected_ops)
+    if (!strcmp(op, name)) return true;
+  return false;
+}
+
+/* the operands of one width and the preallocated results of the '_into'
+ * variants, 'c' are conditions and 'sh' shift amounts below the width */
+struct Operands {
+  uint32_t width;
+  std::vector<BtorSimBitVector *> a, b, c, sh;
+  std::vector<uint64_t> words;
+  std::vector<char *> bin;
+  BtorSimBitVector *res, *res1, *res2, *half;
+  std::vector<BTORSIM_BV_TYPE> scratch;
+
+  Operands(BtorSimRNG *rng, uint32_t w) : width(w) {
+    for (uint32_t k = 0; k < num_operands; ++k) {
+      a.push_back(btorsim_bv_new_random(rng, w));
+      b.push_back(btorsim_bv_new_random(rng, w));
+      c.push_back(btorsim_bv_new_random(rng, 1));
+      sh.push_back(btorsim_bv_uint64_to_bv(btorsim_rng_rand(rng) % w, w));
+      bin.push_back(btorsim_bv_to_char(a.back()));
+      words.resize(words.size() + a.back()->len);
+      btorsim_bv_to_words(a.back(), words.data() + k * a.back()->len);
+    }
+    res = btorsim_bv_new(w);
+    res1 = btorsim_bv_new(1);
+    res2 = btorsim_bv_new(2 * w);
+    half = btorsim_bv_new(w - w / 2);
+    scratch.resize(btorsim_bv_scratch_limbs(w));
+  }
+
+  ~Operands() {
+    for (uint32_t k = 0; k < num_operands; ++k) {
+      btorsim_bv_free(a[k]);
+      btorsim_bv_free(b[k]);
+      btorsim_bv_free(c[k]);
+      btorsim_bv_free(sh[k]);
+      free(bin[k]);
+    }
+    btorsim_bv_free(res);
+    btorsim_bv_free(res1);
+    btorsim_bv_free(res2);
+    btorsim_bv_free(half);
+  }
+};
+
+/* run 'f' on the operands round robin, doubling the iterations until the
+ * loop takes 'target_ms', and report the last loop */
+template <typename F>
+static void measure(const char *name, uint32_t width, F f) {
+  if (!selected(name)) return;
+  using clock = std::chrono::steady_clock;
+  for (uint64_t iterations = num_operands;; iterations *= 2) {
+    size_t allocs = btor2_mem_allocs, bytes = btor2_mem_bytes;
+    auto start = clock::now();
+    for (uint64_t i = 0; i < iterations; ++i) f(i % num_operands);
+    double ns = std::chrono::duration<double, std::nano>(clock::now() - start).count();
+    if (ns < target_ms * 1e6 && iterations < (1ull << 40)) continue;
+    fprintf(output_file,
+            "%s,%u,%" PRIu64 ",%.2f,%.2f,%.2f\n",
+            name,
+            width,
+            iterations,
+            ns / iterations,
+            (double) (btor2_mem_allocs - allocs) / iterations,
+            (double) (btor2_mem_bytes - bytes) / iterations);
+    fflush(output_file);
+    return;
+  }
+}
+
+/*------------------------------------------------------------------------*/
+
+typedef BtorSimBitVector *(*Unary)(const BtorSimBitVector *);
+typedef void (*UnaryInto)(BtorSimBitVector *, const BtorSimBitVector *);
+typedef BtorSimBitVector *(*Binary)(const BtorSimBitVector *, const BtorSimBitVector *);
+typedef void (*BinaryInto)(BtorSimBitVector *, const BtorSimBitVector *, const BtorSimBitVector *);
+typedef void (*DivisionInto)(BtorSimBitVector *,
+                             const BtorSimBitVector *,
+                             const BtorSimBitVector *,
+                             BTORSIM_BV_TYPE *);
+
+static const struct {
+  const char *name, *name_into;
+  Unary op;
+  UnaryInto op_into;
+  bool predicate;
+} unary_ops[] = {
+    {"neg", "neg_into", btorsim_bv_neg, btorsim_bv_neg_into, false},
+    {"not", "not_into", btorsim_bv_not, btorsim_bv_not_into, false},
+    {"inc", "inc_into", btorsim_bv_inc, btorsim_bv_inc_into, false},
+    {"dec", "dec_into", btorsim_bv_dec, btorsim_bv_dec_into, false},
+    {"redand", "redand_into", btorsim_bv_redand, btorsim_bv_redand_into, true},
+    {"redor", "redor_into", btorsim_bv_redor, btorsim_bv_redor_into, true},
+    {"redxor", "redxor_into", btorsim_bv_redxor, btorsim_bv_redxor_into, true},
+};
+
+static const struct {
+  const char *name, *name_into;
+  Binary op;
+  BinaryInto op_into;
+  bool predicate, shift;
+} binary_ops[] = {
+    {"add", "add_into", btorsim_bv_add, btorsim_bv_add_into, false, false},
+    {"sub", "sub_into", btorsim_bv_sub, btorsim_bv_sub_into, false, false},
+    {"and", "and_into", btorsim_bv_and, btorsim_bv_and_into, false, false},
+    {"implies", "implies_into", btorsim_bv_implies, btorsim_bv_implies_into, false, false},
+    {"or", "or_into", btorsim_bv_or, btorsim_bv_or_into, false, false},
+    {"nand", "nand_into", btorsim_bv_nand, btorsim_bv_nand_into, false, false},
+    {"nor", "nor_into", btorsim_bv_nor, btorsim_bv_nor_into, false, false},
+    {"xnor", "xnor_into", btorsim_bv_xnor, btorsim_bv_xnor_into, false, false},
+    {"xor", "xor_into", btorsim_bv_xor, btorsim_bv_xor_into, false, false},
+    {"eq", "eq_into", btorsim_bv_eq, btorsim_bv_eq_into, true, false},
+    {"neq", "neq_into", btorsim_bv_neq, btorsim_bv_neq_into, true, false},
+    {"ult", "ult_into", btorsim_bv_ult, btorsim_bv_ult_into, true, false},
+    {"ulte", "ulte_into", btorsim_bv_ulte, btorsim_bv_ulte_into, true, false},
+    {"slt", "slt_into", btorsim_bv_slt, btorsim_bv_slt_into, true, false},
+    {"slte", "slte_into", btorsim_bv_slte, btorsim_bv_slte_into, true, false},
+    {"sll", "sll_into", btorsim_bv_sll, btorsim_bv_sll_into, false, true},
+    {"srl", "srl_into", btorsim_bv_srl, btorsim_bv_srl_into, false, true},
+    {"sra", "sra_into", btorsim_bv_sra, btorsim_bv_sra_into, false, true},
+    {"mul", "mul_into", btorsim_bv_mul, btorsim_bv_mul_into, false, false},
+};
+
+static const struct {
+  const char *name, *name_into;
+  Binary op;
+  DivisionInto op_into;
+} division_ops[] = {
+    {"udiv", "udiv_into", btorsim_bv_udiv, btorsim_bv_udiv_into},
+    {"sdiv", "sdiv_into", btorsim_bv_sdiv, btorsim_bv_sdiv_into},
+    {"urem", "urem_into", btorsim_bv_urem, btorsim_bv_urem_into},
+    {"srem", "srem_into", btorsim_bv_srem, btorsim_bv_srem_into},
+};
+
+static void bench_width(BtorSimRNG *rng, uint32_t w) {
+  Operands o(rng, w);
+  auto &a = o.a, &b = o.b, &c = o.c, &sh = o.sh;
+
+  measure("new", w, [&](uint32_t) { btorsim_bv_free(btorsim_bv_new(w)); });
+  measure("new_random", w, [&](uint32_t) { btorsim_bv_free(btorsim_bv_new_random(rng, w)); });
+  measure("random_into", w, [&](uint32_t) { btorsim_bv_random_into(o.res, rng); });
+  measure("one", w, [&](uint32_t) { btorsim_bv_free(btorsim_bv_one(w)); });
+  measure("one_into", w, [&](uint32_t) { btorsim_bv_one_into(o.res); });
+  measure("ones", w, [&](uint32_t) { btorsim_bv_free(btorsim_bv_ones(w)); });
+  measure("ones_into", w, [&](uint32_t) { btorsim_bv_ones_into(o.res); });
+  measure("copy", w, [&](uint32_t k) { btorsim_bv_free(btorsim_bv_copy(a[k])); });
+  measure("copy_into", w, [&](uint32_t k) { btorsim_bv_copy_into(o.res, a[k]); });
+
+  measure("char_to_bv", w, [&](uint32_t k) { btorsim_bv_free(btorsim_bv_char_to_bv(o.bin[k])); });
+  measure("uint64_to_bv", w, [&](uint32_t k) {
+    btorsim_bv_free(btorsim_bv_uint64_to_bv(a[k]->bits[0], w));
+  });
+  measure("uint64_into", w, [&](uint32_t k) { btorsim_bv_uint64_into(o.res, a[k]->bits[0]); });
+  measure("words_to_bv", w, [&](uint32_t k) {
+    btorsim_bv_free(btorsim_bv_words_to_bv(o.words.data() + k * a[k]->len, w));
+  });
+  measure("words_into", w, [&](uint32_t k) {
+    btorsim_bv_words_into(o.res, o.words.data() + k * a[k]->len);
+  });
+  measure("to_words", w, [&](uint32_t k) { btorsim_bv_to_words(a[k], o.res->bits); });
+  measure("to_char", w, [&](uint32_t k) { free(btorsim_bv_to_char(a[k])); });
+  measure("to_hex_char", w, [&](uint32_t k) { free(btorsim_bv_to_hex_char(a[k])); });
+  measure("to_dec_char", w, [&](uint32_t k) { free(btorsim_bv_to_dec_char(a[k])); });
+
+  measure("compare", w, [&](uint32_t k) { o.res1->bits[0] = btorsim_bv_compare(a[k], b[k]) > 0; });
+  measure("hash", w, [&](uint32_t k) { o.res1->bits[0] = btorsim_bv_hash(a[k]) & 1; });
+  measure("keyed_hash", w, [&](uint32_t k) {
+    o.res1->bits[0] = btorsim_bv_keyed_hash(a[k], b[k]->bits[0]) & 1;
+  });
+  measure("is_umulo", w, [&](uint32_t k) { o.res1->bits[0] = btorsim_bv_is_umulo(a[k], b[k]); });
+
+  for (auto &u : unary_ops) {
+    BtorSimBitVector *res = u.predicate ? o.res1 : o.res;
+    measure(u.name, w, [&](uint32_t k) { btorsim_bv_free(u.op(a[k])); });
+    measure(u.name_into, w, [&](uint32_t k) { u.op_into(res, a[k]); });
+  }
+
+  for (auto &f : binary_ops) {
+    BtorSimBitVector *res = f.predicate ? o.res1 : o.res;
+    auto &rhs = f.shift ? sh : b;
+    measure(f.name, w, [&](uint32_t k) { btorsim_bv_free(f.op(a[k], rhs[k])); });
+    measure(f.name_into, w, [&](uint32_t k) { f.op_into(res, a[k], rhs[k]); });
+  }
+
+  for (auto &f : division_ops) {
+    measure(f.name, w, [&](uint32_t k) { btorsim_bv_free(f.op(a[k], b[k])); });
+    measure(f.name_into, w, [&](uint32_t k) { f.op_into(o.res, a[k], b[k], o.scratch.data()); });
+  }
+
+  measure("ite", w, [&](uint32_t k) { btorsim_bv_free(btorsim_bv_ite(c[k], a[k], b[k])); });
+  measure("ite_into", w, [&](uint32_t k) { btorsim_bv_ite_into(o.res, c[k], a[k], b[k]); });
+  measure("concat", w, [&](uint32_t k) { btorsim_bv_free(btorsim_bv_concat(a[k], b[k])); });
+  measure("concat_into", w, [&](uint32_t k) { btorsim_bv_concat_into(o.res2, a[k], b[k]); });
+  measure("slice", w, [&](uint32_t k) { btorsim_bv_free(btorsim_bv_slice(a[k], w - 1, w / 2)); });
+  measure("slice_into", w, [&](uint32_t k) { btorsim_bv_slice_into(o.half, a[k], w - 1, w / 2); });
+  measure("uext", w, [&](uint32_t k) { btorsim_bv_free(btorsim_bv_uext(a[k], w)); });
+  measure("uext_into", w, [&](uint32_t k) { btorsim_bv_uext_into(o.res2, a[k]); });
+  measure("sext", w, [&](uint32_t k) { btorsim_bv_free(btorsim_bv_sext(a[k], w)); });
+  measure("sext_into", w, [&](uint32_t k) { btorsim_bv_sext_into(o.res2, a[k]); });
+  measure("flipped_bit", w, [&](uint32_t k) {
+    btorsim_bv_free(btorsim_bv_flipped_bit(a[k], sh[k]->bits[0]));
+  });
+  measure("flipped_bit_range", w, [&](uint32_t k) {
+    btorsim_bv_free(btorsim_bv_flipped_bit_range(a[k], w - 1, sh[k]->bits[0]));
+  });
+}
+
+/*------------------------------------------------------------------------*/
+
+int main(int argc, char const *argv[]) {
+  for (int i = 1; i < argc; ++i) {
+    if (!strcmp(argv[i], "-h")) {
+      fputs(usage, stdout);
+      exit(1);
+    } else if (!strcmp(argv[i], "-s") || !strcmp(argv[i], "-t") || !strcmp(argv[i], "-w")) {
+      const char *opt = argv[i];
+      int32_t value;
+      if (++i == argc) {
+        fprintf(stderr, "*** 'bench_btorsimbv' error: argument to '%s' missing\n", opt);
+        exit(1);
+      }
+      if (!parse_int(argv[i], &value) || (opt[1] != 's' && !value)) {
+        fprintf(stderr, "*** 'bench_btorsimbv' error: invalid number in '%s %s'\n", opt, argv[i]);
+        exit(1);
+      }
+      if (opt[1] == 's') seed = value;
+      else if (opt[1] == 't') target_ms = value;
+      else widths.push_back((uint32_t) value);
+    } else if (!strcmp(argv[i], "--output")) {
+      if (++i == argc) {
+        fprintf(stderr, "*** 'bench_btorsimbv' error: argument to '--output' missing\n");
+        exit(1);
+      }
+      output_path = argv[i];
+    } else if (argv[i][0] == '-') {
+      fprintf(stderr, "*** 'bench_btorsimbv' error: invalid command line option '%s'\n", argv[i]);
+      exit(1);
+    } else
+      selected_ops.push_back(argv[i]);
+  }
+  if (widths.empty()) widths = {1, 8, 32, 64, 65, 128, 256, 1024};
+  if (!output_path)
+    output_file = stdout;
+  else if (!(output_file = fopen(output_path, "w"))) {
+    fprintf(stderr, "*** 'bench_btorsimbv' error: failed to open '%s' for writing\n", output_path);
+    exit(1);
+  }
+
+  BtorSimRNG rng;
+  btorsim_rng_init(&rng, seed);
+  fputs("op,width,iterations,ns_per_op,allocs_per_op,bytes_per_op\n", output_file);
+  for (uint32_t w : widths) bench_width(&rng, w);
+
+  if (output_file != stdout) fclose(output_file);
+  return 0;
+}
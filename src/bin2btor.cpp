@@ -0,0 +1,72 @@
+//
+// Created by CSHwang on 2026/10/18.
+//
+
+#include <cstdlib>
+#include <cstring>
+
+#include "btorfunc.h"
+
+/*------------------------------------------------------------------------*/
+
+static Btor2Parser *model;
+
+static FILE *model_file;
+static FILE *output_file;
+static const char *model_path;
+static const char *output_path;
+
+static const char *usage =
+    "usage: bin2btor [ <option> ... ]\n"
+    "\n"
+    "where <option> is one of the following\n"
+    "\n"
+    "  -h                      print this command line option summary\n"
+    "  --model <model>         load model from <model> in binary or text 'BTOR' format\n"
+    "  --output <output>       write result to <output> in 'BTOR' format\n";
+
+/*------------------------------------------------------------------------*/
+
+static int32_t print_model_line(void *, Btor2Line *line) {
+  print_line("bin2btor", output_file, line);
+  return 1;
+}
+
+int main(int argc, char const *argv[]) {
+  for (int i = 1; i < argc; ++i) {
+    if (!strcmp(argv[i], "-h")) {
+      fputs(usage, stdout);
+      exit(1);
+    } else if (!strcmp(argv[i], "--model")) {
+      if (++i == argc) {
+        fprintf(stderr, "*** 'bin2btor' error: argument to '--model' missing\n");
+        exit(1);
+      }
+      model_path = argv[i];
+    } else if (!strcmp(argv[i], "--output")) {
+      if (++i == argc) {
+        fprintf(stderr, "*** 'bin2btor' error: argument to '--output' missing\n");
+        exit(1);
+      }
+      output_path = argv[i];
+    } else {
+      fprintf(stderr, "*** 'bin2btor' error: invalid command line option '%s'\n", argv[i]);
+      exit(1);
+    }
+  }
+  open("bin2btor", model_path, model_file, "<stdin>", stdin, 1);
+  open("bin2btor", output_path, output_file, "<stdout>", stdout, 0);
+
+  model = btor2parser_new();
+  if (!btor2parser_stream_lines(model, model_file, print_model_line, nullptr)) {
+    fprintf(stderr, "*** 'bin2btor' error: parse error in '%s' at %s\n", model_path, btor2parser_error(model));
+    exit(1);
+  }
+  if (fflush(output_file) || ferror(output_file)) {
+    fprintf(stderr, "*** 'bin2btor' error: failed to write '%s'\n", output_path);
+    exit(1);
+  }
+  btor2parser_delete(model);
+
+  return 0;
+}
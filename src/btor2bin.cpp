@@ -0,0 +1,67 @@
+//
+// Created by CSHwang on 2026/10/18.
+//
+
+#include <cstdlib>
+#include <cstring>
+
+#include "btorfunc.h"
+
+/*------------------------------------------------------------------------*/
+
+static Btor2Parser *model;
+
+static FILE *model_file;
+static FILE *output_file;
+static const char *model_path;
+static const char *output_path;
+
+static const char *usage =
+    "usage: btor2bin [ <option> ... ]\n"
+    "\n"
+    "where <option> is one of the following\n"
+    "\n"
+    "  -h                      print this command line option summary\n"
+    "  --model <model>         load model from <model> in 'BTOR' format\n"
+    "  --output <output>       write result to <output> in binary 'BTOR' format\n";
+
+/*------------------------------------------------------------------------*/
+
+int main(int argc, char const *argv[]) {
+  for (int i = 1; i < argc; ++i) {
+    if (!strcmp(argv[i], "-h")) {
+      fputs(usage, stdout);
+      exit(1);
+    } else if (!strcmp(argv[i], "--model")) {
+      if (++i == argc) {
+        fprintf(stderr, "*** 'btor2bin' error: argument to '--model' missing\n");
+        exit(1);
+      }
+      model_path = argv[i];
+    } else if (!strcmp(argv[i], "--output")) {
+      if (++i == argc) {
+        fprintf(stderr, "*** 'btor2bin' error: argument to '--output' missing\n");
+        exit(1);
+      }
+      output_path = argv[i];
+    } else {
+      fprintf(stderr, "*** 'btor2bin' error: invalid command line option '%s'\n", argv[i]);
+      exit(1);
+    }
+  }
+  open("btor2bin", model_path, model_file, "<stdin>", stdin, 1);
+  open("btor2bin", output_path, output_file, "<stdout>", stdout, 0);
+
+  model = btor2parser_new();
+  if (!btor2parser_read_lines(model, model_file)) {
+    fprintf(stderr, "*** 'btor2bin' error: parse error in '%s' at %s\n", model_path, btor2parser_error(model));
+    exit(1);
+  }
+  if (!btor2parser_write_binary(model, output_file) || fflush(output_file)) {
+    fprintf(stderr, "*** 'btor2bin' error: failed to write '%s'\n", output_path);
+    exit(1);
+  }
+  btor2parser_delete(model);
+
+  return 0;
+}
@@ -16,21 +16,84 @@
 #include <assert.h>
 #include <ctype.h>
 #include <inttypes.h>
+#include <pthread.h>
 #include <stdarg.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 #include "util/btor2stack.h"
 
+/* Inputs are split into chunks of at least this many bytes, one per thread.
+ */
+#ifndef BTOR2_PARSER_CHUNK
+#define BTOR2_PARSER_CHUNK (1 << 22)
+#endif
+
+/* Lines and their arguments are carved out of blocks of this size, which
+ * are only released as a whole when the parser is reset or deleted.
+ */
+#ifndef BTOR2_PARSER_BLOCK
+#define BTOR2_PARSER_BLOCK (1 << 20)
+#endif
+
+/* Number of scratch lines for looking up earlier lines while streaming.
+ * The checks of a line hold at most three arguments and one more line.
+ */
+#define BTOR2_PARSER_VIEWS 4
+
+typedef struct Btor2ParserBlock Btor2ParserBlock;
+typedef struct Btor2ParserNode Btor2ParserNode;
+
+struct Btor2ParserBlock
+{
+  Btor2ParserBlock *next;
+  int64_t data[];
+};
+
+#define BTOR2_NODE_DEFINED 1
+#define BTOR2_NODE_INIT 2
+#define BTOR2_NODE_NEXT 4
+
+/* While streaming, each id only keeps what the checks of later lines need.
+ */
+struct Btor2ParserNode
+{
+  int64_t sort;  /* sort id, or index into 'sorts' for sort lines */
+  int64_t input; /* an input in the cone of the node, zero if none */
+  uint8_t tag, flags;
+};
+
 struct Btor2Parser
 {
   char *error;
   Btor2Line **table, *new_line;
   Btor2Sort **stable;
-  int64_t sztable, ntable, szstable, nstable, szbuf, nbuf, lineno;
-  int32_t saved;
-  char *buf;
+  int64_t sztable, ntable, szstable, nstable, lineno;
+  char *data, *cur, *end, *term;
+  size_t szdata;
+  int32_t mapped, deferred, streaming;
+  uint32_t nthreads;
+  Btor2ParserBlock *blocks;
+  char *top, *limit;
   FILE *file;
+  Btor2ParserNode *nodes;
+  Btor2Line **sorts, views[BTOR2_PARSER_VIEWS];
+  int64_t sznodes, szsorts, nsorts;
+  uint32_t nviews;
+};
+
+static const char *tag_names[] = {
+    "add", "and", "bad", "concat", "const", "constraint", "constd", "consth",
+    "dec", "eq", "fair", "iff", "implies", "inc", "init", "input", "ite",
+    "justice", "mul", "nand", "neq", "neg", "next", "nor", "not", "one", "ones",
+    "or", "output", "read", "redand", "redor", "redxor", "rol", "ror", "saddo",
+    "sdiv", "sdivo", "sext", "sgt", "sgte", "slice", "sll", "slt", "slte",
+    "sort", "smod", "smulo", "sra", "srem", "srl", "ssubo", "state", "sub",
+    "uaddo", "udiv", "uext", "ugt", "ugte", "ult", "ulte", "umulo", "urem",
+    "usubo", "write", "xnor", "xor", "zero",
 };
 
 static void *
@@ -79,37 +142,100 @@ btor2parser_new ()
   return res;
 }
 
+void
+btor2parser_set_threads (Btor2Parser *bfr, uint32_t nthreads)
+{
+  bfr->nthreads = nthreads;
+}
+
+static void *
+alloc_bfr (Btor2Parser *bfr, size_t size)
+{
+  Btor2ParserBlock *b;
+  size_t bytes;
+  void *res;
+  size = (size + sizeof (int64_t) - 1) & ~(sizeof (int64_t) - 1);
+  if ((size_t) (bfr->limit - bfr->top) < size)
+  {
+    bytes       = size < BTOR2_PARSER_BLOCK ? BTOR2_PARSER_BLOCK : size;
+    b           = btor2parser_malloc (sizeof *b + bytes);
+    b->next     = bfr->blocks;
+    bfr->blocks = b;
+    bfr->top    = (char *) b->data;
+    bfr->limit  = bfr->top + bytes;
+  }
+  res = bfr->top;
+  bfr->top += size;
+  return res;
+}
+
+/* The blocks of 'from' are handed over, the current block of 'bfr' stays. */
+static void
+adopt_blocks_bfr (Btor2Parser *bfr, Btor2Parser *from)
+{
+  Btor2ParserBlock *b = from->blocks;
+  if (!b) return;
+  while (b->next) b = b->next;
+  b->next      = bfr->blocks;
+  bfr->blocks  = from->blocks;
+  from->blocks = 0;
+}
+
+static void
+release_blocks_bfr (Btor2Parser *bfr)
+{
+  Btor2ParserBlock *b, *next;
+  for (b = bfr->blocks; b; b = next)
+  {
+    next = b->next;
+    free (b);
+  }
+  bfr->blocks = 0;
+  bfr->top = bfr->limit = 0;
+}
+
 static void
 reset_bfr (Btor2Parser *bfr)
 {
-  int32_t i;
   assert (bfr);
   if (bfr->error)
   {
     free (bfr->error);
     bfr->error = 0;
   }
-  if (bfr->table)
+  release_blocks_bfr (bfr);
+  if (bfr->streaming)
   {
-    for (i = 0; i < bfr->ntable; i++)
+    for (int64_t i = 0; i < bfr->nsorts; i++)
     {
-      Btor2Line *l = bfr->table[i];
-      if (!l) continue;
-      if (l->symbol) free (l->symbol);
-      if (l->constant) free (l->constant);
-      free (l->args);
-      free (l);
+      free (bfr->sorts[i]->symbol);
+      free (bfr->sorts[i]);
     }
+    free (bfr->sorts);
+    free (bfr->nodes);
+    bfr->sorts     = 0;
+    bfr->nodes     = 0;
+    bfr->ntable    = bfr->sznodes = bfr->szsorts = bfr->nsorts = 0;
+    bfr->file      = 0;
+    bfr->streaming = 0;
+  }
+  if (bfr->table)
+  {
     free (bfr->table);
     bfr->table  = 0;
     bfr->ntable = bfr->sztable = 0;
   }
-  if (bfr->buf)
+  if (bfr->data)
   {
-    free (bfr->buf);
-    bfr->buf  = 0;
-    bfr->nbuf = bfr->szbuf = 0;
+    if (bfr->mapped)
+      munmap (bfr->data, bfr->szdata);
+    else
+      free (bfr->data);
+    bfr->data   = 0;
+    bfr->szdata = 0;
+    bfr->mapped = 0;
   }
+  bfr->cur = bfr->end = bfr->term = 0;
 }
 
 void
@@ -119,24 +245,103 @@ btor2parser_delete (Btor2Parser *bfr)
   free (bfr);
 }
 
+/* Regular files are mapped privately and writable, so that symbols and
+ * constants can be terminated in place and referenced by the lines without
+ * copying them.  Other streams are read into a buffer first.
+ */
 static int32_t
+map_file_bfr (Btor2Parser *bfr, FILE *file)
+{
+  struct stat st;
+  off_t pos;
+  void *data;
+  int fd;
+
+  if ((fd = fileno (file)) < 0 || fstat (fd, &st) || !S_ISREG (st.st_mode))
+    return 0;
+  if ((pos = ftello (file)) < 0 || pos > st.st_size) return 0;
+  if (pos < st.st_size)
+  {
+    data = mmap (0, st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    if (data == MAP_FAILED) return 0;
+    madvise (data, st.st_size, MADV_SEQUENTIAL);
+    bfr->data   = data;
+    bfr->szdata = st.st_size;
+    bfr->mapped = 1;
+    bfr->cur    = bfr->data + pos;
+    bfr->end    = bfr->data + st.st_size;
+  }
+  fseeko (file, 0, SEEK_END);
+  return 1;
+}
+
+/* Reads the rest of 'file', after what is already buffered. */
+static void
+read_file_bfr (Btor2Parser *bfr, FILE *file)
+{
+  size_t size = bfr->data ? bfr->szdata : 1 << 16, r;
+  size_t pos = bfr->cur - bfr->data, n = bfr->end - bfr->data;
+  char *data = bfr->data ? bfr->data : btor2parser_malloc (size);
+  for (;;)
+  {
+    if (n == size)
+    {
+      size *= 2;
+      data = btor2parser_realloc (data, size);
+    }
+    if (!(r = fread (data + n, 1, size - n, file))) break;
+    n += r;
+  }
+  bfr->data   = data;
+  bfr->szdata = size;
+  bfr->cur    = data + pos;
+  bfr->end    = data + n;
+}
+
+/* While streaming, the buffer is refilled before each line so that it
+ * holds the whole line, and the lines before it are dropped.
+ */
+static void
+fill_bfr (Btor2Parser *bfr)
+{
+  size_t n = bfr->end - bfr->cur, r;
+  if (n && memchr (bfr->cur, '\n', n)) return;
+  if (n) memmove (bfr->data, bfr->cur, n);
+  bfr->cur = bfr->data;
+  bfr->end = bfr->data + n;
+  for (;;)
+  {
+    if (n == bfr->szdata)
+    {
+      bfr->szdata *= 2;
+      bfr->data = btor2parser_realloc (bfr->data, bfr->szdata);
+      bfr->cur  = bfr->data;
+      bfr->end  = bfr->data + n;
+    }
+    if (!(r = fread (bfr->data + n, 1, bfr->szdata - n, bfr->file))) break;
+    bfr->end = bfr->data + n + r;
+    if (memchr (bfr->data + n, '\n', r)) break;
+    n += r;
+  }
+}
+
+static inline int32_t
 getc_bfr (Btor2Parser *bfr)
 {
   int32_t ch;
-  if ((ch = bfr->saved) == EOF)
-    ch = getc (bfr->file);
-  else
-    bfr->saved = EOF;
+  if (bfr->cur == bfr->end) return EOF;
+  ch = (unsigned char) *bfr->cur++;
   if (ch == '\n') bfr->lineno++;
   return ch;
 }
 
-static void
+static inline void
 ungetc_bfr (Btor2Parser *bfr, int32_t ch)
 {
-  assert (bfr->saved == EOF);
   if (ch == EOF) return;
-  bfr->saved = ch;
+  assert (bfr->data < bfr->cur);
+  bfr->cur--;
+  assert ((unsigned char) *bfr->cur == ch);
   if (ch == '\n')
   {
     assert (bfr->lineno > 1);
@@ -162,19 +367,58 @@ perr_bfr (Btor2Parser *bfr, const char *fmt, ...)
 }
 
 static void
-pushc_bfr (Btor2Parser *bfr, int32_t ch)
+pushn_bfr (Btor2Parser *bfr, Btor2Line *l)
 {
-  if (bfr->nbuf >= bfr->szbuf)
+  Btor2ParserNode *n, *arg;
+  Btor2Line *s;
+  uint32_t i;
+  if (bfr->ntable >= bfr->sznodes)
+  {
+    bfr->sznodes = bfr->sznodes ? 2 * bfr->sznodes : 1;
+    bfr->nodes =
+        btor2parser_realloc (bfr->nodes, bfr->sznodes * sizeof *bfr->nodes);
+  }
+  n = bfr->nodes + bfr->ntable++;
+  memset (n, 0, sizeof *n);
+  if (!l) return;
+  n->tag   = l->tag;
+  n->flags = BTOR2_NODE_DEFINED;
+  n->sort  = l->sort.id;
+  if (l->tag == BTOR2_TAG_sort)
+  {
+    if (bfr->nsorts >= bfr->szsorts)
+    {
+      bfr->szsorts = bfr->szsorts ? 2 * bfr->szsorts : 1;
+      bfr->sorts   = btor2parser_realloc (bfr->sorts,
+                                        bfr->szsorts * sizeof *bfr->sorts);
+    }
+    s = btor2parser_malloc (sizeof *s);
+    *s = *l;
+    s->args   = 0;
+    s->symbol = l->symbol ? btor2parser_strdup (l->symbol) : 0;
+    n->sort   = bfr->nsorts;
+    bfr->sorts[bfr->nsorts++] = s;
+  }
+  else if (l->tag == BTOR2_TAG_input)
+    n->input = l->id;
+  else if (l->tag != BTOR2_TAG_state)
   {
-    bfr->szbuf = bfr->szbuf ? 2 * bfr->szbuf : 1;
-    bfr->buf   = btor2parser_realloc (bfr->buf, bfr->szbuf * sizeof *bfr->buf);
+    for (i = 0; !n->input && i < l->nargs; i++)
+    {
+      arg      = bfr->nodes + labs (l->args[i]);
+      n->input = arg->input;
+    }
   }
-  bfr->buf[bfr->nbuf++] = ch;
 }
 
 static void
 pusht_bfr (Btor2Parser *bfr, Btor2Line *l)
 {
+  if (bfr->streaming)
+  {
+    pushn_bfr (bfr, l);
+    return;
+  }
   if (bfr->ntable >= bfr->sztable)
   {
     bfr->sztable = bfr->sztable ? 2 * bfr->sztable : 1;
@@ -255,11 +499,33 @@ parse_pos_number_bfr (Btor2Parser *bfr, uint32_t *res)
   return 1;
 }
 
+/* Sort lines are kept while streaming, other lines are rebuilt from their
+ * node in a scratch line that is only valid for the checks of one line.
+ */
+static Btor2Line *
+node2line_bfr (Btor2Parser *bfr, int64_t id)
+{
+  Btor2ParserNode *n = bfr->nodes + id;
+  Btor2Line *res;
+  if (!(n->flags & BTOR2_NODE_DEFINED)) return 0;
+  if (n->tag == BTOR2_TAG_sort) return bfr->sorts[n->sort];
+  res = bfr->views + bfr->nviews++ % BTOR2_PARSER_VIEWS;
+  memset (res, 0, sizeof *res);
+  res->id   = id;
+  res->tag  = n->tag;
+  res->name = tag_names[n->tag];
+  if (n->sort) res->sort = bfr->sorts[bfr->nodes[n->sort].sort]->sort;
+  res->init = (n->flags & BTOR2_NODE_INIT) != 0;
+  res->next = (n->flags & BTOR2_NODE_NEXT) != 0;
+  return res;
+}
+
 static Btor2Line *
 id2line_bfr (Btor2Parser *bfr, int64_t id)
 {
   int64_t absid = labs (id);
   if (!absid || absid >= bfr->ntable) return 0;
+  if (bfr->streaming) return node2line_bfr (bfr, absid);
   return bfr->table[absid];
 }
 
@@ -297,29 +563,43 @@ cmp_sorts (Btor2Parser *bfr, Btor2Line *l1, Btor2Line *l2)
 }
 
 static int32_t
-parse_sort_id_bfr (Btor2Parser *bfr, Btor2Sort *res)
+check_sort_id_bfr (Btor2Parser *bfr, int64_t sort_id)
 {
-  int64_t sort_id;
   Btor2Line *s;
-  if (!parse_id_bfr (bfr, &sort_id)) return 0;
-
   if (sort_id >= bfr->ntable || id2line_bfr (bfr, sort_id) == 0)
     return perr_bfr (bfr, "undefined sort id");
 
   s = id2line_bfr (bfr, sort_id);
   if (s->tag != BTOR2_TAG_sort)
     return perr_bfr (bfr, "id after tag is not a sort id");
-  *res = s->sort;
   return 1;
 }
 
+static int32_t
+parse_sort_id_bfr (Btor2Parser *bfr, Btor2Sort *res)
+{
+  int64_t sort_id;
+  if (!parse_id_bfr (bfr, &sort_id)) return 0;
+  if (bfr->deferred)
+  {
+    res->id = sort_id;
+    return 1;
+  }
+  if (!check_sort_id_bfr (bfr, sort_id)) return 0;
+  *res = id2line_bfr (bfr, sort_id)->sort;
+  return 1;
+}
+
+/* Tags are not terminated, 'len' is set to their length instead. */
 static const char *
-parse_tag (Btor2Parser *bfr)
+parse_tag (Btor2Parser *bfr, size_t *len)
 {
+  const char *res = bfr->cur;
   int32_t ch;
-  bfr->nbuf = 0;
-  while ('a' <= (ch = getc_bfr (bfr)) && ch <= 'z') pushc_bfr (bfr, ch);
-  if (!bfr->nbuf)
+  while ('a' <= (ch = getc_bfr (bfr)) && ch <= 'z')
+    ;
+  *len = bfr->cur - res - (ch != EOF);
+  if (!*len)
   {
     perr_bfr (bfr, "expected tag");
     return 0;
@@ -329,47 +609,57 @@ parse_tag (Btor2Parser *bfr)
     perr_bfr (bfr, "expected space after tag");
     return 0;
   }
-  pushc_bfr (bfr, 0);
-  return bfr->buf;
+  return res;
+}
+
+static int32_t
+eq_tag (const char *tag, size_t len, const char *name)
+{
+  return !strncmp (tag, name, len) && !name[len];
 }
 
 static int32_t
-parse_symbol_bfr (Btor2Parser *bfr)
+parse_symbol_bfr (Btor2Parser *bfr, char **res)
 {
+  char *start = bfr->cur, *end = 0;
   int32_t ch;
-  bfr->nbuf = 0;
   while ((ch = getc_bfr (bfr)) != '\n')
   {
     if (ch == EOF)
       return perr_bfr (bfr, "unexpected end-of-file in symbol");
     else if (ch == ' ' || ch == '\t')
     {
-      ch = getc_bfr (bfr);
-      if (ch == ';')
-      {
-        if (!skip_comment (bfr)) return 0;
-        break;
-      }
-      else
+      end = bfr->cur - 1;
+      if (getc_bfr (bfr) != ';')
         return perr_bfr (bfr, "unexpected white-space in symbol");
+      if (!skip_comment (bfr)) return 0;
+      break;
     }
-    pushc_bfr (bfr, ch);
   }
-  if (!bfr->nbuf)
+  if (ch == '\n') end = bfr->cur - 1;
+  if (end == start)
   {
     assert (bfr->lineno > 1);
     bfr->lineno--;
     return perr_bfr (bfr, "empty symbol");
   }
-  pushc_bfr (bfr, 0);
+  if (!bfr->deferred) *end = 0;
+  *res = start;
   return 1;
 }
 
 static int32_t
 parse_opt_symbol_bfr (Btor2Parser *bfr, Btor2Line *l)
 {
-  int32_t ch;
-  if ((ch = getc_bfr (bfr)) == ' ')
+  int32_t ch = getc_bfr (bfr);
+  if (bfr->term)
+  {
+    /* the constant of this line ends at the character just read */
+    assert (bfr->term == bfr->cur - 1);
+    *bfr->term = 0;
+    bfr->term  = 0;
+  }
+  if (ch == ' ')
   {
     ch = getc_bfr (bfr);
     if (ch == ';')
@@ -379,8 +669,7 @@ parse_opt_symbol_bfr (Btor2Parser *bfr, Btor2Line *l)
     else
     {
       ungetc_bfr (bfr, ch);
-      if (!parse_symbol_bfr (bfr)) return 0;
-      l->symbol = btor2parser_strdup (bfr->buf);
+      if (!parse_symbol_bfr (bfr, &l->symbol)) return 0;
     }
   }
   else if (ch != '\n')
@@ -398,15 +687,15 @@ new_line_bfr (Btor2Parser *bfr,
 {
   Btor2Line *res;
   assert (0 < id);
-  assert (bfr->ntable <= id);
-  res = btor2parser_malloc (sizeof *res);
-  memset (res, 0, sizeof (*res));
+  assert (bfr->deferred || bfr->ntable <= id);
+  res = alloc_bfr (bfr, sizeof *res + sizeof (int64_t) * 3);
+  memset (res, 0, sizeof *res + sizeof (int64_t) * 3);
   res->id     = id;
   res->lineno = lineno;
   res->tag    = tag;
   res->name   = name;
-  res->args   = btor2parser_malloc (sizeof (int64_t) * 3);
-  memset (res->args, 0, sizeof (int64_t) * 3);
+  res->args   = (int64_t *) (res + 1);
+  if (bfr->deferred) return res;
   while (bfr->ntable < id) pusht_bfr (bfr, 0);
   assert (bfr->ntable == id);
   return res;
@@ -764,36 +1053,50 @@ check_sorts_bfr (Btor2Parser *bfr, Btor2Line *l)
   return 1;
 }
 
-static int64_t
-parse_arg_bfr (Btor2Parser *bfr)
+static int32_t
+is_arg_tag (Btor2Tag tag)
+{
+  return tag != BTOR2_TAG_sort && tag != BTOR2_TAG_init
+         && tag != BTOR2_TAG_next && tag != BTOR2_TAG_bad
+         && tag != BTOR2_TAG_constraint && tag != BTOR2_TAG_fair
+         && tag != BTOR2_TAG_justice;
+}
+
+static int32_t
+check_arg_bfr (Btor2Parser *bfr, int64_t id)
 {
   Btor2Line *l;
-  int64_t res, absres;
-  if (!parse_signed_id_bfr (bfr, &res)) return 0;
-  absres = labs (res);
-  if (absres >= bfr->ntable)
+  int64_t absid = labs (id);
+  if (absid >= bfr->ntable)
     return perr_bfr (bfr, "argument id too large (undefined)");
-  l = bfr->table[absres];
+  l = id2line_bfr (bfr, absid);
   if (!l) return perr_bfr (bfr, "undefined argument id");
-  if (l->tag == BTOR2_TAG_sort || l->tag == BTOR2_TAG_init
-      || l->tag == BTOR2_TAG_next || l->tag == BTOR2_TAG_bad
-      || l->tag == BTOR2_TAG_constraint || l->tag == BTOR2_TAG_fair
-      || l->tag == BTOR2_TAG_justice)
+  if (!is_arg_tag (l->tag))
   {
     return perr_bfr (bfr, "'%s' cannot be used as argument", l->name);
   }
   if (!l->sort.id) return perr_bfr (bfr, "declaration used as argument");
-  return res;
+  return 1;
+}
+
+static int64_t
+parse_arg_bfr (Btor2Parser *bfr)
+{
+  int64_t res;
+  if (!parse_signed_id_bfr (bfr, &res)) return 0;
+  if (bfr->deferred) return res;
+  return check_arg_bfr (bfr, res) ? res : 0;
 }
 
 static int32_t
 parse_sort_bfr (Btor2Parser *bfr, Btor2Line *l)
 {
   const char *tag;
+  size_t len;
   Btor2Sort tmp, s;
-  tag = parse_tag (bfr);
+  tag = parse_tag (bfr, &len);
   if (!tag) return 0;
-  if (!strcmp (tag, "bitvec"))
+  if (eq_tag (tag, len, "bitvec"))
   {
     tmp.tag  = BTOR2_TAG_SORT_bitvec;
     tmp.name = "bitvec";
@@ -801,7 +1104,7 @@ parse_sort_bfr (Btor2Parser *bfr, Btor2Line *l)
     if (tmp.bitvec.width == 0)
       return perr_bfr (bfr, "bit width must be greater than 0");
   }
-  else if (!strcmp (tag, "array"))
+  else if (eq_tag (tag, len, "array"))
   {
     tmp.tag  = BTOR2_TAG_SORT_array;
     tmp.name = "array";
@@ -890,12 +1193,11 @@ parse_ternary_op_bfr (Btor2Parser *bfr, Btor2Line *l)
 }
 
 static int32_t
-check_consth (const char *consth, uint32_t width)
+check_consth (const char *consth, size_t len, uint32_t width)
 {
   char c;
-  size_t i, len, req_width;
+  size_t i, req_width;
 
-  len       = strlen (consth);
   req_width = len * 4;
   for (i = 0; i < len; i++)
   {
@@ -1122,19 +1424,18 @@ dec_to_bin_str (const char *str, uint32_t len)
   return btor2parser_strdup ("0");
 }
 
-int32_t
-check_constd (const char *str, uint32_t width)
+static int32_t
+check_constd (const char *str, size_t len, uint32_t width)
 {
   assert (str);
   assert (width);
 
   int32_t is_neg, is_min_val = 0, res;
   char *bits;
-  size_t size_bits, len;
+  size_t size_bits;
 
-  is_neg    = (str[0] == '-');
-  len       = is_neg ? strlen (str) - 1 : strlen (str);
-  bits      = dec_to_bin_str (is_neg ? str + 1 : str, len);
+  is_neg    = (len && str[0] == '-');
+  bits      = dec_to_bin_str (is_neg ? str + 1 : str, is_neg ? len - 1 : len);
   size_bits = strlen (bits);
   if (is_neg)
   {
@@ -1148,12 +1449,45 @@ check_constd (const char *str, uint32_t width)
   return res;
 }
 
+static int32_t
+check_constant_bfr (Btor2Parser *bfr, Btor2Line *l, size_t len)
+{
+  const char *c = l->constant;
+  if (l->tag == BTOR2_TAG_const && len != l->sort.bitvec.width)
+  {
+    return perr_bfr (bfr,
+                     "constant '%.*s' does not match bit-vector sort size %u",
+                     (int) len,
+                     c,
+                     l->sort.bitvec.width);
+  }
+  else if (l->tag == BTOR2_TAG_constd
+           && !check_constd (c, len, l->sort.bitvec.width))
+  {
+    return perr_bfr (bfr,
+                     "constant '%.*s' does not match bit-vector sort size %u",
+                     (int) len,
+                     c,
+                     l->sort.bitvec.width);
+  }
+  else if (l->tag == BTOR2_TAG_consth
+           && !check_consth (c, len, l->sort.bitvec.width))
+  {
+    return perr_bfr (bfr,
+                     "constant '%.*s' does not fit into bit-vector of size %u",
+                     (int) len,
+                     c,
+                     l->sort.bitvec.width);
+  }
+  return 1;
+}
+
 static int32_t
 parse_constant_bfr (Btor2Parser *bfr, Btor2Line *l)
 {
   if (!parse_sort_id_bfr (bfr, &l->sort)) return 0;
 
-  if (l->sort.tag != BTOR2_TAG_SORT_bitvec)
+  if (!bfr->deferred && l->sort.tag != BTOR2_TAG_SORT_bitvec)
     return perr_bfr (bfr, "expected bitvec sort for %s", l->name);
 
   if (l->tag == BTOR2_TAG_one || l->tag == BTOR2_TAG_ones
@@ -1165,23 +1499,28 @@ parse_constant_bfr (Btor2Parser *bfr, Btor2Line *l)
   int32_t ch = getc_bfr (bfr);
   if (ch != ' ') return perr_bfr (bfr, "expected space after sort id");
 
-  bfr->nbuf = 0;
+  char *start = bfr->cur;
+  size_t len;
   if (l->tag == BTOR2_TAG_const)
   {
-    while ('0' == (ch = getc_bfr (bfr)) || ch == '1') pushc_bfr (bfr, ch);
+    while ('0' == (ch = getc_bfr (bfr)) || ch == '1')
+      ;
   }
   else if (l->tag == BTOR2_TAG_constd)
   {
     /* allow negative numbers */
-    if ((ch = getc_bfr (bfr)) && (ch == '-' || isdigit (ch)))
-      pushc_bfr (bfr, ch);
-    while (isdigit ((ch = getc_bfr (bfr)))) pushc_bfr (bfr, ch);
+    ch = getc_bfr (bfr);
+    if (ch != '-' && !isdigit (ch)) start = bfr->cur;
+    while (isdigit ((ch = getc_bfr (bfr))))
+      ;
   }
   else if (l->tag == BTOR2_TAG_consth)
   {
-    while (isxdigit ((ch = getc_bfr (bfr)))) pushc_bfr (bfr, ch);
+    while (isxdigit ((ch = getc_bfr (bfr))))
+      ;
   }
-  if (!bfr->nbuf)
+  len = bfr->cur - start - (ch != EOF);
+  if (!len)
   {
     perr_bfr (bfr, "expected number");
     return 0;
@@ -1192,32 +1531,11 @@ parse_constant_bfr (Btor2Parser *bfr, Btor2Line *l)
     return 0;
   }
   ungetc_bfr (bfr, ch);
-  pushc_bfr (bfr, 0);
-
-  if (l->tag == BTOR2_TAG_const && strlen (bfr->buf) != l->sort.bitvec.width)
-  {
-    return perr_bfr (bfr,
-                     "constant '%s' does not match bit-vector sort size %u",
-                     bfr->buf,
-                     l->sort.bitvec.width);
-  }
-  else if (l->tag == BTOR2_TAG_constd
-           && !check_constd (bfr->buf, l->sort.bitvec.width))
-  {
-    return perr_bfr (bfr,
-                     "constant '%s' does not match bit-vector sort size %u",
-                     bfr->buf,
-                     l->sort.bitvec.width);
-  }
-  else if (l->tag == BTOR2_TAG_consth
-           && !check_consth (bfr->buf, l->sort.bitvec.width))
-  {
-    return perr_bfr (bfr,
-                     "constant '%s' does not fit into bit-vector of size %u",
-                     bfr->buf,
-                     l->sort.bitvec.width);
-  }
-  l->constant = btor2parser_strdup (bfr->buf);
+  l->constant = start;
+  if (bfr->deferred) return 1;
+  if (!check_constant_bfr (bfr, l, len)) return 0;
+  /* terminated by 'parse_opt_symbol_bfr' once the separator is consumed */
+  bfr->term = bfr->cur;
   return 1;
 }
 
@@ -1242,6 +1560,13 @@ check_state_init (Btor2Parser *bfr, int64_t state_id, int64_t init_id)
   Btor2LongStack stack;
   char *cache;
 
+  if (bfr->streaming && (id = bfr->nodes[labs (init_id)].input))
+    return perr_bfr (bfr,
+                     "inputs are not allowed in initialization expressions, "
+                     "use a state instead of input %" PRId64 ".",
+                     id);
+  if (bfr->streaming) return 1;
+
   line = id2line_bfr (bfr, init_id);
 
   // 'init_id' is the highest id we will see when traversing down
@@ -1286,6 +1611,7 @@ parse_init_bfr (Btor2Parser *bfr, Btor2Line *l)
   Btor2Line *state;
   if (!parse_sort_id_bfr (bfr, &l->sort)) return 0;
   if (!parse_args (bfr, l, 2)) return 0;
+  if (bfr->deferred) return 1;
   if (l->args[0] < 0) return perr_bfr (bfr, "invalid negated first argument");
   state = id2line_bfr (bfr, l->args[0]);
   if (state->tag != BTOR2_TAG_state)
@@ -1296,6 +1622,7 @@ parse_init_bfr (Btor2Parser *bfr, Btor2Line *l)
   if (state->init)
     return perr_bfr (bfr, "state %" PRId64 " initialized twice", state->id);
   state->init = l->args[1];
+  if (bfr->streaming) bfr->nodes[state->id].flags |= BTOR2_NODE_INIT;
   return 1;
 }
 
@@ -1305,6 +1632,7 @@ parse_next_bfr (Btor2Parser *bfr, Btor2Line *l)
   Btor2Line *state;
   if (!parse_sort_id_bfr (bfr, &l->sort)) return 0;
   if (!parse_args (bfr, l, 2)) return 0;
+  if (bfr->deferred) return 1;
   if (l->args[0] < 0) return perr_bfr (bfr, "invalid negated first argument");
   state = id2line_bfr (bfr, l->args[0]);
   if (state->tag != BTOR2_TAG_state)
@@ -1312,6 +1640,7 @@ parse_next_bfr (Btor2Parser *bfr, Btor2Line *l)
   if (state->next)
     return perr_bfr (bfr, "next for state %" PRId64 " set twice", state->id);
   state->next = l->args[1];
+  if (bfr->streaming) bfr->nodes[state->id].flags |= BTOR2_NODE_NEXT;
   return 1;
 }
 
@@ -1320,10 +1649,11 @@ parse_constraint_bfr (Btor2Parser *bfr, Btor2Line *l)
 {
   /* contraint, bad, justice, fairness do not have a sort id after the tag */
   if (!(l->args[0] = parse_arg_bfr (bfr))) return 0;
+  l->nargs = 1;
+  if (bfr->deferred) return 1;
   Btor2Line *arg = id2line_bfr (bfr, l->args[0]);
   if (arg->tag == BTOR2_TAG_sort)
     return perr_bfr (bfr, "unexpected sort id after tag");
-  l->nargs = 1;
   return 1;
 }
 
@@ -1332,7 +1662,7 @@ parse_justice_bfr (Btor2Parser *bfr, Btor2Line *l)
 {
   uint32_t nargs;
   if (!parse_pos_number_bfr (bfr, &nargs)) return 0;
-  l->args  = btor2parser_realloc (l->args, sizeof (int64_t) * nargs);
+  if (nargs > 3) l->args = alloc_bfr (bfr, sizeof (int64_t) * nargs);
   l->nargs = nargs;
   if (!parse_args (bfr, l, nargs)) return 0;
   return 1;
@@ -1341,18 +1671,20 @@ parse_justice_bfr (Btor2Parser *bfr, Btor2Line *l)
 #define PARSE(NAME, GENERIC)                                                   \
   do                                                                           \
   {                                                                            \
-    if (!strcmp (tag, #NAME))                                                  \
+    if (eq_tag (tag, len, #NAME))                                              \
     {                                                                          \
       Btor2Line *LINE =                                                        \
           new_line_bfr (bfr, id, lineno, #NAME, BTOR2_TAG_##NAME);             \
       if (parse_##GENERIC##_bfr (bfr, LINE))                                   \
       {                                                                        \
         pusht_bfr (bfr, LINE);                                                 \
-        assert (bfr->table[id] == LINE);                                       \
-        if (!check_sorts_bfr (bfr, LINE) || !parse_opt_symbol_bfr (bfr, LINE)) \
+        assert (bfr->streaming || bfr->table[bfr->ntable - 1] == LINE);        \
+        if ((!bfr->deferred && !check_sorts_bfr (bfr, LINE))                   \
+            || !parse_opt_symbol_bfr (bfr, LINE))                              \
         {                                                                      \
           return 0;                                                            \
         }                                                                      \
+        bfr->new_line = LINE;                                                  \
         return 1;                                                              \
       }                                                                        \
       else                                                                     \
@@ -1370,10 +1702,12 @@ static int32_t
 readl_bfr (Btor2Parser *bfr)
 {
   const char *tag;
+  size_t len;
   int64_t lineno;
   int64_t id;
   int32_t ch;
 START:
+  if (bfr->streaming) fill_bfr (bfr);
   // skip white spaces at the beginning of the line
   while ((ch = getc_bfr (bfr)) == ' ')
     ;
@@ -1389,13 +1723,18 @@ START:
   ungetc_bfr (bfr, ch);
   if (!parse_id_bfr (bfr, &id)) return 0;
   if (getc_bfr (bfr) != ' ') return perr_bfr (bfr, "expected space after id");
-  if (id < bfr->ntable)
+  if (bfr->deferred)
+  {
+    if (bfr->ntable && id <= bfr->table[bfr->ntable - 1]->id)
+      return perr_bfr (bfr, "id out-of-order");
+  }
+  else if (id < bfr->ntable)
   {
     if (id2line_bfr (bfr, id) != 0) return perr_bfr (bfr, "id already defined");
     return perr_bfr (bfr, "id out-of-order");
   }
   lineno = bfr->lineno;
-  tag    = parse_tag (bfr);
+  tag    = parse_tag (bfr, &len);
   if (!tag) return 0;
   switch (tag[0])
   {
@@ -1487,21 +1826,682 @@ START:
       break;
     case 'z': PARSE (zero, constant); break;
   }
-  return perr_bfr (bfr, "invalid tag '%s'", tag);
+  return perr_bfr (bfr, "invalid tag '%.*s'", (int) len, tag);
+}
+
+/*------------------------------------------------------------------------*/
+/* Large inputs are split at line boundaries into one chunk per thread.  The
+ * chunks are parsed in 'deferred' mode, which checks the syntax of each line
+ * but leaves everything that needs the id table to 'link_line_bfr'.  The
+ * lines are then linked into the table in order, their sorts are checked in
+ * parallel, and finally their symbols and constants are terminated in place.
+ * On any error the sequential parser starts over and reports it.
+ */
+
+typedef struct Btor2ParserJob Btor2ParserJob;
+
+struct Btor2ParserJob
+{
+  Btor2Parser bfr;
+  int64_t lo, hi;
+};
+
+static void
+run_jobs_bfr (void *(*fun) (void *), Btor2ParserJob *jobs, uint32_t n)
+{
+  pthread_t *threads = btor2parser_malloc (n * sizeof *threads);
+  char *started      = btor2parser_malloc (n);
+  uint32_t i;
+  for (i = 1; i < n; i++)
+    started[i] = !pthread_create (threads + i, 0, fun, jobs + i);
+  fun (jobs);
+  for (i = 1; i < n; i++)
+  {
+    if (started[i])
+      pthread_join (threads[i], 0);
+    else
+      fun (jobs + i);
+  }
+  free (started);
+  free (threads);
+}
+
+static void *
+parse_chunk_bfr (void *job)
+{
+  Btor2Parser *bfr = &((Btor2ParserJob *) job)->bfr;
+  while (readl_bfr (bfr))
+    ;
+  return 0;
+}
+
+/* Enter a line parsed in 'deferred' mode into the id table.  The checks
+ * that need the table are those of the sequential parser, but the ones
+ * of a line happen in a fixed order here.
+ */
+static int32_t
+link_line_bfr (Btor2Parser *bfr, Btor2Line *l)
+{
+  Btor2Line *state;
+  uint32_t i;
+  bfr->lineno = l->lineno;
+  if (l->id < bfr->ntable)
+  {
+    if (id2line_bfr (bfr, l->id) != 0) return perr_bfr (bfr, "id already defined");
+    return perr_bfr (bfr, "id out-of-order");
+  }
+  if (l->tag == BTOR2_TAG_sort)
+  {
+    if (l->sort.tag == BTOR2_TAG_SORT_array
+        && (!check_sort_id_bfr (bfr, l->sort.array.index)
+            || !check_sort_id_bfr (bfr, l->sort.array.element)))
+      return 0;
+  }
+  else if (l->sort.id)
+  {
+    if (!check_sort_id_bfr (bfr, l->sort.id)) return 0;
+    l->sort = bfr->table[l->sort.id]->sort;
+  }
+  for (i = 0; i < l->nargs; i++)
+    if (!check_arg_bfr (bfr, l->args[i])) return 0;
+  if (l->tag == BTOR2_TAG_init || l->tag == BTOR2_TAG_next)
+  {
+    if (l->args[0] < 0) return perr_bfr (bfr, "invalid negated first argument");
+    state = bfr->table[l->args[0]];
+    if (state->tag != BTOR2_TAG_state)
+      return perr_bfr (bfr, "expected state as first argument");
+    if (l->tag == BTOR2_TAG_init)
+    {
+      if (l->args[0] < labs (l->args[1]))
+        return perr_bfr (bfr,
+                         "state id must be greater than id of second operand");
+      if (state->init)
+        return perr_bfr (
+            bfr, "state %" PRId64 " initialized twice", state->id);
+      state->init = l->args[1];
+    }
+    else
+    {
+      if (state->next)
+        return perr_bfr (
+            bfr, "next for state %" PRId64 " set twice", state->id);
+      state->next = l->args[1];
+    }
+  }
+  while (bfr->ntable < l->id) pusht_bfr (bfr, 0);
+  pusht_bfr (bfr, l);
+  return 1;
+}
+
+static int32_t
+check_line_bfr (Btor2Parser *bfr, Btor2Line *l)
+{
+  bfr->lineno = l->lineno;
+  if (is_constant_bfr (bfr, l->id) && l->sort.tag != BTOR2_TAG_SORT_bitvec)
+    return perr_bfr (bfr, "expected bitvec sort for %s", l->name);
+  if (l->constant
+      && !check_constant_bfr (bfr, l, strcspn (l->constant, " \n")))
+    return 0;
+  if (l->tag == BTOR2_TAG_init
+      && !check_state_init (bfr, l->args[0], l->args[1]))
+    return 0;
+  return check_sorts_bfr (bfr, l);
+}
+
+static void *
+check_lines_bfr (void *job)
+{
+  Btor2ParserJob *j = job;
+  Btor2Line *l;
+  int64_t i;
+  for (i = j->lo; i < j->hi; i++)
+    if ((l = j->bfr.table[i]) && !check_line_bfr (&j->bfr, l)) break;
+  return 0;
+}
+
+static void *
+terminate_lines_bfr (void *job)
+{
+  Btor2ParserJob *j = job;
+  Btor2Line *l;
+  int64_t i;
+  for (i = j->lo; i < j->hi; i++)
+  {
+    if (!(l = j->bfr.table[i])) continue;
+    if (l->constant) l->constant[strcspn (l->constant, " \n")] = 0;
+    if (l->symbol) l->symbol[strcspn (l->symbol, " \t\n")] = 0;
+  }
+  return 0;
+}
+
+/* Checks the linked table on 'n' threads.  Each works on a shallow copy of
+ * the parser, and the error of the first failing range is kept.
+ */
+static int32_t
+check_table_bfr (Btor2Parser *bfr, uint32_t n)
+{
+  Btor2ParserJob *jobs = btor2parser_malloc (n * sizeof *jobs);
+  int64_t k;
+  for (k = 0; k < n; k++)
+  {
+    jobs[k].bfr       = *bfr;
+    jobs[k].bfr.error = 0;
+    jobs[k].lo        = 1 + (bfr->ntable - 1) * k / n;
+    jobs[k].hi        = 1 + (bfr->ntable - 1) * (k + 1) / n;
+  }
+  run_jobs_bfr (check_lines_bfr, jobs, n);
+  for (k = 0; k < n; k++)
+  {
+    if (!bfr->error)
+      bfr->error = jobs[k].bfr.error;
+    else
+      free (jobs[k].bfr.error);
+  }
+  free (jobs);
+  return !bfr->error;
+}
+
+static int32_t
+read_chunks_bfr (Btor2Parser *bfr, uint32_t n)
+{
+  Btor2ParserJob *jobs = btor2parser_malloc (n * sizeof *jobs);
+  char *begin = bfr->cur, *p = begin, *q;
+  size_t size = bfr->end - begin;
+  int64_t lineno = 0, maxid = 0, i, k;
+  int32_t res = 1;
+  Btor2Parser *c;
+
+  memset (jobs, 0, n * sizeof *jobs);
+  for (k = 0; k < n; k++)
+  {
+    q = bfr->end;
+    if (k + 1 < n)
+    {
+      q = begin + size / n * (k + 1);
+      if (q < p) q = p;
+      q = memchr (q, '\n', bfr->end - q);
+      q = q ? q + 1 : bfr->end;
+    }
+    c           = &jobs[k].bfr;
+    c->deferred = 1;
+    c->lineno   = 1;
+    c->data = c->cur = p;
+    c->end = p = q;
+  }
+  run_jobs_bfr (parse_chunk_bfr, jobs, n);
+
+  for (k = 0; k < n; k++)
+  {
+    c = &jobs[k].bfr;
+    if (c->error) res = 0;
+    if (c->ntable) maxid = c->table[c->ntable - 1]->id;
+  }
+  if (res)
+  {
+    bfr->sztable = maxid + 1;
+    bfr->table   = btor2parser_malloc (bfr->sztable * sizeof *bfr->table);
+  }
+  for (k = 0; res && k < n; k++)
+  {
+    c = &jobs[k].bfr;
+    for (i = 0; res && i < c->ntable; i++)
+    {
+      c->table[i]->lineno += lineno;
+      res = link_line_bfr (bfr, c->table[i]);
+    }
+    lineno += c->lineno - 1;
+  }
+  for (k = 0; k < n; k++)
+  {
+    c = &jobs[k].bfr;
+    adopt_blocks_bfr (bfr, c);
+    free (c->table);
+    free (c->error);
+  }
+
+  if (res) res = check_table_bfr (bfr, n);
+  if (res)
+  {
+    for (k = 0; k < n; k++)
+    {
+      jobs[k].bfr = *bfr;
+      jobs[k].lo  = 1 + (bfr->ntable - 1) * k / n;
+      jobs[k].hi  = 1 + (bfr->ntable - 1) * (k + 1) / n;
+    }
+    run_jobs_bfr (terminate_lines_bfr, jobs, n);
+  }
+  free (jobs);
+
+  if (!res)
+  {
+    release_blocks_bfr (bfr);
+    free (bfr->table);
+    free (bfr->error);
+    bfr->table  = 0;
+    bfr->error  = 0;
+    bfr->ntable = bfr->sztable = 0;
+    bfr->cur    = begin;
+    bfr->lineno = 1;
+  }
+  return res;
 }
 
+static uint32_t
+threads_bfr (Btor2Parser *bfr)
+{
+  size_t res  = (bfr->end - bfr->cur) / BTOR2_PARSER_CHUNK;
+  long ncpus = bfr->nthreads;
+  if (!ncpus) ncpus = sysconf (_SC_NPROCESSORS_ONLN);
+  if (ncpus < 1) ncpus = 1;
+  if (res > (size_t) ncpus) res = ncpus;
+  return res;
+}
+
+/*------------------------------------------------------------------------*/
+/* Binary BTOR2 starts with the magic 'BTOR2BIN', a version and the number
+ * of lines, followed by one record per line.  All numbers are unsigned
+ * LEB128 varints and ids are stored relative to the id of their line:
+ *
+ *   (tag << 1 | has-symbol) (id - previous id)
+ *   sort:       sort tag, then width or (id - index) (id - element)
+ *   otherwise:  (id - sort id), except for bad, constraint, fair, output
+ *               and justice, which have no sort, and justice the number
+ *               of arguments instead
+ *   arguments:  ((id - |arg|) << 1 | arg < 0)
+ *   sext/uext:  width, slice: upper lower
+ *   constants:  NUL terminated string, followed by the symbol if any
+ *
+ * The tags are those of 'Btor2Tag'.  Strings are referenced in place, so
+ * loading a binary model only allocates its lines.
+ */
+
+#define BTOR2_PARSER_MAGIC "BTOR2BIN"
+#define BTOR2_PARSER_VERSION 1
+
+enum Btor2BinKind
+{
+  BTOR2_BIN_sort,
+  BTOR2_BIN_constant,
+  BTOR2_BIN_nullary,
+  BTOR2_BIN_unary,
+  BTOR2_BIN_ext,
+  BTOR2_BIN_slice,
+  BTOR2_BIN_binary,
+  BTOR2_BIN_ternary,
+  BTOR2_BIN_property,
+  BTOR2_BIN_justice,
+};
+typedef enum Btor2BinKind Btor2BinKind;
+
+static Btor2BinKind
+bin_kind (Btor2Tag tag)
+{
+  switch (tag)
+  {
+    case BTOR2_TAG_sort: return BTOR2_BIN_sort;
+    case BTOR2_TAG_const:
+    case BTOR2_TAG_constd:
+    case BTOR2_TAG_consth: return BTOR2_BIN_constant;
+    case BTOR2_TAG_input:
+    case BTOR2_TAG_one:
+    case BTOR2_TAG_ones:
+    case BTOR2_TAG_state:
+    case BTOR2_TAG_zero: return BTOR2_BIN_nullary;
+    case BTOR2_TAG_dec:
+    case BTOR2_TAG_inc:
+    case BTOR2_TAG_neg:
+    case BTOR2_TAG_not:
+    case BTOR2_TAG_redand:
+    case BTOR2_TAG_redor:
+    case BTOR2_TAG_redxor: return BTOR2_BIN_unary;
+    case BTOR2_TAG_sext:
+    case BTOR2_TAG_uext: return BTOR2_BIN_ext;
+    case BTOR2_TAG_slice: return BTOR2_BIN_slice;
+    case BTOR2_TAG_ite:
+    case BTOR2_TAG_write: return BTOR2_BIN_ternary;
+    case BTOR2_TAG_bad:
+    case BTOR2_TAG_constraint:
+    case BTOR2_TAG_fair:
+    case BTOR2_TAG_output: return BTOR2_BIN_property;
+    case BTOR2_TAG_justice: return BTOR2_BIN_justice;
+    default: return BTOR2_BIN_binary;
+  }
+}
+
+static int32_t
+is_binary_bfr (Btor2Parser *bfr)
+{
+  size_t len = strlen (BTOR2_PARSER_MAGIC);
+  return (size_t) (bfr->end - bfr->cur) >= len
+         && !memcmp (bfr->cur, BTOR2_PARSER_MAGIC, len);
+}
+
+static int32_t
+getv_bfr (Btor2Parser *bfr, uint64_t *res)
+{
+  uint64_t v = 0;
+  uint32_t shift = 0;
+  int32_t ch;
+  *res = 0;
+  do
+  {
+    if (bfr->cur == bfr->end)
+      return perr_bfr (bfr, "unexpected end-of-file in binary line");
+    ch = (unsigned char) *bfr->cur++;
+    if (shift > 63 || (shift == 63 && (ch & 0x7e)))
+      return perr_bfr (bfr, "number exceeds 64 bits");
+    v |= (uint64_t) (ch & 0x7f) << shift;
+    shift += 7;
+  } while (ch & 0x80);
+  *res = v;
+  return 1;
+}
+
+/* Reads a bit width, extension or slice bound. */
+static int32_t
+getw_bfr (Btor2Parser *bfr, uint32_t *res)
+{
+  uint64_t v;
+  *res = 0;
+  if (!getv_bfr (bfr, &v)) return 0;
+  if (v >= (uint64_t) BTOR2_FORMAT_MAXBITWIDTH)
+    return perr_bfr (bfr,
+                     "number exceeds maximum bit width of %" PRId64,
+                     BTOR2_FORMAT_MAXBITWIDTH);
+  *res = v;
+  return 1;
+}
+
+/* Reads an id stored relative to the id of the line. */
+static int32_t
+getr_bfr (Btor2Parser *bfr, int64_t id, int64_t *res)
+{
+  uint64_t v;
+  *res = 0;
+  if (!getv_bfr (bfr, &v)) return 0;
+  if (!v || v >= (uint64_t) id) return perr_bfr (bfr, "invalid id reference");
+  *res = id - v;
+  return 1;
+}
+
+static char *
+gets_bfr (Btor2Parser *bfr)
+{
+  char *res = bfr->cur, *end = memchr (res, 0, bfr->end - res);
+  if (!end)
+  {
+    perr_bfr (bfr, "unexpected end-of-file in string");
+    return 0;
+  }
+  bfr->cur = end + 1;
+  return res;
+}
+
+static int32_t
+is_constant_str (Btor2Tag tag, const char *c)
+{
+  size_t len;
+  if (tag == BTOR2_TAG_const) return *c && !c[strspn (c, "01")];
+  if (tag == BTOR2_TAG_consth)
+    return *c && !c[strspn (c, "0123456789abcdefABCDEF")];
+  len = *c == '-';
+  len += strspn (c + len, "0123456789");
+  return len && !c[len];
+}
+
+static int32_t
+readb_bfr (Btor2Parser *bfr, int64_t *prev)
+{
+  uint64_t head, stag, delta, nargs;
+  uint32_t i, upper = 0, lower = 0;
+  Btor2BinKind kind;
+  Btor2Line *l;
+  Btor2Tag tag;
+  int64_t id, arg;
+  if (!getv_bfr (bfr, &head)) return 0;
+  if ((head >> 1) > BTOR2_TAG_zero)
+    return perr_bfr (bfr, "invalid tag %" PRIu64, head >> 1);
+  tag  = head >> 1;
+  kind = bin_kind (tag);
+  if (!getv_bfr (bfr, &delta)) return 0;
+  if (!delta) return perr_bfr (bfr, "id out-of-order");
+  if (delta >= (uint64_t) (BTOR2_FORMAT_MAXID - *prev))
+    return perr_bfr (bfr, "id exceeds maximum");
+  id = *prev += delta;
+  l  = new_line_bfr (bfr, id, bfr->lineno, tag_names[tag], tag);
+
+  if (kind == BTOR2_BIN_sort)
+  {
+    if (!getv_bfr (bfr, &stag)) return 0;
+    l->sort.id = id;
+    if (stag == BTOR2_TAG_SORT_bitvec)
+    {
+      l->sort.tag  = BTOR2_TAG_SORT_bitvec;
+      l->sort.name = "bitvec";
+      if (!getw_bfr (bfr, &l->sort.bitvec.width)) return 0;
+      if (!l->sort.bitvec.width)
+        return perr_bfr (bfr, "bit width must be greater than 0");
+    }
+    else if (stag == BTOR2_TAG_SORT_array)
+    {
+      l->sort.tag  = BTOR2_TAG_SORT_array;
+      l->sort.name = "array";
+      if (!getr_bfr (bfr, id, &l->sort.array.index)
+          || !getr_bfr (bfr, id, &l->sort.array.element))
+        return 0;
+    }
+    else
+      return perr_bfr (bfr, "invalid sort tag");
+  }
+  else if (kind != BTOR2_BIN_property && kind != BTOR2_BIN_justice)
+  {
+    if (!getr_bfr (bfr, id, &l->sort.id)) return 0;
+  }
+
+  switch (kind)
+  {
+    case BTOR2_BIN_sort:
+    case BTOR2_BIN_constant:
+    case BTOR2_BIN_nullary: nargs = 0; break;
+    case BTOR2_BIN_binary: nargs = 2; break;
+    case BTOR2_BIN_ternary: nargs = 3; break;
+    case BTOR2_BIN_justice:
+      if (!getv_bfr (bfr, &nargs)) return 0;
+      if (nargs > (uint64_t) (bfr->end - bfr->cur))
+        return perr_bfr (bfr, "unexpected end-of-file in binary line");
+      if (nargs > 3) l->args = alloc_bfr (bfr, sizeof (int64_t) * nargs);
+      break;
+    default: nargs = 1; break;
+  }
+  for (i = 0; i < nargs; i++)
+  {
+    if (!getv_bfr (bfr, &delta)) return 0;
+    if (!(delta >> 1) || (delta >> 1) >= (uint64_t) id)
+      return perr_bfr (bfr, "invalid id reference");
+    arg        = id - (int64_t) (delta >> 1);
+    l->args[i] = delta & 1 ? -arg : arg;
+  }
+  l->nargs = nargs;
+
+  if (kind == BTOR2_BIN_ext || kind == BTOR2_BIN_slice)
+  {
+    if (!getw_bfr (bfr, &upper)) return 0;
+    l->args[1] = upper;
+    if (kind == BTOR2_BIN_slice)
+    {
+      if (!getw_bfr (bfr, &lower)) return 0;
+      l->args[2] = lower;
+      if (lower > upper)
+        return perr_bfr (bfr, "lower has to be less than or equal to upper");
+    }
+  }
+  else if (kind == BTOR2_BIN_constant)
+  {
+    if (!(l->constant = gets_bfr (bfr))) return 0;
+    if (!is_constant_str (tag, l->constant))
+      return perr_bfr (bfr, "invalid constant '%s'", l->constant);
+  }
+  if (head & 1)
+  {
+    if (!(l->symbol = gets_bfr (bfr))) return 0;
+    if (!*l->symbol || *l->symbol == ';'
+        || l->symbol[strcspn (l->symbol, " \t\n")])
+      return perr_bfr (bfr, "invalid symbol '%s'", l->symbol);
+  }
+  return link_line_bfr (bfr, l);
+}
+
+static int32_t
+read_binary_bfr (Btor2Parser *bfr, uint32_t n)
+{
+  uint64_t version, nlines, i;
+  int64_t prev = 0;
+  bfr->cur += strlen (BTOR2_PARSER_MAGIC);
+  if (!getv_bfr (bfr, &version)) return 0;
+  if (version != BTOR2_PARSER_VERSION)
+    return perr_bfr (bfr, "unsupported binary version %" PRIu64, version);
+  if (!getv_bfr (bfr, &nlines)) return 0;
+  if (nlines > (uint64_t) (bfr->end - bfr->cur) / 2)
+    return perr_bfr (bfr, "invalid number of lines %" PRIu64, nlines);
+  bfr->deferred = 1;
+  for (i = 0; i < nlines; i++)
+  {
+    bfr->lineno = i + 1;
+    if (!readb_bfr (bfr, &prev)) break;
+  }
+  bfr->deferred = 0;
+  if (bfr->error) return 0;
+  bfr->lineno = nlines + 1;
+  if (bfr->cur != bfr->end)
+    return perr_bfr (bfr, "unexpected data after last binary line");
+  return check_table_bfr (bfr, n);
+}
+
+static void
+putv_bfr (FILE *file, uint64_t v)
+{
+  while (v >= 0x80)
+  {
+    putc ((int) (v & 0x7f) | 0x80, file);
+    v >>= 7;
+  }
+  putc ((int) v, file);
+}
+
+static void
+puts_bfr (FILE *file, const char *str)
+{
+  fwrite (str, 1, strlen (str) + 1, file);
+}
+
+int32_t
+btor2parser_write_binary (Btor2Parser *bfr, FILE *file)
+{
+  Btor2BinKind kind;
+  Btor2Line *l;
+  int64_t i, prev = 0, nlines = 0;
+  uint32_t j;
+  if (bfr->error) return 0;
+  for (i = 1; i < bfr->ntable; i++) nlines += bfr->table[i] != 0;
+  fputs (BTOR2_PARSER_MAGIC, file);
+  putv_bfr (file, BTOR2_PARSER_VERSION);
+  putv_bfr (file, nlines);
+  for (i = 1; i < bfr->ntable; i++)
+  {
+    if (!(l = bfr->table[i])) continue;
+    kind = bin_kind (l->tag);
+    putv_bfr (file, (uint64_t) l->tag << 1 | (l->symbol != 0));
+    putv_bfr (file, l->id - prev);
+    prev = l->id;
+    if (kind == BTOR2_BIN_sort)
+    {
+      putv_bfr (file, l->sort.tag);
+      if (l->sort.tag == BTOR2_TAG_SORT_bitvec)
+        putv_bfr (file, l->sort.bitvec.width);
+      else
+      {
+        putv_bfr (file, l->id - l->sort.array.index);
+        putv_bfr (file, l->id - l->sort.array.element);
+      }
+    }
+    else if (kind == BTOR2_BIN_justice)
+      putv_bfr (file, l->nargs);
+    else if (kind != BTOR2_BIN_property)
+      putv_bfr (file, l->id - l->sort.id);
+    for (j = 0; j < l->nargs; j++)
+      putv_bfr (file, (uint64_t) (l->id - labs (l->args[j])) << 1
+                          | (l->args[j] < 0));
+    if (kind == BTOR2_BIN_ext || kind == BTOR2_BIN_slice)
+      putv_bfr (file, l->args[1]);
+    if (kind == BTOR2_BIN_slice) putv_bfr (file, l->args[2]);
+    if (kind == BTOR2_BIN_constant) puts_bfr (file, l->constant);
+    if (l->symbol) puts_bfr (file, l->symbol);
+  }
+  return !ferror (file);
+}
+
+/*------------------------------------------------------------------------*/
+
 int32_t
 btor2parser_read_lines (Btor2Parser *bfr, FILE *file)
 {
+  uint32_t n;
   reset_bfr (bfr);
   bfr->lineno = 1;
-  bfr->saved  = EOF;
-  bfr->file   = file;
+  if (!map_file_bfr (bfr, file)) read_file_bfr (bfr, file);
+  n = threads_bfr (bfr);
+  if (is_binary_bfr (bfr)) return read_binary_bfr (bfr, n ? n : 1);
+  if (n > 1 && read_chunks_bfr (bfr, n)) return 1;
   while (readl_bfr (bfr))
     ;
   return !bfr->error;
 }
 
+int32_t
+btor2parser_stream_lines (Btor2Parser *bfr,
+                          FILE *file,
+                          int32_t (*callback) (void *, Btor2Line *),
+                          void *state)
+{
+  Btor2LineIterator it;
+  Btor2Line *l;
+  reset_bfr (bfr);
+  bfr->lineno = 1;
+  bfr->file   = file;
+  bfr->szdata = 1 << 16;
+  bfr->data   = btor2parser_malloc (bfr->szdata);
+  bfr->cur = bfr->end = bfr->data;
+  fill_bfr (bfr);
+  if (is_binary_bfr (bfr))
+  {
+    /* binary models are decoded as a whole before handing out lines */
+    read_file_bfr (bfr, file);
+    bfr->file = 0;
+    if (!read_binary_bfr (bfr, 1)) return 0;
+    it = btor2parser_iter_init (bfr);
+    while ((l = btor2parser_iter_next (&it)))
+    {
+      if (callback (state, l)) continue;
+      bfr->lineno = l->lineno;
+      return perr_bfr (bfr, "stopped by callback");
+    }
+    return 1;
+  }
+  bfr->streaming = 1;
+  while (readl_bfr (bfr))
+  {
+    l = bfr->new_line;
+    if (!callback (state, l))
+    {
+      bfr->lineno = l->lineno;
+      return perr_bfr (bfr, "stopped by callback");
+    }
+    /* nothing allocated for the line is kept, except its node */
+    bfr->top = (char *) bfr->blocks->data;
+  }
+  return !bfr->error;
+}
+
 const char *
 btor2parser_error (Btor2Parser *bfr)
 {
@@ -1513,7 +2513,7 @@ find_non_zero_line_bfr (Btor2Parser *bfr, int64_t start)
 {
   int64_t res;
   for (res = start; res < bfr->ntable; res++)
-    if (bfr->table[res]) return res;
+    if (btor2parser_get_line_by_id (bfr, res)) return res;
   return 0;
 }
 
@@ -1536,7 +2536,7 @@ btor2parser_iter_next (Btor2LineIterator *it)
   if (!it->next) return 0;
   assert (0 < it->next);
   assert (it->next < it->reader->ntable);
-  res      = it->reader->table[it->next];
+  res      = btor2parser_get_line_by_id (it->reader, it->next);
   it->next = find_non_zero_line_bfr (it->reader, it->next + 1);
   return res;
 }
@@ -1544,7 +2544,17 @@ btor2parser_iter_next (Btor2LineIterator *it)
 Btor2Line *
 btor2parser_get_line_by_id (Btor2Parser *bfr, int64_t id)
 {
-  return id2line_bfr (bfr, id);
+  Btor2Line *res = id2line_bfr (bfr, id);
+  if (res && bfr->streaming && res->tag != BTOR2_TAG_sort) return 0;
+  return res;
+}
+
+const Btor2Sort *
+btor2parser_get_sort_by_id (Btor2Parser *bfr, int64_t id)
+{
+  Btor2Line *l = id2line_bfr (bfr, id);
+  if (!l || !l->sort.id) return 0;
+  return &id2line_bfr (bfr, l->sort.id)->sort;
 }
 
 int64_t
@@ -176,15 +176,57 @@ struct Btor2LineIterator
 Btor2Parser *btor2parser_new ();
 void btor2parser_delete (Btor2Parser *);
 
+/* Inputs of several megabytes are split at line boundaries and parsed on up
+ * to 'nthreads' threads.  The default zero uses one per online CPU.
+ */
+void btor2parser_set_threads (Btor2Parser *, uint32_t nthreads);
+
 /*------------------------------------------------------------------------*/
 /* The 'btor2parser_read_lines' function returns zero on failure.  In this
  * case you can call 'btor2parser_error' to obtain a description of
  * the actual read or parse error, which includes the line number where
  * the error occurred.
+ *
+ * Regular files are memory mapped, other streams are read to the end first.
+ * The 'symbol' and 'constant' strings of the lines point into that buffer.
+ * They are owned by the parser and stay valid until it is deleted or reads
+ * again, so they must not be freed by the caller.
+ *
+ * Inputs starting with the magic 'BTOR2BIN' are read as binary BTOR2, see
+ * 'btor2parser_write_binary'.
  */
 int32_t btor2parser_read_lines (Btor2Parser *, FILE *);
 const char *btor2parser_error (Btor2Parser *);
 
+/* Writes the lines read last in the compact binary format, in which ids
+ * are varints relative to their line and strings are NUL terminated.  It
+ * is read back by 'btor2parser_read_lines' without tokenizing, but the
+ * lines are checked as thoroughly as text.  Returns zero on write errors.
+ */
+int32_t btor2parser_write_binary (Btor2Parser *, FILE *);
+
+/*------------------------------------------------------------------------*/
+/* Single pass consumers can stream the lines instead:
+ *
+ *   btor2parser_stream_lines (bfr, file, do_something_with_line, state);
+ *
+ * Each line is parsed and checked as by 'btor2parser_read_lines', then
+ * handed to the callback and forgotten, together with its 'symbol' and
+ * 'constant' strings.  The input is read one line at a time, and per id
+ * only its tag, sort and a few flags are kept, so models larger than the
+ * memory can be streamed.  Returning zero from the callback stops parsing.
+ *
+ * Afterwards (and during the callbacks for earlier ids) only sort lines
+ * are available through 'btor2parser_get_line_by_id' and the iterator,
+ * while 'btor2parser_get_sort_by_id' works for every id.  Binary models
+ * are read as a whole and then handed to the callback in order.
+ */
+int32_t btor2parser_stream_lines (Btor2Parser *,
+                                  FILE *,
+                                  int32_t (*callback) (void *state,
+                                                       Btor2Line *line),
+                                  void *state);
+
 /*------------------------------------------------------------------------*/
 /* Iterate over all read format lines:
  *
@@ -204,6 +246,10 @@ Btor2Line *btor2parser_iter_next (Btor2LineIterator *);
 int64_t btor2parser_max_id (Btor2Parser *);
 Btor2Line *btor2parser_get_line_by_id (Btor2Parser *, int64_t id);
 
+/* The sort of the line 'id' or zero if it has none, e.g., for widths.
+ */
+const Btor2Sort *btor2parser_get_sort_by_id (Btor2Parser *, int64_t id);
+
 /*------------------------------------------------------------------------*/
 
 #if __cplusplus
@@ -6,9 +6,11 @@
 #define BTOR2TOOLS_SRC_BTORFUNC_H_
 
 #include <string>
+#include <cctype>
 #include <cstdio>
 #include <cstdlib>
 #include <cinttypes>
+#include <vector>
 
 #include <cassert>
 
@@ -129,6 +131,27 @@ void transition(Btor2Parser *model, std::vector<bool> &vec) {
   }
 };
 
+/* a candidate as 'simubtor --slices' writes it, either node 'id' or the
+ * bits 'upper' down to 'lower' of it, written 'id[upper:lower]' */
+struct NodeRef {
+  int64_t id = 0;
+  int64_t upper = -1, lower = -1;
+  bool is_slice() const { return lower >= 0; }
+};
+
+bool parse_node_ref(const char *str, NodeRef &ref) {
+  char *end;
+  ref = NodeRef();
+  if (!isdigit((unsigned char) *str)) return 0;
+  ref.id = strtoll(str, &end, 10);
+  if (!*end) return 1;
+  if (*end != '[' || !isdigit((unsigned char) end[1])) return 0;
+  ref.upper = strtoll(end + 1, &end, 10);
+  if (*end != ':' || !isdigit((unsigned char) end[1])) return 0;
+  ref.lower = strtoll(end + 1, &end, 10);
+  return end[0] == ']' && !end[1] && ref.lower <= ref.upper;
+}
+
 void open(const char *ername, const char *&path, FILE *&file, const char *default_path, FILE *default_file, bool op) {
   if (path) {
     if (!(file = fopen(path, op ? "r" : "w"))) {
@@ -161,6 +184,7 @@ void print_line(const char *ername, FILE *output_file, Btor2Line *line) {
     }
   } else if (line->sort.id)
     fprintf(output_file, " %" PRId64, line->sort.id);
+  if (line->tag == BTOR2_TAG_justice) fprintf(output_file, " %u", line->nargs);
   for (uint32_t j = 0; j < line->nargs; j++) fprintf(output_file, " %" PRId64, line->args[j]);
   if (line->tag == BTOR2_TAG_slice) fprintf(output_file, " %" PRId64 " %" PRId64, line->args[1], line->args[2]);
   if (line->tag == BTOR2_TAG_sext || line->tag == BTOR2_TAG_uext)
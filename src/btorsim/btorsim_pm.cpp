@@ -785,7 +785,7 @@ print_state_or_input (int64_t id, int64_t pos, int64_t step, bool is_input)
       fputc ('\n', stdout);
       break;
     case BtorSimState::Type::ARRAY:
-      for (auto e : current_state[id].array_state->data)
+      for (auto e : current_state[id].array_state->data ())
       {
         printf ("%" PRId64 " [%s]", pos, e.first.c_str ());
         btorsim_bv_print_without_new_line (e.second);
@@ -12,19 +12,165 @@
 #include "btorsimam.h"
 
 #include <cassert>
+#include <cstring>
+#include <functional>
 
 #include "btorsimhelpers.h"
 
-BtorSimArrayModel::~BtorSimArrayModel ()
+const BtorSimBitVector*
+BtorSimArrayModel::Node::element (uint64_t slot) const
+{
+  return reinterpret_cast<const BtorSimBitVector*> (&slots[slot * stride]);
+}
+
+void
+BtorSimArrayModel::Node::set (const Key& key, const BtorSimBitVector* el)
 {
-  for (auto i : data)
+  uint64_t i = 0;
+  while (i < keys.size () && !(keys[i] == key)) i++;
+  if (i == keys.size ())
   {
-    btorsim_bv_free (i.second);
-    data[i.first] = nullptr;
+    keys.push_back (key);
+    slots.resize (keys.size () * stride);
   }
+  memcpy (&slots[i * stride],
+          el,
+          sizeof (BtorSimBitVector) + sizeof (BTORSIM_BV_TYPE) * el->len);
+}
+
+BtorSimArrayModel::~BtorSimArrayModel ()
+{
   if (const_init) btorsim_bv_free (const_init);
 }
 
+BtorSimArrayModel::Key
+BtorSimArrayModel::get_key (const BtorSimBitVector* index) const
+{
+  assert (index->width == index_width);
+  Key res;
+  if (narrow ())
+    res.word = btorsim_bv_to_uint64 (index);
+  else
+    res.bits = btorsim_bv_to_string (index);
+  return res;
+}
+
+std::string
+BtorSimArrayModel::key_to_string (const Key& key) const
+{
+  if (!narrow ()) return key.bits;
+  std::string res (index_width, '0');
+  for (uint64_t i = 0; i < index_width; i++)
+    if ((key.word >> i) & 1) res[index_width - 1 - i] = '1';
+  return res;
+}
+
+uint64_t
+BtorSimArrayModel::key_to_uint64 (const Key& key) const
+{
+  if (narrow ()) return key.word;
+  BtorSimBitVector* idx = btorsim_bv_char_to_bv (key.bits.c_str ());
+  uint64_t res          = btorsim_bv_to_uint64 (idx);
+  btorsim_bv_free (idx);
+  return res;
+}
+
+uint64_t
+BtorSimArrayModel::hash (const Key& key) const
+{
+  if (narrow ()) return btorsim_bv_mix64 (key.word);
+  return btorsim_bv_mix64 (std::hash<std::string> () (key.bits));
+}
+
+const BtorSimBitVector*
+BtorSimArrayModel::lookup (const Key& index) const
+{
+  uint64_t h = hash (index);
+  const Node* n = root.get ();
+  for (uint32_t shift = 0; n && !n->leaf (); shift += 5)
+  {
+    uint32_t bit = 1u << ((h >> shift) & 31);
+    if (!(n->bitmap & bit)) return nullptr;
+    n = n->children[__builtin_popcount (n->bitmap & (bit - 1))].get ();
+  }
+  if (!n || n->hash != h) return nullptr;
+  for (uint64_t i = 0; i < n->keys.size (); i++)
+    if (n->keys[i] == index) return n->element (i);
+  return nullptr;
+}
+
+std::shared_ptr<const BtorSimArrayModel::Node>
+BtorSimArrayModel::insert (const std::shared_ptr<const Node>& node,
+                           uint64_t h,
+                           uint32_t shift,
+                           const Key& index,
+                           const BtorSimBitVector* element) const
+{
+  std::shared_ptr<Node> res;
+  if (!node || (node->leaf () && node->hash == h))
+  {
+    res = node ? std::make_shared<Node> (*node) : std::make_shared<Node> ();
+    if (!node)
+    {
+      res->hash   = h;
+      res->stride = (sizeof (BtorSimBitVector)
+                     + sizeof (BTORSIM_BV_TYPE) * element->len
+                     + sizeof (uint64_t) - 1)
+                    / sizeof (uint64_t);
+    }
+    res->set (index, element);
+    return res;
+  }
+  if (node->leaf ())
+  {
+    // a leaf with another hash is pushed down into a new branch, the hashes
+    // differ in some bit, so this ends before the shift reaches 64
+    res         = std::make_shared<Node> ();
+    res->bitmap = 1u << ((node->hash >> shift) & 31);
+    res->children.push_back (node);
+  }
+  else
+    res = std::make_shared<Node> (*node);
+  uint32_t bit = 1u << ((h >> shift) & 31);
+  uint32_t pos = __builtin_popcount (res->bitmap & (bit - 1));
+  if (res->bitmap & bit)
+    res->children[pos] =
+        insert (res->children[pos], h, shift + 5, index, element);
+  else
+  {
+    res->bitmap |= bit;
+    res->children.insert (res->children.begin () + pos,
+                          insert (nullptr, h, shift + 5, index, element));
+  }
+  return res;
+}
+
+void
+BtorSimArrayModel::elements (
+    std::vector<std::pair<Key, const BtorSimBitVector*>>& res) const
+{
+  std::vector<const Node*> todo;
+  if (root) todo.push_back (root.get ());
+  while (!todo.empty ())
+  {
+    const Node* n = todo.back ();
+    todo.pop_back ();
+    for (auto& c : n->children) todo.push_back (c.get ());
+    for (uint64_t i = 0; i < n->keys.size (); i++)
+      res.emplace_back (n->keys[i], n->element (i));
+  }
+}
+
+std::map<std::string, const BtorSimBitVector*>
+BtorSimArrayModel::data () const
+{
+  std::vector<std::pair<Key, const BtorSimBitVector*>> all;
+  elements (all);
+  std::map<std::string, const BtorSimBitVector*> res;
+  for (auto& i : all) res.emplace (key_to_string (i.first), i.second);
+  return res;
+}
+
 /* Get a 'random' value for an uninitialized element
  * This function must always return the same value for a given index and
  * random_seed. Otherwise reading the same element twice might not give the same
@@ -57,34 +203,33 @@ BtorSimArrayModel::set_const_init (const BtorSimBitVector* init) const
 BtorSimBitVector*
 BtorSimArrayModel::read (const BtorSimBitVector* index)
 {
-  assert (index->width == index_width);
-  std::string i = btorsim_bv_to_string (index);
-  if (!data[i])
+  Key i                      = get_key (index);
+  const BtorSimBitVector* el = lookup (i);
+  if (!el)
   {
+    BtorSimBitVector* init;
     if (const_init)
-      data[i] = btorsim_bv_copy (const_init);
+      init = btorsim_bv_copy (const_init);
     else if (random_seed)
-      data[i] = btorsim_bv_uint64_to_bv (
-          get_random_init (btorsim_bv_to_uint64 (index)), element_width);
+      init = btorsim_bv_uint64_to_bv (
+          get_random_init (key_to_uint64 (i)), element_width);
     else
-      data[i] = btorsim_bv_new (element_width);
+      init = btorsim_bv_new (element_width);
+    root = insert (root, hash (i), 0, i, init);
+    return init;
   }
-  return btorsim_bv_copy (data[i]);
+  return btorsim_bv_copy (el);
 }
 
 BtorSimArrayModel*
 BtorSimArrayModel::write (const BtorSimBitVector* index,
-                          const BtorSimBitVector* element)
+                          const BtorSimBitVector* element) const
 {
   assert (index->width == index_width);
   assert (element->width == element_width);
-  std::string i          = btorsim_bv_to_string (index);
   BtorSimArrayModel* res = copy ();
-  if (res->data[i])
-  {
-    btorsim_bv_free (res->data[i]);
-  }
-  res->data[i] = btorsim_bv_copy (element);
+  Key i                  = get_key (index);
+  res->root              = insert (root, hash (i), 0, i, element);
   return res;
 }
 
@@ -92,29 +237,29 @@ BtorSimBitVector*
 BtorSimArrayModel::check (const BtorSimBitVector* index) const
 {
   assert (index->width == index_width);
-  std::string i = btorsim_bv_to_string (index);
-  if (data.find (i) != data.end ())
-    return btorsim_bv_copy (data.at (i));
-  else
-    return nullptr;
+  const BtorSimBitVector* el = lookup (get_key (index));
+  return el ? btorsim_bv_copy (el) : nullptr;
 }
 
 BtorSimArrayModel*
 BtorSimArrayModel::copy () const
 {
   BtorSimArrayModel* res = new BtorSimArrayModel (index_width, element_width);
-  for (auto i : data) res->data[i.first] = btorsim_bv_copy (i.second);
+  res->root              = root;
   if (const_init) res->const_init = btorsim_bv_copy (const_init);
   return res;
 }
 
 bool
-data_is_subset (const BtorSimArrayModel& self, const BtorSimArrayModel& other)
+BtorSimArrayModel::data_is_subset (
+    const std::vector<std::pair<Key, const BtorSimBitVector*>>& data,
+    const BtorSimArrayModel& other) const
 {
-  for (auto i : self.data)
+  for (auto& i : data)
   // check all accessed elements in self have same value in other
   {
-    if (other.data.find (i.first) == other.data.end ())
+    const BtorSimBitVector* el = other.lookup (i.first);
+    if (!el)
     // data is not in other, but may be same as initial value if an extra read
     // was called on self
     {
@@ -124,13 +269,11 @@ data_is_subset (const BtorSimArrayModel& self, const BtorSimArrayModel& other)
       }
       else if (other.random_seed)  // init value is from randomize
       {
-        BtorSimBitVector* idx     = btorsim_bv_char_to_bv (i.first.c_str ());
         BtorSimBitVector* initval = btorsim_bv_uint64_to_bv (
-            other.get_random_init (btorsim_bv_to_uint64 (idx)),
+            other.get_random_init (key_to_uint64 (i.first)),
             other.element_width);
         int is_different_from_random_init =
             btorsim_bv_compare (i.second, initval);
-        btorsim_bv_free (idx);
         btorsim_bv_free (initval);
         if (is_different_from_random_init) return false;
       }
@@ -139,7 +282,7 @@ data_is_subset (const BtorSimArrayModel& self, const BtorSimArrayModel& other)
         if (!btorsim_bv_is_zero (i.second)) return false;
       }
     }
-    else if (btorsim_bv_compare (other.data.at (i.first), i.second) != 0)
+    else if (btorsim_bv_compare (el, i.second) != 0)
       return false;
   }
   return true;
@@ -148,7 +291,16 @@ data_is_subset (const BtorSimArrayModel& self, const BtorSimArrayModel& other)
 bool
 BtorSimArrayModel::operator== (const BtorSimArrayModel& other) const
 {
-  if (data.size () != ((size_t) 1) << index_width)
+  // arrays sharing their elements and inits are trivially equal
+  if (root == other.root && random_seed == other.random_seed
+      && (const_init ? other.const_init
+                           && !btorsim_bv_compare (const_init, other.const_init)
+                     : !other.const_init))
+    return true;
+  std::vector<std::pair<Key, const BtorSimBitVector*>> self_data, other_data;
+  elements (self_data);
+  other.elements (other_data);
+  if (index_width >= 64 || self_data.size () != ((size_t) 1) << index_width)
   // if all elements were accessed, init values are irrelevant,
   // otherwise they must match
   {
@@ -167,7 +319,7 @@ BtorSimArrayModel::operator== (const BtorSimArrayModel& other) const
     }
   }
   // init values match; check accessed data is same
-  return data_is_subset (*this, other) && data_is_subset (other, *this);
+  return data_is_subset (self_data, other) && other.data_is_subset (other_data, *this);
 }
 
 bool
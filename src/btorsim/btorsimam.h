@@ -15,8 +15,10 @@
 #ifndef BTOR2AM_H_INCLUDED
 #define BTOR2AM_H_INCLUDED
 
+#include <map>
+#include <memory>
 #include <string>
-#include <unordered_map>
+#include <vector>
 
 #include "btorsimbv.h"
 
@@ -35,11 +37,12 @@ struct BtorSimArrayModel
    * statement */
   BtorSimBitVector* const_init = nullptr;
 
-  /* Only the values of previously accessed memory elements are stored. Indexes
-   * are represented as strings of '0' and '1' because they can represent
-   * arbitrarily large vectors, have a well-defined length, and do not require
-   * custom comparison functions. If a not previously accessed element is read,
-   * an entry is created and populated with the first existing value of:
+  /* Only the values of previously accessed memory elements are stored.
+   * Indexes of at most 64 bits are represented by their value, wider ones as
+   * strings of '0' and '1' because they can represent arbitrarily large
+   * vectors, have a well-defined length, and do not require custom comparison
+   * functions. If a not previously accessed element is read, an entry is
+   * created and populated with the first existing value of:
    * - const_init (if the entire array has been initialized with a vector)
    * - a reproducible pseudo-random value provided by get_random_init based on
    * index value and random_seed (if non-zero, i.e. when randomize mode is
@@ -48,8 +51,47 @@ struct BtorSimArrayModel
    * It is important to populate on read and not only on write so that a full
    * account of all accessed memory elements and their values is shown in the
    * trace.
+   *
+   * The elements are kept in a persistent hash array mapped trie shared
+   * between all copies of an array: every level of a branch node selects a
+   * child by 5 bits of the hash of an index, a leaf holds the elements whose
+   * indexes have the same hash.  Nodes are immutable, a write (and every
+   * first read of an element) copies the O(log n) nodes on the path to its
+   * leaf and shares all others.  Copying an array therefore only copies a
+   * pointer.
    */
-  std::unordered_map<std::string, BtorSimBitVector*> data;
+  struct Key
+  {
+    /* value of an index of at most 64 bits */
+    uint64_t word = 0;
+    /* '0'/'1' string of a wider index */
+    std::string bits;
+
+    bool operator== (const Key& other) const
+    {
+      return word == other.word && bits == other.bits;
+    }
+  };
+
+  struct Node
+  {
+    /* branch: children present for each of the 32 values of the hash bits */
+    uint32_t bitmap = 0;
+    std::vector<std::shared_ptr<const Node>> children;
+    /* leaf: hash of the indexes, more than one key only for wider indexes,
+     * the elements are stored inline, every slot holds a complete bit-vector
+     * of 'stride' words, so no element is allocated on its own */
+    uint64_t hash   = 0;
+    uint32_t stride = 0;
+    std::vector<Key> keys;
+    std::vector<uint64_t> slots;
+
+    bool leaf () const { return !keys.empty (); }
+    const BtorSimBitVector* element (uint64_t slot) const;
+    /* copies 'element' into the slot of 'key' */
+    void set (const Key& key, const BtorSimBitVector* element);
+  };
+  std::shared_ptr<const Node> root;
 
   BtorSimArrayModel (uint64_t index_width, uint64_t element_width)
       : index_width (index_width), element_width (element_width){};
@@ -83,15 +125,19 @@ struct BtorSimArrayModel
   /* return a copy of the array with the element written at index (copies the
    * *element argument vector, does not take ownership) */
   BtorSimArrayModel* write (const BtorSimBitVector* index,
-                            const BtorSimBitVector* element);
+                            const BtorSimBitVector* element) const;
 
   /* obtain a copy of the element at index only if it was already previously
    * accessed, return null otherwise */
   BtorSimBitVector* check (const BtorSimBitVector* index) const;
 
-  /* return a copy of the array */
+  /* return a copy of the array, sharing all elements */
   BtorSimArrayModel* copy () const;
 
+  /* all previously accessed elements, ordered by index (the elements are
+   * owned by the array) */
+  std::map<std::string, const BtorSimBitVector*> data () const;
+
   /* equality checks test for:
    * - same global init (unless all elements were already accessed)
    * - same random seed (unless all elements were already accessed)
@@ -101,6 +147,31 @@ struct BtorSimArrayModel
    */
   bool operator!= (const BtorSimArrayModel& other) const;
   bool operator== (const BtorSimArrayModel& other) const;
+
+ private:
+  /* whether indexes are stored by value */
+  bool narrow () const { return index_width <= 64; }
+  Key get_key (const BtorSimBitVector* index) const;
+  std::string key_to_string (const Key& key) const;
+  uint64_t key_to_uint64 (const Key& key) const;
+  /* hash of an index, the identity on indexes of at most 64 bits is mixed
+   * bijectively so that their leaves never collide */
+  uint64_t hash (const Key& key) const;
+  /* element at index, or null if not previously accessed */
+  const BtorSimBitVector* lookup (const Key& index) const;
+  /* copy of 'node' with 'element' at 'index' */
+  std::shared_ptr<const Node> insert (const std::shared_ptr<const Node>& node,
+                                      uint64_t h,
+                                      uint32_t shift,
+                                      const Key& index,
+                                      const BtorSimBitVector* element) const;
+  /* all previously accessed elements, unordered */
+  void elements (
+      std::vector<std::pair<Key, const BtorSimBitVector*>>& res) const;
+  /* all elements in 'data' have the same value in 'other' */
+  bool data_is_subset (
+      const std::vector<std::pair<Key, const BtorSimBitVector*>>& data,
+      const BtorSimArrayModel& other) const;
 };
 
 /* Array variants of polymorphic operators that also exist on vectors */
@@ -19,9 +19,13 @@
 
 #include "util/btor2mem.h"
 
-#define BTOR2_MASK_REM_BITS(bv)                            \
-  ((((BTORSIM_BV_TYPE) 1 << (BTORSIM_BV_TYPE_BW - 1)) - 1) \
-   >> (BTORSIM_BV_TYPE_BW - 1 - (bv->width % BTORSIM_BV_TYPE_BW)))
+/* mask of the bits of the most significant limb, unless it is full */
+#define BTOR2_MASK_REM_BITS(bv) \
+  (~(BTORSIM_BV_TYPE) 0         \
+   >> (BTORSIM_BV_TYPE_BW - (bv)->width % BTORSIM_BV_TYPE_BW))
+
+/* 'unsigned __int128' holds the product of two limbs */
+typedef unsigned __int128 BtorSimDoubleLimb;
 
 /*------------------------------------------------------------------------*/
 
@@ -30,7 +34,7 @@ static bool
 rem_bits_zero_dbg (BtorSimBitVector *bv)
 {
   return (bv->width % BTORSIM_BV_TYPE_BW == 0
-          || (bv->bits[0] >> (bv->width % BTORSIM_BV_TYPE_BW) == 0));
+          || (bv->bits[bv->len - 1] >> (bv->width % BTORSIM_BV_TYPE_BW) == 0));
 }
 
 static bool
@@ -63,32 +67,278 @@ static void
 set_rem_bits_to_zero (BtorSimBitVector *bv)
 {
   if (bv->width != BTORSIM_BV_TYPE_BW * bv->len)
-    bv->bits[0] &= BTOR2_MASK_REM_BITS (bv);
+    bv->bits[bv->len - 1] &= BTOR2_MASK_REM_BITS (bv);
+}
+
+/*------------------------------------------------------------------------*/
+
+/* The kernels below walk the limbs of wide bit-vectors in blocks of
+ * 'BTORSIM_BV_SIMD_LIMBS' limbs, i.e., one AVX-512 or two AVX2 registers.
+ * They are compiled for AVX-512, AVX2 and the baseline and the dynamic
+ * loader picks the widest one the CPU supports.  Bit-vectors of fewer limbs
+ * do not amortize the dispatch and only run the scalar loops.  The
+ * predicates reduce the blocks once at the end rather than exiting early,
+ * their callers first check a limb to answer most negative cases. */
+
+/* the resolvers of the clones run before the thread sanitizer is set up */
+#if defined(__x86_64__) && defined(__linux__) && !defined(BTORSIM_NO_SIMD) \
+    && !defined(__SANITIZE_THREAD__)                                      \
+    && (!defined(__clang__) || __clang_major__ >= 14)
+#define BTORSIM_BV_CLONES \
+  __attribute__ ((target_clones ("avx512f", "avx2", "default")))
+#else
+#define BTORSIM_BV_CLONES
+#endif
+
+#define BTORSIM_BV_SIMD_LIMBS 8
+
+typedef BTORSIM_BV_TYPE BtorSimBVBlock
+    __attribute__ ((vector_size (sizeof (BTORSIM_BV_TYPE)
+                                 * BTORSIM_BV_SIMD_LIMBS)));
+
+typedef enum
+{
+  BTORSIM_BV_AND,
+  BTORSIM_BV_IMPLIES,
+  BTORSIM_BV_NAND,
+  BTORSIM_BV_NOR,
+  BTORSIM_BV_NOT,
+  BTORSIM_BV_OR,
+  BTORSIM_BV_XNOR,
+  BTORSIM_BV_XOR,
+} BtorSimBVBitwise;
+
+/* 'res' = 'a' 'op' 'b' on the full blocks, 'b' is ignored for not,
+ * returns the number of limbs done */
+BTORSIM_BV_CLONES static uint32_t
+bitwise_blocks (BtorSimBVBitwise op,
+                BTORSIM_BV_TYPE *res,
+                const BTORSIM_BV_TYPE *a,
+                const BTORSIM_BV_TYPE *b,
+                uint32_t len)
+{
+  uint32_t i, n;
+  BtorSimBVBlock x, y, z;
+
+  n = len - len % BTORSIM_BV_SIMD_LIMBS;
+  for (i = 0; i < n; i += BTORSIM_BV_SIMD_LIMBS)
+  {
+    memcpy (&x, a + i, sizeof x);
+    memcpy (&y, (op == BTORSIM_BV_NOT ? a : b) + i, sizeof y);
+    switch (op)
+    {
+      case BTORSIM_BV_AND: z = x & y; break;
+      case BTORSIM_BV_IMPLIES: z = ~x | y; break;
+      case BTORSIM_BV_NAND: z = ~(x & y); break;
+      case BTORSIM_BV_NOR: z = ~(x | y); break;
+      case BTORSIM_BV_NOT: z = ~x; break;
+      case BTORSIM_BV_OR: z = x | y; break;
+      case BTORSIM_BV_XNOR: z = ~(x ^ y); break;
+      default: assert (op == BTORSIM_BV_XOR); z = x ^ y;
+    }
+    memcpy (res + i, &z, sizeof z);
+  }
+  return n;
+}
+
+/* 'len' limbs of 'a' are the same as in 'b' */
+BTORSIM_BV_CLONES static bool
+same_limbs (const BTORSIM_BV_TYPE *a, const BTORSIM_BV_TYPE *b, uint32_t len)
+{
+  uint32_t i, k, n;
+  BtorSimBVBlock x, y, acc;
+  BTORSIM_BV_TYPE diff;
+
+  n = len - len % BTORSIM_BV_SIMD_LIMBS;
+  memset (&acc, 0, sizeof acc);
+  for (i = 0; i < n; i += BTORSIM_BV_SIMD_LIMBS)
+  {
+    memcpy (&x, a + i, sizeof x);
+    memcpy (&y, b + i, sizeof y);
+    acc |= x ^ y;
+  }
+  for (diff = 0, k = 0; k < BTORSIM_BV_SIMD_LIMBS; k++) diff |= acc[k];
+  for (; i < len; i++) diff |= a[i] ^ b[i];
+  return diff == 0;
+}
+
+/* 'len' limbs of 'a' are all equal to 'limb', which is zero or all ones */
+BTORSIM_BV_CLONES static bool
+uniform_limbs (const BTORSIM_BV_TYPE *a, uint32_t len, BTORSIM_BV_TYPE limb)
+{
+  uint32_t i, k, n;
+  BtorSimBVBlock x, acc;
+  BTORSIM_BV_TYPE diff;
+
+  n = len - len % BTORSIM_BV_SIMD_LIMBS;
+  memset (&acc, 0, sizeof acc);
+  for (i = 0; i < n; i += BTORSIM_BV_SIMD_LIMBS)
+  {
+    memcpy (&x, a + i, sizeof x);
+    acc |= x ^ limb;
+  }
+  for (diff = 0, k = 0; k < BTORSIM_BV_SIMD_LIMBS; k++) diff |= acc[k];
+  for (; i < len; i++) diff |= a[i] ^ limb;
+  return diff == 0;
+}
+
+/* the parity of the 'len' limbs of 'a' */
+BTORSIM_BV_CLONES static uint32_t
+parity_limbs (const BTORSIM_BV_TYPE *a, uint32_t len)
+{
+  uint32_t i, k, n;
+  BtorSimBVBlock x, acc;
+  BTORSIM_BV_TYPE sum;
+
+  n = len - len % BTORSIM_BV_SIMD_LIMBS;
+  memset (&acc, 0, sizeof acc);
+  for (i = 0; i < n; i += BTORSIM_BV_SIMD_LIMBS)
+  {
+    memcpy (&x, a + i, sizeof x);
+    acc ^= x;
+  }
+  for (sum = 0, k = 0; k < BTORSIM_BV_SIMD_LIMBS; k++) sum ^= acc[k];
+  for (; i < len; i++) sum ^= a[i];
+  return __builtin_parityll (sum);
 }
 
 /*------------------------------------------------------------------------*/
 
+/* Every thread keeps the bit-vectors it freed of up to
+ * 'BTORSIM_BV_POOL_LIMBS' limbs on one free list per number of limbs and
+ * reuses them for new ones, as well as the scratch space of the allocating
+ * division and remainder.  The pool is thread-local, such that threads do
+ * not share any mutable state of the library, and a bit-vector may be freed
+ * by another thread than the one that allocated it.  The link to the next
+ * free bit-vector is kept in its first limb. */
+
+#define BTORSIM_BV_POOL_LIMBS 64
+#ifdef __SANITIZE_ADDRESS__
+/* keep use after free detectable */
+#define BTORSIM_BV_POOL_SIZE 0
+#else
+#define BTORSIM_BV_POOL_SIZE 1024 /* bit-vectors kept per number of limbs */
+#endif
+
+typedef struct BtorSimBVPool
+{
+  BtorSimBitVector *free[BTORSIM_BV_POOL_LIMBS + 1];
+  uint32_t count[BTORSIM_BV_POOL_LIMBS + 1];
+  BTORSIM_BV_TYPE *scratch;
+  uint32_t scratch_limbs;
+} BtorSimBVPool;
+
+static __thread BtorSimBVPool pool;
+
+static BTORSIM_BV_TYPE *
+pool_scratch (uint32_t bw)
+{
+  uint32_t limbs = btorsim_bv_scratch_limbs (bw);
+
+  if (limbs > pool.scratch_limbs)
+  {
+    BTOR2_REALLOC (pool.scratch, limbs);
+    pool.scratch_limbs = limbs;
+  }
+  return pool.scratch;
+}
+
+void
+btorsim_bv_pool_release (void)
+{
+  BtorSimBitVector *bv, *next;
+  uint32_t len;
+
+  for (len = 1; len <= BTORSIM_BV_POOL_LIMBS; len++)
+  {
+    for (bv = pool.free[len]; bv; bv = next)
+    {
+      memcpy (&next, bv->bits, sizeof next);
+      BTOR2_DELETE (bv);
+    }
+    pool.free[len]  = 0;
+    pool.count[len] = 0;
+  }
+  BTOR2_DELETE (pool.scratch);
+  pool.scratch       = 0;
+  pool.scratch_limbs = 0;
+}
+
 BtorSimBitVector *
 btorsim_bv_new (uint32_t bw)
 {
   assert (bw > 0);
 
-  uint32_t i;
   BtorSimBitVector *res;
+  uint32_t len = (bw + BTORSIM_BV_TYPE_BW - 1) / BTORSIM_BV_TYPE_BW;
+
+  if (len <= BTORSIM_BV_POOL_LIMBS && (res = pool.free[len]))
+  {
+    memcpy (&pool.free[len], res->bits, sizeof res);
+    pool.count[len]--;
+  }
+  else
+    res = btorsim_malloc (btorsim_bv_bytes (bw));
+
+  res = btorsim_bv_init (res, bw);
+  assert (res->len == len);
+  return res;
+}
+
+size_t
+btorsim_bv_bytes (uint32_t bw)
+{
+  assert (bw > 0);
 
-  i = bw / BTORSIM_BV_TYPE_BW;
-  if (bw % BTORSIM_BV_TYPE_BW > 0) i += 1;
+  return sizeof (BtorSimBitVector)
+         + sizeof (BTORSIM_BV_TYPE)
+               * ((bw + BTORSIM_BV_TYPE_BW - 1) / BTORSIM_BV_TYPE_BW);
+}
+
+BtorSimBitVector *
+btorsim_bv_init (void *mem, uint32_t bw)
+{
+  assert (mem);
+  assert (bw > 0);
+
+  BtorSimBitVector *res = mem;
 
-  assert (i > 0);
-  res =
-      btorsim_malloc (sizeof (BtorSimBitVector) + sizeof (BTORSIM_BV_TYPE) * i);
-  memset (res->bits, 0, i * sizeof *(res->bits));
-  res->len = i;
-  assert (res->len);
   res->width = bw;
+  res->len   = (bw + BTORSIM_BV_TYPE_BW - 1) / BTORSIM_BV_TYPE_BW;
+  memset (res->bits, 0, sizeof (BTORSIM_BV_TYPE) * res->len);
   return res;
 }
 
+uint32_t
+btorsim_bv_scratch_limbs (uint32_t bw)
+{
+  assert (bw > 0);
+
+  /* the magnitudes of the signed operands, the quotient and remainder and
+   * the normalized operands of the long division */
+  return 5 * ((bw + BTORSIM_BV_TYPE_BW - 1) / BTORSIM_BV_TYPE_BW) + 1;
+}
+
+/* the random bits are drawn in 32-bit chunks from the second most
+ * significant one down to the least significant one and the most
+ * significant one last, as for the former 32-bit limbs, which keeps the
+ * values of a seed */
+static void
+random_bits (BtorSimBitVector *bv, BtorSimRNG *rng)
+{
+  uint32_t i, n, chunk;
+
+  n = (bv->width + 31) / 32;
+  for (i = 1; i <= n; i++)
+  {
+    chunk = i < n ? n - 1 - i : n - 1;
+    bv->bits[chunk / 2] |=
+        (BTORSIM_BV_TYPE) (i < n ? btorsim_rng_rand (rng)
+                                 : btorsim_rng_pick_rand (rng, 0, UINT_MAX - 1))
+        << (32 * (chunk % 2));
+  }
+}
+
 BtorSimBitVector *
 btorsim_bv_new_random_bit_range (BtorSimRNG *rng,
                                  uint32_t bw,
@@ -103,10 +353,7 @@ btorsim_bv_new_random_bit_range (BtorSimRNG *rng,
   BtorSimBitVector *res;
 
   res = btorsim_bv_new (bw);
-  for (i = 1; i < res->len; i++)
-    res->bits[i] = (BTORSIM_BV_TYPE) btorsim_rng_rand (rng);
-  res->bits[0] = (BTORSIM_BV_TYPE) btorsim_rng_pick_rand (
-      rng, 0, ((~0) >> (BTORSIM_BV_TYPE_BW - bw % BTORSIM_BV_TYPE_BW)) - 1);
+  random_bits (res, rng);
 
   for (i = 0; i < lo; i++) btorsim_bv_set_bit (res, i, 0);
   for (i = up + 1; i < res->width; i++) btorsim_bv_set_bit (res, i, 0);
@@ -126,6 +373,16 @@ void
 btorsim_bv_free (BtorSimBitVector *bv)
 {
   assert (bv);
+
+  uint32_t len = bv->len;
+
+  if (len <= BTORSIM_BV_POOL_LIMBS && pool.count[len] < BTORSIM_BV_POOL_SIZE)
+  {
+    memcpy (bv->bits, &pool.free[len], sizeof bv);
+    pool.free[len] = bv;
+    pool.count[len]++;
+    return;
+  }
   BTOR2_DELETE (bv);
 }
 
@@ -149,9 +406,24 @@ btorsim_bv_uint64_to_bv (uint64_t value, uint32_t bw)
 
   res = btorsim_bv_new (bw);
   assert (res->len > 0);
-  res->bits[res->len - 1] = (BTORSIM_BV_TYPE) value;
-  if (res->width > 32)
-    res->bits[res->len - 2] = (BTORSIM_BV_TYPE) (value >> BTORSIM_BV_TYPE_BW);
+  res->bits[0] = value;
+
+  set_rem_bits_to_zero (res);
+  assert (rem_bits_zero_dbg (res));
+  return res;
+}
+
+/* 'words' holds the value 64 bits per word, least significant word first */
+BtorSimBitVector *
+btorsim_bv_words_to_bv (const uint64_t *words, uint32_t bw)
+{
+  assert (words);
+  assert (bw > 0);
+
+  BtorSimBitVector *res;
+
+  res = btorsim_bv_new (bw);
+  memcpy (res->bits, words, sizeof (BTORSIM_BV_TYPE) * res->len);
 
   set_rem_bits_to_zero (res);
   assert (rem_bits_zero_dbg (res));
@@ -163,22 +435,16 @@ btorsim_bv_int64_to_bv (int64_t value, uint32_t bw)
 {
   assert (bw > 0);
 
-  BtorSimBitVector *res, *tmp;
+  BtorSimBitVector *res;
 
   res = btorsim_bv_new (bw);
   assert (res->len > 0);
 
   /* ensure that all bits > 64 are set to 1 in case of negative values */
   if (value < 0 && bw > 64)
-  {
-    tmp = btorsim_bv_not (res);
-    free (res);
-    res = tmp;
-  }
+    memset (res->bits, 0xff, sizeof (BTORSIM_BV_TYPE) * res->len);
 
-  res->bits[res->len - 1] = (BTORSIM_BV_TYPE) value;
-  if (res->width > 32)
-    res->bits[res->len - 2] = (BTORSIM_BV_TYPE) (value >> BTORSIM_BV_TYPE_BW);
+  res->bits[0] = (BTORSIM_BV_TYPE) value;
 
   set_rem_bits_to_zero (res);
   assert (rem_bits_zero_dbg (res));
@@ -343,7 +609,7 @@ add_unbounded_bin_str (const char *a, const char *b)
   return res;
 }
 
-static const char *digit2const_table[10] = {
+static const char *const digit2const_table[10] = {
     "",
     "1",
     "10",
@@ -706,19 +972,24 @@ btorsim_bv_compare (const BtorSimBitVector *a, const BtorSimBitVector *b)
 
   if (a->width != b->width) return -1;
 
-  /* find index on which a and b differ */
-  for (i = 0; i < a->len && a->bits[i] == b->bits[i]; i++)
+  if (a->len >= BTORSIM_BV_SIMD_LIMBS
+      && a->bits[a->len - 1] == b->bits[a->len - 1]
+      && same_limbs (a->bits, b->bits, a->len))
+    return 0;
+
+  /* find the most significant limb on which a and b differ */
+  for (i = a->len; i > 0 && a->bits[i - 1] == b->bits[i - 1]; i--)
     ;
 
-  if (i == a->len) return 0;
+  if (i == 0) return 0;
 
-  if (a->bits[i] > b->bits[i]) return 1;
+  if (a->bits[i - 1] > b->bits[i - 1]) return 1;
 
-  assert (a->bits[i] < b->bits[i]);
+  assert (a->bits[i - 1] < b->bits[i - 1]);
   return -1;
 }
 
-static uint32_t hash_primes[] = {333444569u, 76891121u, 456790003u};
+static const uint32_t hash_primes[] = {333444569u, 76891121u, 456790003u};
 
 #define NPRIMES ((uint32_t) (sizeof hash_primes / sizeof *hash_primes))
 
@@ -736,7 +1007,7 @@ btorsim_bv_hash (const BtorSimBitVector *bv)
     if (j == NPRIMES) j = 0;
     p1 = hash_primes[j++];
     if (j == NPRIMES) j = 0;
-    x   = bv->bits[i] ^ res;
+    x   = (uint32_t) (bv->bits[i] ^ (bv->bits[i] >> 32)) ^ res;
     x   = ((x >> 16) ^ x) * p0;
     x   = ((x >> 16) ^ x) * p1;
     res = ((x >> 16) ^ x);
@@ -744,6 +1015,20 @@ btorsim_bv_hash (const BtorSimBitVector *bv)
   return res;
 }
 
+uint64_t
+btorsim_bv_keyed_hash (const BtorSimBitVector *bv, uint64_t key)
+{
+  assert (bv);
+
+  uint32_t i;
+  uint64_t res = key;
+
+  /* limb by limb starting from the LSB, so that a bit-vector of width up to
+   * 64 hashes like btorsim_bv_mix64 (key ^ btorsim_bv_to_uint64 (bv)) */
+  for (i = 0; i < bv->len; i++) res = btorsim_bv_mix64 (res ^ bv->bits[i]);
+  return res;
+}
+
 /*------------------------------------------------------------------------*/
 
 void
@@ -909,16 +1194,18 @@ btorsim_bv_to_uint64 (const BtorSimBitVector *bv)
 {
   assert (bv);
   assert (bv->width <= sizeof (uint64_t) * 8);
-  assert (bv->len <= 2);
+  assert (bv->len == 1);
 
-  uint32_t i;
-  uint64_t res;
+  return bv->bits[0];
+}
 
-  res = 0;
-  for (i = 0; i < bv->len; i++)
-    res |= ((uint64_t) bv->bits[i]) << (BTORSIM_BV_TYPE_BW * (bv->len - 1 - i));
+void
+btorsim_bv_to_words (const BtorSimBitVector *bv, uint64_t *words)
+{
+  assert (bv);
+  assert (words);
 
-  return res;
+  memcpy (words, bv->bits, sizeof (BTORSIM_BV_TYPE) * bv->len);
 }
 
 /*------------------------------------------------------------------------*/
@@ -933,7 +1220,7 @@ btorsim_bv_get_bit (const BtorSimBitVector *bv, uint32_t pos)
   i = pos / BTORSIM_BV_TYPE_BW;
   j = pos % BTORSIM_BV_TYPE_BW;
 
-  return (bv->bits[bv->len - 1 - i] >> j) & 1;
+  return (bv->bits[i] >> j) & 1;
 }
 
 void
@@ -951,9 +1238,9 @@ btorsim_bv_set_bit (BtorSimBitVector *bv, uint32_t pos, uint32_t bit)
   assert (i < bv->len);
 
   if (bit)
-    bv->bits[bv->len - 1 - i] |= (1u << j);
+    bv->bits[i] |= ((BTORSIM_BV_TYPE) 1 << j);
   else
-    bv->bits[bv->len - 1 - i] &= ~(1u << j);
+    bv->bits[i] &= ~((BTORSIM_BV_TYPE) 1 << j);
 }
 
 void
@@ -992,6 +1279,9 @@ btorsim_bv_is_zero (const BtorSimBitVector *bv)
   assert (bv);
 
   uint32_t i;
+
+  if (bv->len >= BTORSIM_BV_SIMD_LIMBS)
+    return bv->bits[0] == 0 && uniform_limbs (bv->bits, bv->len, 0);
   for (i = 0; i < bv->len; i++)
     if (bv->bits[i] != 0) return false;
   return true;
@@ -1002,18 +1292,22 @@ btorsim_bv_is_ones (const BtorSimBitVector *bv)
 {
   assert (bv);
 
-  uint32_t i, n;
-  for (i = bv->len - 1; i >= 1; i--)
-    if (bv->bits[i] != UINT_MAX) return false;
-  if (bv->width == BTORSIM_BV_TYPE_BW)
-    return bv->bits[0] == UINT_MAX;
+  uint32_t i;
+
+  if (bv->len > BTORSIM_BV_SIMD_LIMBS)
+  {
+    if (bv->bits[0] != ~(BTORSIM_BV_TYPE) 0
+        || !uniform_limbs (bv->bits, bv->len - 1, ~(BTORSIM_BV_TYPE) 0))
+      return false;
+  }
   else
   {
-    n = BTORSIM_BV_TYPE_BW - bv->width % BTORSIM_BV_TYPE_BW;
-    assert (n > 0);
-    if (bv->bits[0] != UINT_MAX >> n) return false;
+    for (i = 0; i + 1 < bv->len; i++)
+      if (bv->bits[i] != ~(BTORSIM_BV_TYPE) 0) return false;
   }
-  return true;
+  if (bv->width % BTORSIM_BV_TYPE_BW == 0)
+    return bv->bits[bv->len - 1] == ~(BTORSIM_BV_TYPE) 0;
+  return bv->bits[bv->len - 1] == BTOR2_MASK_REM_BITS (bv);
 }
 
 bool
@@ -1023,8 +1317,8 @@ btorsim_bv_is_one (const BtorSimBitVector *bv)
 
   uint32_t i;
 
-  if (bv->bits[bv->len - 1] != 1) return false;
-  for (i = 0; i < bv->len - 1; i++)
+  if (bv->bits[0] != 1) return false;
+  for (i = 1; i < bv->len; i++)
     if (bv->bits[i] != 0) return false;
   return true;
 }
@@ -1057,10 +1351,10 @@ btorsim_bv_small_positive_int (const BtorSimBitVector *bv)
 
   uint32_t i;
 
-  for (i = 0; i < bv->len - 1; i++)
+  for (i = 1; i < bv->len; i++)
     if (bv->bits[i] != 0) return -1;
-  if (((int32_t) bv->bits[bv->len - 1]) < 0) return -1;
-  return bv->bits[bv->len - 1];
+  if (bv->bits[0] > INT32_MAX) return -1;
+  return (int32_t) bv->bits[0];
 }
 
 uint32_t
@@ -1068,15 +1362,12 @@ btorsim_bv_get_num_trailing_zeros (const BtorSimBitVector *bv)
 {
   assert (bv);
 
-  uint32_t i, res;
-
-  for (i = 0, res = 0; i < bv->width; i++)
-  {
-    if (btorsim_bv_get_bit (bv, i)) break;
-    res += 1;
-  }
+  uint32_t i;
 
-  return res;
+  for (i = 0; i < bv->len; i++)
+    if (bv->bits[i])
+      return i * BTORSIM_BV_TYPE_BW + __builtin_ctzll (bv->bits[i]);
+  return bv->width;
 }
 
 uint32_t
@@ -1084,15 +1375,14 @@ btorsim_bv_get_num_leading_zeros (const BtorSimBitVector *bv)
 {
   assert (bv);
 
-  uint32_t i, res;
-
-  for (i = bv->width - 1, res = 0; i < UINT_MAX; i--)
-  {
-    if (btorsim_bv_get_bit (bv, i)) break;
-    res += 1;
-  }
+  uint32_t i, spare;
 
-  return res;
+  spare = bv->len * BTORSIM_BV_TYPE_BW - bv->width;
+  for (i = bv->len; i > 0; i--)
+    if (bv->bits[i - 1])
+      return (bv->len - i) * BTORSIM_BV_TYPE_BW
+             + __builtin_clzll (bv->bits[i - 1]) - spare;
+  return bv->width;
 }
 
 uint32_t
@@ -1113,410 +1403,1226 @@ btorsim_bv_get_num_leading_ones (const BtorSimBitVector *bv)
 
 /*------------------------------------------------------------------------*/
 
-BtorSimBitVector *
-btorsim_bv_one (uint32_t bw)
+/* 'res' = 'a' + ('invert' ? ~'b' : 'b') + 'carry' over 'len' limbs */
+static void
+add_limbs (BTORSIM_BV_TYPE *res,
+           const BTORSIM_BV_TYPE *a,
+           const BTORSIM_BV_TYPE *b,
+           uint32_t len,
+           bool invert,
+           bool carry)
 {
-  assert (bw);
+  uint32_t i;
+  bool c;
+  BTORSIM_BV_TYPE sum;
 
-  BtorSimBitVector *res = btorsim_bv_new (bw);
-  btorsim_bv_set_bit (res, 0, 1);
-  return res;
+  for (i = 0; i < len; i++)
+  {
+    c     = __builtin_add_overflow (a[i], invert ? ~b[i] : b[i], &sum);
+    carry = __builtin_add_overflow (sum, (BTORSIM_BV_TYPE) carry, &res[i]) || c;
+  }
 }
 
-BtorSimBitVector *
-btorsim_bv_ones (uint32_t bw)
+/* 'res' = -'a' over 'len' limbs */
+static void
+neg_limbs (BTORSIM_BV_TYPE *res, const BTORSIM_BV_TYPE *a, uint32_t len)
 {
-  assert (bw);
-
-  BtorSimBitVector *res, *tmp;
-
-  tmp = btorsim_bv_new (bw);
-  res = btorsim_bv_not (tmp);
-  free (tmp);
+  uint32_t i;
+  bool carry = true;
 
-  return res;
+  for (i = 0; i < len; i++)
+    carry = __builtin_add_overflow (~a[i], (BTORSIM_BV_TYPE) carry, &res[i]);
 }
 
-BtorSimBitVector *
-btorsim_bv_neg (const BtorSimBitVector *bv)
+/* the value of 'b' as a shift, saturated at UINT64_MAX */
+static uint64_t
+shift_amount (const BtorSimBitVector *b)
 {
-  assert (bv);
-
-  BtorSimBitVector *not_bv, *one, *neg_b;
-
-  not_bv = btorsim_bv_not (bv);
-  one    = btorsim_bv_one (bv->width);
-  neg_b  = btorsim_bv_add (not_bv, one);
-  free (not_bv);
-  free (one);
+  uint32_t i;
 
-  return neg_b;
+  for (i = 1; i < b->len; i++)
+    if (b->bits[i]) return UINT64_MAX;
+  return b->bits[0];
 }
 
-BtorSimBitVector *
-btorsim_bv_not (const BtorSimBitVector *bv)
+/* set the bits from 'lower' up to the MSB */
+static void
+set_bits_from (BtorSimBitVector *bv, uint32_t lower)
 {
-  assert (bv);
-
   uint32_t i;
-  BtorSimBitVector *res;
 
-  res = btorsim_bv_new (bv->width);
-  for (i = 0; i < bv->len; i++) res->bits[i] = ~bv->bits[i];
-
-  set_rem_bits_to_zero (res);
-  assert (rem_bits_zero_dbg (res));
-  return res;
+  if (lower >= bv->width) return;
+  i = lower / BTORSIM_BV_TYPE_BW;
+  bv->bits[i] |= ~(BTORSIM_BV_TYPE) 0 << (lower % BTORSIM_BV_TYPE_BW);
+  for (i++; i < bv->len; i++) bv->bits[i] = ~(BTORSIM_BV_TYPE) 0;
+  set_rem_bits_to_zero (bv);
 }
 
-BtorSimBitVector *
-btorsim_bv_inc (const BtorSimBitVector *bv)
+static inline uint32_t
+find_diff_index (const BtorSimBitVector *a, const BtorSimBitVector *b)
 {
-  assert (bv);
+  uint32_t i;
 
-  BtorSimBitVector *res, *one;
+  if (a->len >= BTORSIM_BV_SIMD_LIMBS
+      && a->bits[a->len - 1] == b->bits[a->len - 1]
+      && same_limbs (a->bits, b->bits, a->len))
+    return a->len;
 
-  one = btorsim_bv_one (bv->width);
-  res = btorsim_bv_add (bv, one);
-  free (one);
-  return res;
+  /* find the most significant limb on which a and b differ, 'len' if none */
+  for (i = a->len; i > 0; i--)
+    if (a->bits[i - 1] != b->bits[i - 1]) return i - 1;
+
+  return a->len;
 }
 
-BtorSimBitVector *
-btorsim_bv_dec (const BtorSimBitVector *bv)
+static bool
+ult_bits (const BtorSimBitVector *a, const BtorSimBitVector *b)
 {
-  assert (bv);
+  uint32_t i = find_diff_index (a, b);
+  return i < a->len && a->bits[i] < b->bits[i];
+}
 
-  BtorSimBitVector *res, *one, *negone;
+static bool
+slt_bits (const BtorSimBitVector *a, const BtorSimBitVector *b)
+{
+  uint32_t sign_a, sign_b;
 
-  one    = btorsim_bv_one (bv->width);
-  negone = btorsim_bv_neg (one);
-  res    = btorsim_bv_add (bv, negone);
-  free (one);
-  free (negone);
-  return res;
+  sign_a = btorsim_bv_get_bit (a, a->width - 1);
+  sign_b = btorsim_bv_get_bit (b, b->width - 1);
+  if (sign_a != sign_b) return sign_a;
+  return ult_bits (a, b);
 }
 
-BtorSimBitVector *
-btorsim_bv_redand (const BtorSimBitVector *bv)
+
+void
+btorsim_bv_copy_into (BtorSimBitVector *res, const BtorSimBitVector *bv)
 {
+  assert (res);
   assert (bv);
+  assert (res->width == bv->width);
 
-  uint32_t i;
-  uint32_t bit;
-  uint32_t mask0;
-  BtorSimBitVector *res;
+  memmove (res->bits, bv->bits, sizeof (BTORSIM_BV_TYPE) * bv->len);
+}
 
-  res = btorsim_bv_new (1);
-  assert (rem_bits_zero_dbg (res));
+void
+btorsim_bv_words_into (BtorSimBitVector *res, const uint64_t *words)
+{
+  assert (res);
+  assert (words);
 
-  if (bv->width == BTORSIM_BV_TYPE_BW * bv->len)
-    mask0 = ~(BTORSIM_BV_TYPE) 0;
-  else
-    mask0 = BTOR2_MASK_REM_BITS (bv);
+  memmove (res->bits, words, sizeof (BTORSIM_BV_TYPE) * res->len);
+  set_rem_bits_to_zero (res);
+}
 
-  bit = (bv->bits[0] == mask0);
+void
+btorsim_bv_uint64_into (BtorSimBitVector *res, uint64_t value)
+{
+  assert (res);
 
-  for (i = 1; bit && i < bv->len; i++)
-    if (bv->bits[i] != ~(BTORSIM_BV_TYPE) 0) bit = 0;
+  memset (res->bits, 0, sizeof (BTORSIM_BV_TYPE) * res->len);
+  res->bits[0] = value;
+  set_rem_bits_to_zero (res);
+}
 
-  btorsim_bv_set_bit (res, 0, bit);
+void
+btorsim_bv_random_into (BtorSimBitVector *res, BtorSimRNG *rng)
+{
+  assert (res);
+  assert (rng);
 
-  assert (rem_bits_zero_dbg (res));
-  return res;
+  memset (res->bits, 0, sizeof (BTORSIM_BV_TYPE) * res->len);
+  random_bits (res, rng);
+  set_rem_bits_to_zero (res);
 }
 
-BtorSimBitVector *
-btorsim_bv_redor (const BtorSimBitVector *bv)
+void
+btorsim_bv_zero_into (BtorSimBitVector *res)
 {
-  assert (bv);
-
-  uint32_t i;
-  uint32_t bit;
-  BtorSimBitVector *res;
+  assert (res);
 
-  res = btorsim_bv_new (1);
-  assert (rem_bits_zero_dbg (res));
-  bit = 0;
-  for (i = 0; !bit && i < bv->len; i++)
-    if (bv->bits[i]) bit = 1;
+  memset (res->bits, 0, sizeof (BTORSIM_BV_TYPE) * res->len);
+}
 
-  btorsim_bv_set_bit (res, 0, bit);
+void
+btorsim_bv_one_into (BtorSimBitVector *res)
+{
+  assert (res);
 
-  assert (rem_bits_zero_dbg (res));
-  return res;
+  btorsim_bv_uint64_into (res, 1);
 }
 
-BtorSimBitVector *
-btorsim_bv_redxor (const BtorSimBitVector *bv)
+void
+btorsim_bv_ones_into (BtorSimBitVector *res)
 {
-  assert (bv);
+  assert (res);
+
+  memset (res->bits, 0xff, sizeof (BTORSIM_BV_TYPE) * res->len);
+  set_rem_bits_to_zero (res);
+}
+
+void
+btorsim_bv_not_into (BtorSimBitVector *res, const BtorSimBitVector *bv)
+{
+  assert (res);
+  assert (bv);
+  assert (res->width == bv->width);
+
+  uint32_t i = 0;
+
+  if (bv->len >= BTORSIM_BV_SIMD_LIMBS)
+    i = bitwise_blocks (BTORSIM_BV_NOT, res->bits, bv->bits, 0, bv->len);
+  for (; i < bv->len; i++) res->bits[i] = ~bv->bits[i];
+  set_rem_bits_to_zero (res);
+}
+
+void
+btorsim_bv_neg_into (BtorSimBitVector *res, const BtorSimBitVector *bv)
+{
+  assert (res);
+  assert (bv);
+  assert (res->width == bv->width);
+
+  neg_limbs (res->bits, bv->bits, bv->len);
+  set_rem_bits_to_zero (res);
+}
+
+void
+btorsim_bv_inc_into (BtorSimBitVector *res, const BtorSimBitVector *bv)
+{
+  assert (res);
+  assert (bv);
+  assert (res->width == bv->width);
 
   uint32_t i;
-  uint32_t bit;
-  BtorSimBitVector *res;
+  bool carry = true;
+
+  for (i = 0; i < bv->len; i++)
+    carry = __builtin_add_overflow (bv->bits[i], (BTORSIM_BV_TYPE) carry,
+                                    &res->bits[i]);
+  set_rem_bits_to_zero (res);
+}
+
+void
+btorsim_bv_dec_into (BtorSimBitVector *res, const BtorSimBitVector *bv)
+{
+  assert (res);
+  assert (bv);
+  assert (res->width == bv->width);
+
+  uint32_t i;
+  bool borrow = true;
+
+  for (i = 0; i < bv->len; i++)
+    borrow = __builtin_sub_overflow (bv->bits[i], (BTORSIM_BV_TYPE) borrow,
+                                     &res->bits[i]);
+  set_rem_bits_to_zero (res);
+}
+
+void
+btorsim_bv_redand_into (BtorSimBitVector *res, const BtorSimBitVector *bv)
+{
+  assert (res);
+  assert (bv);
+  assert (res->width == 1);
+
+  uint32_t i;
+  bool bit;
+  BTORSIM_BV_TYPE mask0;
+
+  if (bv->width == BTORSIM_BV_TYPE_BW * bv->len)
+    mask0 = ~(BTORSIM_BV_TYPE) 0;
+  else
+    mask0 = BTOR2_MASK_REM_BITS (bv);
+
+  bit = (bv->bits[bv->len - 1] == mask0);
+  if (bit && bv->len > BTORSIM_BV_SIMD_LIMBS)
+    bit = bv->bits[0] == ~(BTORSIM_BV_TYPE) 0
+          && uniform_limbs (bv->bits, bv->len - 1, ~(BTORSIM_BV_TYPE) 0);
+  else
+    for (i = 0; bit && i + 1 < bv->len; i++)
+      if (bv->bits[i] != ~(BTORSIM_BV_TYPE) 0) bit = false;
+
+  res->bits[0] = bit;
+}
+
+void
+btorsim_bv_redor_into (BtorSimBitVector *res, const BtorSimBitVector *bv)
+{
+  assert (res);
+  assert (bv);
+  assert (res->width == 1);
+
+  res->bits[0] = !btorsim_bv_is_zero (bv);
+}
+
+void
+btorsim_bv_redxor_into (BtorSimBitVector *res, const BtorSimBitVector *bv)
+{
+  assert (res);
+  assert (bv);
+  assert (res->width == 1);
+
+  uint32_t i, bit;
+
+  if (bv->len >= BTORSIM_BV_SIMD_LIMBS)
+  {
+    res->bits[0] = parity_limbs (bv->bits, bv->len);
+    return;
+  }
+  bit = 0;
+  for (i = 0; i < bv->len; i++) bit ^= __builtin_parityll (bv->bits[i]);
+  res->bits[0] = bit;
+}
+
+
+void
+btorsim_bv_add_into (BtorSimBitVector *res,
+                     const BtorSimBitVector *a,
+                     const BtorSimBitVector *b)
+{
+  assert (res);
+  assert (a);
+  assert (b);
+  assert (a->width == b->width);
+  assert (res->width == a->width);
+
+  add_limbs (res->bits, a->bits, b->bits, a->len, false, false);
+  set_rem_bits_to_zero (res);
+}
+
+void
+btorsim_bv_sub_into (BtorSimBitVector *res,
+                     const BtorSimBitVector *a,
+                     const BtorSimBitVector *b)
+{
+  assert (res);
+  assert (a);
+  assert (b);
+  assert (a->width == b->width);
+  assert (res->width == a->width);
+
+  add_limbs (res->bits, a->bits, b->bits, a->len, true, true);
+  set_rem_bits_to_zero (res);
+}
+
+
+void
+btorsim_bv_and_into (BtorSimBitVector *res,
+                     const BtorSimBitVector *a,
+                     const BtorSimBitVector *b)
+{
+  assert (res);
+  assert (a);
+  assert (b);
+  assert (a->width == b->width);
+  assert (res->width == a->width);
+
+  uint32_t i = 0;
+
+  if (a->len >= BTORSIM_BV_SIMD_LIMBS)
+    i = bitwise_blocks (BTORSIM_BV_AND, res->bits, a->bits, b->bits, a->len);
+  for (; i < a->len; i++) res->bits[i] = a->bits[i] & b->bits[i];
+  set_rem_bits_to_zero (res);
+}
+
+void
+btorsim_bv_implies_into (BtorSimBitVector *res,
+                         const BtorSimBitVector *a,
+                         const BtorSimBitVector *b)
+{
+  assert (res);
+  assert (a);
+  assert (b);
+  assert (a->width == b->width);
+  assert (res->width == a->width);
+
+  uint32_t i = 0;
+
+  if (a->len >= BTORSIM_BV_SIMD_LIMBS)
+    i = bitwise_blocks (
+        BTORSIM_BV_IMPLIES, res->bits, a->bits, b->bits, a->len);
+  for (; i < a->len; i++) res->bits[i] = ~a->bits[i] | b->bits[i];
+  set_rem_bits_to_zero (res);
+}
+
+void
+btorsim_bv_nand_into (BtorSimBitVector *res,
+                      const BtorSimBitVector *a,
+                      const BtorSimBitVector *b)
+{
+  assert (res);
+  assert (a);
+  assert (b);
+  assert (a->width == b->width);
+  assert (res->width == a->width);
+
+  uint32_t i = 0;
+
+  if (a->len >= BTORSIM_BV_SIMD_LIMBS)
+    i = bitwise_blocks (BTORSIM_BV_NAND, res->bits, a->bits, b->bits, a->len);
+  for (; i < a->len; i++) res->bits[i] = ~(a->bits[i] & b->bits[i]);
+  set_rem_bits_to_zero (res);
+}
+
+void
+btorsim_bv_nor_into (BtorSimBitVector *res,
+                     const BtorSimBitVector *a,
+                     const BtorSimBitVector *b)
+{
+  assert (res);
+  assert (a);
+  assert (b);
+  assert (a->width == b->width);
+  assert (res->width == a->width);
+
+  uint32_t i = 0;
+
+  if (a->len >= BTORSIM_BV_SIMD_LIMBS)
+    i = bitwise_blocks (BTORSIM_BV_NOR, res->bits, a->bits, b->bits, a->len);
+  for (; i < a->len; i++) res->bits[i] = ~(a->bits[i] | b->bits[i]);
+  set_rem_bits_to_zero (res);
+}
+
+void
+btorsim_bv_or_into (BtorSimBitVector *res,
+                    const BtorSimBitVector *a,
+                    const BtorSimBitVector *b)
+{
+  assert (res);
+  assert (a);
+  assert (b);
+  assert (a->width == b->width);
+  assert (res->width == a->width);
+
+  uint32_t i = 0;
+
+  if (a->len >= BTORSIM_BV_SIMD_LIMBS)
+    i = bitwise_blocks (BTORSIM_BV_OR, res->bits, a->bits, b->bits, a->len);
+  for (; i < a->len; i++) res->bits[i] = a->bits[i] | b->bits[i];
+  set_rem_bits_to_zero (res);
+}
+
+void
+btorsim_bv_xnor_into (BtorSimBitVector *res,
+                      const BtorSimBitVector *a,
+                      const BtorSimBitVector *b)
+{
+  assert (res);
+  assert (a);
+  assert (b);
+  assert (a->width == b->width);
+  assert (res->width == a->width);
+
+  uint32_t i = 0;
+
+  if (a->len >= BTORSIM_BV_SIMD_LIMBS)
+    i = bitwise_blocks (BTORSIM_BV_XNOR, res->bits, a->bits, b->bits, a->len);
+  for (; i < a->len; i++) res->bits[i] = ~(a->bits[i] ^ b->bits[i]);
+  set_rem_bits_to_zero (res);
+}
+
+void
+btorsim_bv_xor_into (BtorSimBitVector *res,
+                     const BtorSimBitVector *a,
+                     const BtorSimBitVector *b)
+{
+  assert (res);
+  assert (a);
+  assert (b);
+  assert (a->width == b->width);
+  assert (res->width == a->width);
+
+  uint32_t i = 0;
+
+  if (a->len >= BTORSIM_BV_SIMD_LIMBS)
+    i = bitwise_blocks (BTORSIM_BV_XOR, res->bits, a->bits, b->bits, a->len);
+  for (; i < a->len; i++) res->bits[i] = a->bits[i] ^ b->bits[i];
+  set_rem_bits_to_zero (res);
+}
+
+void
+btorsim_bv_eq_into (BtorSimBitVector *res,
+                    const BtorSimBitVector *a,
+                    const BtorSimBitVector *b)
+{
+  assert (res);
+  assert (res->width == 1);
+  assert (a);
+  assert (b);
+  assert (a->width == b->width);
+
+  res->bits[0] = find_diff_index (a, b) == a->len;
+}
+
+void
+btorsim_bv_neq_into (BtorSimBitVector *res,
+                     const BtorSimBitVector *a,
+                     const BtorSimBitVector *b)
+{
+  assert (res);
+  assert (res->width == 1);
+  assert (a);
+  assert (b);
+  assert (a->width == b->width);
+
+  res->bits[0] = find_diff_index (a, b) != a->len;
+}
+
+void
+btorsim_bv_ult_into (BtorSimBitVector *res,
+                     const BtorSimBitVector *a,
+                     const BtorSimBitVector *b)
+{
+  assert (res);
+  assert (res->width == 1);
+  assert (a);
+  assert (b);
+  assert (a->width == b->width);
+
+  res->bits[0] = ult_bits (a, b);
+}
+
+void
+btorsim_bv_ulte_into (BtorSimBitVector *res,
+                      const BtorSimBitVector *a,
+                      const BtorSimBitVector *b)
+{
+  assert (res);
+  assert (res->width == 1);
+  assert (a);
+  assert (b);
+  assert (a->width == b->width);
+
+  res->bits[0] = !ult_bits (b, a);
+}
+
+void
+btorsim_bv_slt_into (BtorSimBitVector *res,
+                     const BtorSimBitVector *a,
+                     const BtorSimBitVector *b)
+{
+  assert (res);
+  assert (res->width == 1);
+  assert (a);
+  assert (b);
+  assert (a->width == b->width);
+
+  res->bits[0] = slt_bits (a, b);
+}
+
+void
+btorsim_bv_slte_into (BtorSimBitVector *res,
+                      const BtorSimBitVector *a,
+                      const BtorSimBitVector *b)
+{
+  assert (res);
+  assert (res->width == 1);
+  assert (a);
+  assert (b);
+  assert (a->width == b->width);
+
+  res->bits[0] = !slt_bits (b, a);
+}
+
+void
+btorsim_bv_sll_into (BtorSimBitVector *res,
+                     const BtorSimBitVector *a,
+                     const BtorSimBitVector *b)
+{
+  assert (res);
+  assert (a);
+  assert (b);
+  assert (a->width == b->width);
+  assert (res->width == a->width);
+
+  uint32_t skip, i, j, k;
+  uint64_t shift;
+
+  shift = shift_amount (b);
+  if (shift >= a->width)
+  {
+    btorsim_bv_zero_into (res);
+    return;
+  }
+
+  k    = shift % BTORSIM_BV_TYPE_BW;
+  skip = shift / BTORSIM_BV_TYPE_BW;
+
+  /* from the top, so that 'res' may be 'a' */
+  for (i = res->len; i-- > skip;)
+  {
+    j            = i - skip;
+    res->bits[i] = (a->bits[j] << k)
+                   | (k && j > 0 ? a->bits[j - 1] >> (BTORSIM_BV_TYPE_BW - k)
+                                 : 0);
+  }
+  memset (res->bits, 0, sizeof (BTORSIM_BV_TYPE) * skip);
+  set_rem_bits_to_zero (res);
+}
+
+void
+btorsim_bv_srl_into (BtorSimBitVector *res,
+                     const BtorSimBitVector *a,
+                     const BtorSimBitVector *b)
+{
+  assert (res);
+  assert (a);
+  assert (b);
+  assert (a->width == b->width);
+  assert (res->width == a->width);
+
+  uint32_t skip, i, j, k;
+  uint64_t shift;
+
+  shift = shift_amount (b);
+  if (shift >= a->width)
+  {
+    btorsim_bv_zero_into (res);
+    return;
+  }
+
+  k    = shift % BTORSIM_BV_TYPE_BW;
+  skip = shift / BTORSIM_BV_TYPE_BW;
+
+  /* from the bottom, so that 'res' may be 'a' */
+  for (i = 0, j = skip; j < a->len; i++, j++)
+    res->bits[i] = (a->bits[j] >> k)
+                   | (k && j + 1 < a->len
+                          ? a->bits[j + 1] << (BTORSIM_BV_TYPE_BW - k)
+                          : 0);
+  memset (res->bits + i, 0, sizeof (BTORSIM_BV_TYPE) * (res->len - i));
+}
+
+void
+btorsim_bv_sra_into (BtorSimBitVector *res,
+                     const BtorSimBitVector *a,
+                     const BtorSimBitVector *b)
+{
+  assert (res);
+  assert (a);
+  assert (b);
+  assert (a->width == b->width);
+  assert (res->width == a->width);
+
+  uint32_t sign;
+  uint64_t shift;
+
+  sign  = btorsim_bv_get_bit (a, a->width - 1);
+  shift = shift_amount (b);
+  btorsim_bv_srl_into (res, a, b);
+  if (sign)
+    set_bits_from (res, shift >= a->width ? 0 : a->width - (uint32_t) shift);
+}
+
+/* Schoolbook multiplication over the limbs.  Since the product is truncated
+ * to the width of the operands, only the lower triangle of the partial
+ * products is accumulated, which makes a Karatsuba split pointless here. */
+void
+btorsim_bv_mul_into (BtorSimBitVector *res,
+                     const BtorSimBitVector *a,
+                     const BtorSimBitVector *b)
+{
+  assert (res);
+  assert (a);
+  assert (b);
+  assert (a->width == b->width);
+  assert (res->width == a->width);
+  assert (res != a && res != b);
+
+  uint32_t i, j, len;
+  BtorSimDoubleLimb t;
+  BTORSIM_BV_TYPE carry, x;
+
+  len = a->len;
+  if (len == 1)
+  {
+    res->bits[0] = a->bits[0] * b->bits[0];
+    set_rem_bits_to_zero (res);
+    return;
+  }
+  memset (res->bits, 0, sizeof (BTORSIM_BV_TYPE) * len);
+  for (i = 0; i < len; i++)
+  {
+    x = b->bits[i];
+    if (!x) continue;
+    carry = 0;
+    for (j = 0; i + j < len; j++)
+    {
+      t = (BtorSimDoubleLimb) a->bits[j] * x + res->bits[i + j] + carry;
+      res->bits[i + j] = (BTORSIM_BV_TYPE) t;
+      carry            = (BTORSIM_BV_TYPE) (t >> BTORSIM_BV_TYPE_BW);
+    }
+  }
+  set_rem_bits_to_zero (res);
+}
+
+/* Long division over 'len' limbs (Knuth, TAOCP Vol. 2, Algorithm D).
+ * 'quot' and 'rem' are overwritten and must not overlap 'a' or 'b',
+ * 'scratch' holds '2 * len + 1' limbs for the normalized operands.
+ * Division by zero gives all ones (above the width too) and the dividend. */
+static void
+udiv_urem_limbs (const BTORSIM_BV_TYPE *a,
+                 const BTORSIM_BV_TYPE *b,
+                 uint32_t len,
+                 BTORSIM_BV_TYPE *quot,
+                 BTORSIM_BV_TYPE *rem,
+                 BTORSIM_BV_TYPE *scratch)
+{
+  uint32_t i, m, n, s;
+  int64_t j;
+  bool borrow, c, o;
+  BtorSimDoubleLimb num, p, qhat, rhat;
+  BTORSIM_BV_TYPE *un, *vn, carry, d;
+
+  memset (quot, 0, sizeof (BTORSIM_BV_TYPE) * len);
+  memset (rem, 0, sizeof (BTORSIM_BV_TYPE) * len);
+
+  for (n = len; n > 0 && !b[n - 1]; n--)
+    ;
+  for (m = len; m > 0 && !a[m - 1]; m--)
+    ;
+
+  if (n == 0)
+  {
+    /* division by zero: all ones and the dividend */
+    memset (quot, 0xff, sizeof (BTORSIM_BV_TYPE) * len);
+    memcpy (rem, a, sizeof (BTORSIM_BV_TYPE) * len);
+    return;
+  }
+
+  if (m < n)
+  {
+    memcpy (rem, a, sizeof (BTORSIM_BV_TYPE) * len);
+    return;
+  }
+
+  if (n == 1)
+  {
+    rhat = 0;
+    for (j = m - 1; j >= 0; j--)
+    {
+      num     = (rhat << BTORSIM_BV_TYPE_BW) | a[j];
+      quot[j] = (BTORSIM_BV_TYPE) (num / b[0]);
+      rhat    = num % b[0];
+    }
+    rem[0] = (BTORSIM_BV_TYPE) rhat;
+    return;
+  }
+
+  /* normalize such that the top limb of the divisor has its msb set */
+  un = scratch;
+  vn = scratch + m + 1;
+  s  = __builtin_clzll (b[n - 1]);
+  for (i = n - 1; i > 0; i--)
+    vn[i] = (b[i] << s) | (s ? b[i - 1] >> (BTORSIM_BV_TYPE_BW - s) : 0);
+  vn[0] = b[0] << s;
+  un[m] = s ? a[m - 1] >> (BTORSIM_BV_TYPE_BW - s) : 0;
+  for (i = m - 1; i > 0; i--)
+    un[i] = (a[i] << s) | (s ? a[i - 1] >> (BTORSIM_BV_TYPE_BW - s) : 0);
+  un[0] = a[0] << s;
+
+  for (j = m - n; j >= 0; j--)
+  {
+    /* estimate the quotient limb, it is at most one too large after this */
+    num  = ((BtorSimDoubleLimb) un[j + n] << BTORSIM_BV_TYPE_BW) | un[j + n - 1];
+    qhat = num / vn[n - 1];
+    rhat = num % vn[n - 1];
+    while (qhat >> BTORSIM_BV_TYPE_BW
+           || qhat * vn[n - 2]
+                  > ((rhat << BTORSIM_BV_TYPE_BW) | un[j + n - 2]))
+    {
+      qhat -= 1;
+      rhat += vn[n - 1];
+      if (rhat >> BTORSIM_BV_TYPE_BW) break;
+    }
+
+    /* multiply and subtract */
+    carry  = 0;
+    borrow = false;
+    for (i = 0; i < n; i++)
+    {
+      p         = qhat * vn[i] + carry;
+      carry     = (BTORSIM_BV_TYPE) (p >> BTORSIM_BV_TYPE_BW);
+      c         = __builtin_sub_overflow (un[i + j], (BTORSIM_BV_TYPE) p, &d);
+      borrow    = __builtin_sub_overflow (d, (BTORSIM_BV_TYPE) borrow, &d) || c;
+      un[i + j] = d;
+    }
+    c         = __builtin_sub_overflow (un[j + n], carry, &d);
+    borrow    = __builtin_sub_overflow (d, (BTORSIM_BV_TYPE) borrow, &d) || c;
+    un[j + n] = d;
 
-  res = btorsim_bv_new (1);
-  assert (rem_bits_zero_dbg (res));
-  bit = btorsim_bv_get_bit (bv, 0);
-  for (i = 1; i < bv->width; i++)
-  {
-    bit = bit ^ btorsim_bv_get_bit (bv, i);
+    /* add back if the estimate was one too large */
+    if (borrow)
+    {
+      qhat -= 1;
+      c = false;
+      for (i = 0; i < n; i++)
+      {
+        o = __builtin_add_overflow (un[i + j], vn[i], &d);
+        c = __builtin_add_overflow (d, (BTORSIM_BV_TYPE) c, &un[i + j]) || o;
+      }
+      un[j + n] += c;
+    }
+    quot[j] = (BTORSIM_BV_TYPE) qhat;
   }
-  btorsim_bv_set_bit (res, 0, bit);
 
-  assert (rem_bits_zero_dbg (res));
-  return res;
+  /* denormalize the remainder */
+  for (i = 0; i < n; i++)
+    rem[i] = (un[i] >> s) | (s ? un[i + 1] << (BTORSIM_BV_TYPE_BW - s) : 0);
 }
 
-/*------------------------------------------------------------------------*/
+void
+btorsim_bv_udiv_into (BtorSimBitVector *res,
+                      const BtorSimBitVector *a,
+                      const BtorSimBitVector *b,
+                      BTORSIM_BV_TYPE *scratch)
+{
+  assert (res);
+  assert (a);
+  assert (b);
+  assert (scratch);
+  assert (a->width == b->width);
+  assert (res->width == a->width);
 
-BtorSimBitVector *
-btorsim_bv_add (const BtorSimBitVector *a, const BtorSimBitVector *b)
+  uint32_t len = a->len;
+
+  udiv_urem_limbs (
+      a->bits, b->bits, len, scratch, scratch + len, scratch + 2 * len);
+  memcpy (res->bits, scratch, sizeof (BTORSIM_BV_TYPE) * len);
+  set_rem_bits_to_zero (res);
+}
+
+void
+btorsim_bv_urem_into (BtorSimBitVector *res,
+                      const BtorSimBitVector *a,
+                      const BtorSimBitVector *b,
+                      BTORSIM_BV_TYPE *scratch)
 {
+  assert (res);
   assert (a);
   assert (b);
-  assert (a->len == b->len);
+  assert (scratch);
   assert (a->width == b->width);
+  assert (res->width == a->width);
 
-  int64_t i;
-  uint64_t x, y, sum;
-  BtorSimBitVector *res;
-  BTORSIM_BV_TYPE carry;
+  uint32_t len = a->len;
+
+  udiv_urem_limbs (
+      a->bits, b->bits, len, scratch, scratch + len, scratch + 2 * len);
+  memcpy (res->bits, scratch + len, sizeof (BTORSIM_BV_TYPE) * len);
+}
 
-  if (a->width <= 64)
+/* the magnitude of 'bv' in 'res' and whether 'bv' is negative */
+static bool
+magnitude (BTORSIM_BV_TYPE *res, const BtorSimBitVector *bv)
+{
+  bool sign = btorsim_bv_get_bit (bv, bv->width - 1);
+
+  if (sign)
   {
-    x   = btorsim_bv_to_uint64 (a);
-    y   = btorsim_bv_to_uint64 (b);
-    res = btorsim_bv_uint64_to_bv (x + y, a->width);
+    neg_limbs (res, bv->bits, bv->len);
+    if (bv->width % BTORSIM_BV_TYPE_BW)
+      res[bv->len - 1] &= BTOR2_MASK_REM_BITS (bv);
   }
   else
-  {
-    res   = btorsim_bv_new (a->width);
-    carry = 0;
-    for (i = a->len - 1; i >= 0; i--)
-    {
-      sum          = (uint64_t) a->bits[i] + b->bits[i] + carry;
-      res->bits[i] = (BTORSIM_BV_TYPE) sum;
-      carry        = (BTORSIM_BV_TYPE) (sum >> 32);
-    }
-  }
+    memcpy (res, bv->bits, sizeof (BTORSIM_BV_TYPE) * bv->len);
+  return sign;
+}
 
+void
+btorsim_bv_sdiv_into (BtorSimBitVector *res,
+                      const BtorSimBitVector *a,
+                      const BtorSimBitVector *b,
+                      BTORSIM_BV_TYPE *scratch)
+{
+  assert (res);
+  assert (a);
+  assert (b);
+  assert (scratch);
+  assert (a->width == b->width);
+  assert (res->width == a->width);
+
+  uint32_t len = a->len;
+  bool sign_a, sign_b;
+
+  sign_a = magnitude (scratch, a);
+  sign_b = magnitude (scratch + len, b);
+  udiv_urem_limbs (scratch,
+                   scratch + len,
+                   len,
+                   res->bits,
+                   scratch + 2 * len,
+                   scratch + 3 * len);
+  if (sign_a != sign_b) neg_limbs (res->bits, res->bits, len);
   set_rem_bits_to_zero (res);
-  assert (rem_bits_zero_dbg (res));
-  return res;
 }
 
-BtorSimBitVector *
-btorsim_bv_sub (const BtorSimBitVector *a, const BtorSimBitVector *b)
+void
+btorsim_bv_srem_into (BtorSimBitVector *res,
+                      const BtorSimBitVector *a,
+                      const BtorSimBitVector *b,
+                      BTORSIM_BV_TYPE *scratch)
 {
+  assert (res);
   assert (a);
   assert (b);
-  assert (a->len == b->len);
+  assert (scratch);
   assert (a->width == b->width);
+  assert (res->width == a->width);
+
+  uint32_t len = a->len;
+  bool sign_a;
+
+  sign_a = magnitude (scratch, a);
+  magnitude (scratch + len, b);
+  udiv_urem_limbs (scratch,
+                   scratch + len,
+                   len,
+                   scratch + 2 * len,
+                   res->bits,
+                   scratch + 3 * len);
+  if (sign_a) neg_limbs (res->bits, res->bits, len);
+  set_rem_bits_to_zero (res);
+}
 
-  BtorSimBitVector *negb, *res;
+void
+btorsim_bv_ite_into (BtorSimBitVector *res,
+                     const BtorSimBitVector *c,
+                     const BtorSimBitVector *t,
+                     const BtorSimBitVector *e)
+{
+  assert (res);
+  assert (c);
+  assert (c->width == 1);
+  assert (t);
+  assert (e);
+  assert (t->width == e->width);
+  assert (res->width == t->width);
 
-  negb = btorsim_bv_neg (b);
-  res  = btorsim_bv_add (a, negb);
-  free (negb);
-  return res;
+  btorsim_bv_copy_into (res, c->bits[0] ? t : e);
 }
 
-BtorSimBitVector *
-btorsim_bv_and (const BtorSimBitVector *a, const BtorSimBitVector *b)
+void
+btorsim_bv_concat_into (BtorSimBitVector *res,
+                        const BtorSimBitVector *a,
+                        const BtorSimBitVector *b)
 {
+  assert (res);
   assert (a);
   assert (b);
-  assert (a->len == b->len);
-  assert (a->width == b->width);
+  assert (res->width == a->width + b->width);
 
-  uint32_t i;
-  BtorSimBitVector *res;
+  uint32_t i, j, k;
 
-  res = btorsim_bv_new (a->width);
-  for (i = 0; i < a->len; i++) res->bits[i] = a->bits[i] & b->bits[i];
+  /* copy bits from bit vector b */
+  memcpy (res->bits, b->bits, sizeof (BTORSIM_BV_TYPE) * b->len);
+  memset (res->bits + b->len,
+          0,
+          sizeof (BTORSIM_BV_TYPE) * (res->len - b->len));
+
+  /* copy bits from bit vector a shifted by the width of b */
+  j = b->width / BTORSIM_BV_TYPE_BW;
+  k = b->width % BTORSIM_BV_TYPE_BW;
+  for (i = 0; i < a->len; i++)
+  {
+    assert (j + i < res->len);
+    res->bits[j + i] |= a->bits[i] << k;
+    if (k && j + i + 1 < res->len)
+      res->bits[j + i + 1] |= a->bits[i] >> (BTORSIM_BV_TYPE_BW - k);
+  }
 
   assert (rem_bits_zero_dbg (res));
+}
+
+void
+btorsim_bv_slice_into (BtorSimBitVector *res,
+                       const BtorSimBitVector *bv,
+                       uint32_t upper,
+                       uint32_t lower)
+{
+  assert (res);
+  assert (bv);
+  assert (lower <= upper);
+  assert (upper < bv->width);
+  assert (res->width == upper - lower + 1);
+  (void) upper;
+
+  uint32_t i, j, k;
+
+  j = lower / BTORSIM_BV_TYPE_BW;
+  k = lower % BTORSIM_BV_TYPE_BW;
+  for (i = 0; i < res->len; i++, j++)
+    res->bits[i] = (bv->bits[j] >> k)
+                   | (k && j + 1 < bv->len
+                          ? bv->bits[j + 1] << (BTORSIM_BV_TYPE_BW - k)
+                          : 0);
+
+  set_rem_bits_to_zero (res);
+}
+
+void
+btorsim_bv_uext_into (BtorSimBitVector *res, const BtorSimBitVector *bv)
+{
+  assert (res);
+  assert (bv);
+  assert (res->width >= bv->width);
+
+  memmove (res->bits, bv->bits, sizeof (BTORSIM_BV_TYPE) * bv->len);
+  memset (res->bits + bv->len,
+          0,
+          sizeof (BTORSIM_BV_TYPE) * (res->len - bv->len));
+}
+
+void
+btorsim_bv_sext_into (BtorSimBitVector *res, const BtorSimBitVector *bv)
+{
+  assert (res);
+  assert (bv);
+  assert (res->width >= bv->width);
+
+  uint32_t sign = btorsim_bv_get_bit (bv, bv->width - 1), width = bv->width;
+
+  btorsim_bv_uext_into (res, bv);
+  if (sign) set_bits_from (res, width);
+}
+
+
+/*------------------------------------------------------------------------*/
+
+BtorSimBitVector *
+btorsim_bv_one (uint32_t bw)
+{
+  assert (bw);
+
+  BtorSimBitVector *res = btorsim_bv_new (bw);
+  btorsim_bv_one_into (res);
   return res;
 }
 
 BtorSimBitVector *
-btorsim_bv_implies (const BtorSimBitVector *a, const BtorSimBitVector *b)
+btorsim_bv_ones (uint32_t bw)
 {
-  assert (a);
-  assert (b);
-  assert (a->len == b->len);
-  assert (a->width == b->width);
+  assert (bw);
 
-  uint32_t i;
-  BtorSimBitVector *res;
+  BtorSimBitVector *res = btorsim_bv_new (bw);
+  btorsim_bv_ones_into (res);
+  return res;
+}
 
-  res = btorsim_bv_new (a->width);
-  for (i = 0; i < a->len; i++) res->bits[i] = ~a->bits[i] | b->bits[i];
 
-  set_rem_bits_to_zero (res);
-  assert (rem_bits_zero_dbg (res));
+BtorSimBitVector *
+btorsim_bv_neg (const BtorSimBitVector *bv)
+{
+  assert (bv);
+
+  BtorSimBitVector *res = btorsim_bv_new (bv->width);
+  btorsim_bv_neg_into (res, bv);
   return res;
 }
 
 BtorSimBitVector *
-btorsim_bv_or (const BtorSimBitVector *a, const BtorSimBitVector *b)
+btorsim_bv_not (const BtorSimBitVector *bv)
 {
-  assert (a);
-  assert (b);
-  assert (a->len == b->len);
-  assert (a->width == b->width);
+  assert (bv);
 
-  uint32_t i;
-  BtorSimBitVector *res;
+  BtorSimBitVector *res = btorsim_bv_new (bv->width);
+  btorsim_bv_not_into (res, bv);
+  return res;
+}
 
-  res = btorsim_bv_new (a->width);
-  for (i = 0; i < a->len; i++) res->bits[i] = a->bits[i] | b->bits[i];
+BtorSimBitVector *
+btorsim_bv_inc (const BtorSimBitVector *bv)
+{
+  assert (bv);
 
-  assert (rem_bits_zero_dbg (res));
+  BtorSimBitVector *res = btorsim_bv_new (bv->width);
+  btorsim_bv_inc_into (res, bv);
   return res;
 }
 
 BtorSimBitVector *
-btorsim_bv_nand (const BtorSimBitVector *a, const BtorSimBitVector *b)
+btorsim_bv_dec (const BtorSimBitVector *bv)
+{
+  assert (bv);
+
+  BtorSimBitVector *res = btorsim_bv_new (bv->width);
+  btorsim_bv_dec_into (res, bv);
+  return res;
+}
+
+BtorSimBitVector *
+btorsim_bv_redand (const BtorSimBitVector *bv)
+{
+  assert (bv);
+
+  BtorSimBitVector *res = btorsim_bv_new (1);
+  btorsim_bv_redand_into (res, bv);
+  return res;
+}
+
+BtorSimBitVector *
+btorsim_bv_redor (const BtorSimBitVector *bv)
+{
+  assert (bv);
+
+  BtorSimBitVector *res = btorsim_bv_new (1);
+  btorsim_bv_redor_into (res, bv);
+  return res;
+}
+
+BtorSimBitVector *
+btorsim_bv_redxor (const BtorSimBitVector *bv)
+{
+  assert (bv);
+
+  BtorSimBitVector *res = btorsim_bv_new (1);
+  btorsim_bv_redxor_into (res, bv);
+  return res;
+}
+
+/*------------------------------------------------------------------------*/
+
+BtorSimBitVector *
+btorsim_bv_add (const BtorSimBitVector *a, const BtorSimBitVector *b)
 {
   assert (a);
   assert (b);
   assert (a->len == b->len);
   assert (a->width == b->width);
 
-  uint32_t i;
-  BtorSimBitVector *res;
-
-  res = btorsim_bv_new (a->width);
-  for (i = 0; i < a->len; i++) res->bits[i] = ~(a->bits[i] & b->bits[i]);
-
-  set_rem_bits_to_zero (res);
-  assert (rem_bits_zero_dbg (res));
+  BtorSimBitVector *res = btorsim_bv_new (a->width);
+  btorsim_bv_add_into (res, a, b);
   return res;
 }
 
 BtorSimBitVector *
-btorsim_bv_nor (const BtorSimBitVector *a, const BtorSimBitVector *b)
+btorsim_bv_sub (const BtorSimBitVector *a, const BtorSimBitVector *b)
 {
   assert (a);
   assert (b);
   assert (a->len == b->len);
   assert (a->width == b->width);
 
-  uint32_t i;
-  BtorSimBitVector *res;
+  BtorSimBitVector *res = btorsim_bv_new (a->width);
+  btorsim_bv_sub_into (res, a, b);
+  return res;
+}
 
-  res = btorsim_bv_new (a->width);
-  for (i = 0; i < a->len; i++) res->bits[i] = ~(a->bits[i] | b->bits[i]);
+BtorSimBitVector *
+btorsim_bv_and (const BtorSimBitVector *a, const BtorSimBitVector *b)
+{
+  assert (a);
+  assert (b);
+  assert (a->len == b->len);
+  assert (a->width == b->width);
 
-  set_rem_bits_to_zero (res);
-  assert (rem_bits_zero_dbg (res));
+  BtorSimBitVector *res = btorsim_bv_new (a->width);
+  btorsim_bv_and_into (res, a, b);
   return res;
 }
 
 BtorSimBitVector *
-btorsim_bv_xnor (const BtorSimBitVector *a, const BtorSimBitVector *b)
+btorsim_bv_implies (const BtorSimBitVector *a, const BtorSimBitVector *b)
 {
   assert (a);
   assert (b);
   assert (a->len == b->len);
   assert (a->width == b->width);
 
-  uint32_t i;
-  BtorSimBitVector *res;
+  BtorSimBitVector *res = btorsim_bv_new (a->width);
+  btorsim_bv_implies_into (res, a, b);
+  return res;
+}
 
-  res = btorsim_bv_new (a->width);
-  for (i = 0; i < a->len; i++) res->bits[i] = a->bits[i] ^ ~b->bits[i];
+BtorSimBitVector *
+btorsim_bv_or (const BtorSimBitVector *a, const BtorSimBitVector *b)
+{
+  assert (a);
+  assert (b);
+  assert (a->len == b->len);
+  assert (a->width == b->width);
 
-  set_rem_bits_to_zero (res);
-  assert (rem_bits_zero_dbg (res));
+  BtorSimBitVector *res = btorsim_bv_new (a->width);
+  btorsim_bv_or_into (res, a, b);
   return res;
 }
 
 BtorSimBitVector *
-btorsim_bv_xor (const BtorSimBitVector *a, const BtorSimBitVector *b)
+btorsim_bv_nand (const BtorSimBitVector *a, const BtorSimBitVector *b)
 {
   assert (a);
   assert (b);
   assert (a->len == b->len);
   assert (a->width == b->width);
 
-  uint32_t i;
-  BtorSimBitVector *res;
+  BtorSimBitVector *res = btorsim_bv_new (a->width);
+  btorsim_bv_nand_into (res, a, b);
+  return res;
+}
 
-  res = btorsim_bv_new (a->width);
-  for (i = 0; i < a->len; i++) res->bits[i] = a->bits[i] ^ b->bits[i];
+BtorSimBitVector *
+btorsim_bv_nor (const BtorSimBitVector *a, const BtorSimBitVector *b)
+{
+  assert (a);
+  assert (b);
+  assert (a->len == b->len);
+  assert (a->width == b->width);
 
-  assert (rem_bits_zero_dbg (res));
+  BtorSimBitVector *res = btorsim_bv_new (a->width);
+  btorsim_bv_nor_into (res, a, b);
   return res;
 }
 
 BtorSimBitVector *
-btorsim_bv_eq (const BtorSimBitVector *a, const BtorSimBitVector *b)
+btorsim_bv_xnor (const BtorSimBitVector *a, const BtorSimBitVector *b)
 {
   assert (a);
   assert (b);
   assert (a->len == b->len);
   assert (a->width == b->width);
 
-  uint32_t i, bit;
-  BtorSimBitVector *res;
+  BtorSimBitVector *res = btorsim_bv_new (a->width);
+  btorsim_bv_xnor_into (res, a, b);
+  return res;
+}
 
-  res = btorsim_bv_new (1);
-  bit = 1;
-  for (i = 0; i < a->len; i++)
-  {
-    if (a->bits[i] != b->bits[i])
-    {
-      bit = 0;
-      break;
-    }
-  }
-  btorsim_bv_set_bit (res, 0, bit);
+BtorSimBitVector *
+btorsim_bv_xor (const BtorSimBitVector *a, const BtorSimBitVector *b)
+{
+  assert (a);
+  assert (b);
+  assert (a->len == b->len);
+  assert (a->width == b->width);
 
-  assert (rem_bits_zero_dbg (res));
+  BtorSimBitVector *res = btorsim_bv_new (a->width);
+  btorsim_bv_xor_into (res, a, b);
   return res;
 }
 
 BtorSimBitVector *
-btorsim_bv_neq (const BtorSimBitVector *a, const BtorSimBitVector *b)
+btorsim_bv_eq (const BtorSimBitVector *a, const BtorSimBitVector *b)
 {
   assert (a);
   assert (b);
   assert (a->len == b->len);
   assert (a->width == b->width);
 
-  uint32_t i, bit;
-  BtorSimBitVector *res;
-
-  res = btorsim_bv_new (1);
-  bit = 1;
-  for (i = 0; i < a->len; i++)
-  {
-    if (a->bits[i] != b->bits[i])
-    {
-      bit = 0;
-      break;
-    }
-  }
-  btorsim_bv_set_bit (res, 0, !bit);
-
-  assert (rem_bits_zero_dbg (res));
+  BtorSimBitVector *res = btorsim_bv_new (1);
+  btorsim_bv_eq_into (res, a, b);
   return res;
 }
 
-static uint32_t
-find_diff_index (const BtorSimBitVector *a, const BtorSimBitVector *b)
+BtorSimBitVector *
+btorsim_bv_neq (const BtorSimBitVector *a, const BtorSimBitVector *b)
 {
-  uint32_t i = 0;
-
-  /* find index on which a and b differ */
-  for (i = 0; i < a->len && a->bits[i] == b->bits[i]; i++)
-    ;
+  assert (a);
+  assert (b);
+  assert (a->len == b->len);
+  assert (a->width == b->width);
 
-  return i;
+  BtorSimBitVector *res = btorsim_bv_new (1);
+  btorsim_bv_neq_into (res, a, b);
+  return res;
 }
 
 BtorSimBitVector *
@@ -1527,20 +2633,8 @@ btorsim_bv_ult (const BtorSimBitVector *a, const BtorSimBitVector *b)
   assert (a->len == b->len);
   assert (a->width == b->width);
 
-  uint32_t i, bit;
-  BtorSimBitVector *res;
-
-  res = btorsim_bv_new (1);
-  bit = 1;
-
-  i = find_diff_index (a, b);
-
-  /* a == b */
-  if (i == a->len || a->bits[i] >= b->bits[i]) bit = 0;
-
-  btorsim_bv_set_bit (res, 0, bit);
-
-  assert (rem_bits_zero_dbg (res));
+  BtorSimBitVector *res = btorsim_bv_new (1);
+  btorsim_bv_ult_into (res, a, b);
   return res;
 }
 
@@ -1552,20 +2646,8 @@ btorsim_bv_ulte (const BtorSimBitVector *a, const BtorSimBitVector *b)
   assert (a->len == b->len);
   assert (a->width == b->width);
 
-  uint32_t i, bit;
-  BtorSimBitVector *res;
-
-  res = btorsim_bv_new (1);
-  bit = 1;
-
-  i = find_diff_index (a, b);
-
-  /* a == b */
-  if (i < a->len && a->bits[i] > b->bits[i]) bit = 0;
-
-  btorsim_bv_set_bit (res, 0, bit);
-
-  assert (rem_bits_zero_dbg (res));
+  BtorSimBitVector *res = btorsim_bv_new (1);
+  btorsim_bv_ulte_into (res, a, b);
   return res;
 }
 
@@ -1577,28 +2659,8 @@ btorsim_bv_slt (const BtorSimBitVector *a, const BtorSimBitVector *b)
   assert (a->len == b->len);
   assert (a->width == b->width);
 
-  uint32_t i, bit, sign_a, sign_b;
-  BtorSimBitVector *res;
-
-  res = btorsim_bv_new (1);
-  bit = 1;
-
-  sign_a = btorsim_bv_get_bit (a, a->width - 1);
-  sign_b = btorsim_bv_get_bit (b, b->width - 1);
-
-  if (sign_a == sign_b)
-  {
-    i = find_diff_index (a, b);
-    if (i == a->len || a->bits[i] >= b->bits[i]) bit = 0;
-  }
-  else
-  {
-    bit = sign_a && !sign_b;
-  }
-
-  btorsim_bv_set_bit (res, 0, bit);
-
-  assert (rem_bits_zero_dbg (res));
+  BtorSimBitVector *res = btorsim_bv_new (1);
+  btorsim_bv_slt_into (res, a, b);
   return res;
 }
 
@@ -1610,57 +2672,8 @@ btorsim_bv_slte (const BtorSimBitVector *a, const BtorSimBitVector *b)
   assert (a->len == b->len);
   assert (a->width == b->width);
 
-  uint32_t i, bit, sign_a, sign_b;
-  BtorSimBitVector *res;
-
-  res = btorsim_bv_new (1);
-  bit = 1;
-
-  sign_a = btorsim_bv_get_bit (a, a->width - 1);
-  sign_b = btorsim_bv_get_bit (b, b->width - 1);
-
-  if (sign_a == sign_b)
-  {
-    i = find_diff_index (a, b);
-    if (i < a->len && a->bits[i] > b->bits[i]) bit = 0;
-  }
-  else
-  {
-    bit = sign_a && !sign_b;
-  }
-
-  btorsim_bv_set_bit (res, 0, bit);
-
-  assert (rem_bits_zero_dbg (res));
-  return res;
-}
-
-static BtorSimBitVector *
-sll_bv (const BtorSimBitVector *a, uint32_t shift)
-{
-  assert (a);
-
-  uint32_t skip, i, j, k;
-  BtorSimBitVector *res;
-  BTORSIM_BV_TYPE v;
-
-  res = btorsim_bv_new (a->width);
-  if (shift >= a->width) return res;
-
-  k    = shift % BTORSIM_BV_TYPE_BW;
-  skip = shift / BTORSIM_BV_TYPE_BW;
-
-  v = 0;
-  for (i = a->len - 1, j = res->len - 1 - skip;; i--, j--)
-  {
-    v            = (k == 0) ? a->bits[i] : v | (a->bits[i] << k);
-    res->bits[j] = v;
-    v = (k == 0) ? a->bits[i] : a->bits[i] >> (BTORSIM_BV_TYPE_BW - k);
-    if (i == 0 || j == 0) break;
-  }
-  set_rem_bits_to_zero (res);
-  assert (rem_bits_zero_dbg (res));
-  assert (check_bits_sll_dbg (a, res, shift));
+  BtorSimBitVector *res = btorsim_bv_new (1);
+  btorsim_bv_slte_into (res, a, b);
   return res;
 }
 
@@ -1672,19 +2685,10 @@ btorsim_bv_sll (const BtorSimBitVector *a, const BtorSimBitVector *b)
   assert (a->len == b->len);
   assert (a->width == b->width);
 
-  uint64_t shift;
-  BtorSimBitVector *res;
-  if (b->width <= 64)
-    shift = btorsim_bv_to_uint64 (b);
-  else
-  {
-    if (btorsim_bv_get_num_leading_zeros (b) < (b->width - 64))
-      return btorsim_bv_new (a->width);
-    BtorSimBitVector *lower = btorsim_bv_slice (b, 63, 0);
-    shift                   = btorsim_bv_to_uint64 (lower);
-    btorsim_bv_free (lower);
-  }
-  res = sll_bv (a, shift);
+  BtorSimBitVector *res = btorsim_bv_new (a->width);
+  btorsim_bv_sll_into (res, a, b);
+  assert (shift_amount (b) >= a->width
+          || check_bits_sll_dbg (a, res, shift_amount (b)));
   return res;
 }
 
@@ -1696,35 +2700,8 @@ btorsim_bv_srl (const BtorSimBitVector *a, const BtorSimBitVector *b)
   assert (a->len == b->len);
   assert (a->width == b->width);
 
-  uint32_t skip, i, j, k;
-  uint64_t shift;
-  BtorSimBitVector *res;
-  BTORSIM_BV_TYPE v;
-
-  res = btorsim_bv_new (a->width);
-  if (b->width <= 64)
-    shift = btorsim_bv_to_uint64 (b);
-  else
-  {
-    if (btorsim_bv_get_num_leading_zeros (b) < (b->width - 64)) return res;
-    BtorSimBitVector *lower = btorsim_bv_slice (b, 63, 0);
-    shift                   = btorsim_bv_to_uint64 (lower);
-    btorsim_bv_free (lower);
-  }
-  if (shift >= a->width) return res;
-
-  k    = shift % BTORSIM_BV_TYPE_BW;
-  skip = shift / BTORSIM_BV_TYPE_BW;
-
-  v = 0;
-  for (i = 0, j = skip; i < a->len && j < a->len; i++, j++)
-  {
-    v            = (k == 0) ? a->bits[i] : v | (a->bits[i] >> k);
-    res->bits[j] = v;
-    v = (k == 0) ? a->bits[i] : a->bits[i] << (BTORSIM_BV_TYPE_BW - k);
-  }
-
-  assert (rem_bits_zero_dbg (res));
+  BtorSimBitVector *res = btorsim_bv_new (a->width);
+  btorsim_bv_srl_into (res, a, b);
   return res;
 }
 
@@ -1736,20 +2713,8 @@ btorsim_bv_sra (const BtorSimBitVector *a, const BtorSimBitVector *b)
   assert (a->len == b->len);
   assert (a->width == b->width);
 
-  BtorSimBitVector *res, *sign_b, *srl1, *srl2, *not_a;
-
-  sign_b = btorsim_bv_slice (b, b->width - 1, b->width - 1);
-  srl1   = btorsim_bv_srl (a, b);
-  not_a  = btorsim_bv_not (a);
-  srl2   = btorsim_bv_srl (not_a, b);
-  res    = btorsim_bv_is_true (not_a) ? btorsim_bv_not (srl2)
-                                      : btorsim_bv_copy (srl1);
-  btorsim_bv_free (sign_b);
-  btorsim_bv_free (srl1);
-  btorsim_bv_free (srl2);
-  btorsim_bv_free (not_a);
-  set_rem_bits_to_zero (res);
-  assert (rem_bits_zero_dbg (res));
+  BtorSimBitVector *res = btorsim_bv_new (a->width);
+  btorsim_bv_sra_into (res, a, b);
   return res;
 }
 
@@ -1761,118 +2726,11 @@ btorsim_bv_mul (const BtorSimBitVector *a, const BtorSimBitVector *b)
   assert (a->len == b->len);
   assert (a->width == b->width);
 
-  uint32_t i;
-  uint64_t x, y;
-  BtorSimBitVector *res, *and, *shift, *add;
-
-  if (a->width <= 64)
-  {
-    x   = btorsim_bv_to_uint64 (a);
-    y   = btorsim_bv_to_uint64 (b);
-    res = btorsim_bv_uint64_to_bv (x * y, a->width);
-  }
-  else
-  {
-    res = btorsim_bv_new (a->width);
-    for (i = 0; i < a->width; i++)
-    {
-      if (btorsim_bv_get_bit (b, i))
-        and = btorsim_bv_copy (a);
-      else
-        and = btorsim_bv_new (a->width);
-      shift = sll_bv (and, i);
-      add   = btorsim_bv_add (res, shift);
-      free (and);
-      free (shift);
-      free (res);
-      res = add;
-    }
-  }
-  assert (rem_bits_zero_dbg (res));
+  BtorSimBitVector *res = btorsim_bv_new (a->width);
+  btorsim_bv_mul_into (res, a, b);
   return res;
 }
 
-static void
-udiv_urem_bv (const BtorSimBitVector *a,
-              const BtorSimBitVector *b,
-              BtorSimBitVector **q,
-              BtorSimBitVector **r)
-{
-  assert (a);
-  assert (b);
-  assert (a->len == b->len);
-  assert (a->width == b->width);
-
-  int64_t i;
-  bool is_true;
-  uint64_t x, y, z;
-
-  BtorSimBitVector *neg_b, *quot, *rem, *ult, *eq, *tmp;
-
-  if (a->width <= 64)
-  {
-    x = btorsim_bv_to_uint64 (a);
-    y = btorsim_bv_to_uint64 (b);
-    if (y == 0)
-    {
-      y = x;
-      x = UINT64_MAX;
-    }
-    else
-    {
-      z = x / y;
-      y = x % y;
-      x = z;
-    }
-    quot = btorsim_bv_uint64_to_bv (x, a->width);
-    rem  = btorsim_bv_uint64_to_bv (y, a->width);
-  }
-  else
-  {
-    neg_b = btorsim_bv_neg (b);
-    quot  = btorsim_bv_new (a->width);
-    rem   = btorsim_bv_new (a->width);
-
-    for (i = a->width - 1; i >= 0; i--)
-    {
-      tmp = sll_bv (rem, 1);
-      free (rem);
-      rem = tmp;
-      btorsim_bv_set_bit (rem, 0, btorsim_bv_get_bit (a, i));
-
-      ult     = btorsim_bv_ult (b, rem);
-      is_true = btorsim_bv_is_true (ult);
-      free (ult);
-
-      if (is_true) goto UDIV_UREM_SUBTRACT;
-
-      eq      = btorsim_bv_eq (b, rem);
-      is_true = btorsim_bv_is_true (eq);
-      free (eq);
-
-      if (is_true)
-      {
-      UDIV_UREM_SUBTRACT:
-        tmp = btorsim_bv_add (rem, neg_b);
-        free (rem);
-        rem = tmp;
-        btorsim_bv_set_bit (quot, i, 1);
-      }
-    }
-    free (neg_b);
-  }
-
-  if (q)
-    *q = quot;
-  else
-    free (quot);
-
-  if (r)
-    *r = rem;
-  else
-    free (rem);
-}
-
 BtorSimBitVector *
 btorsim_bv_udiv (const BtorSimBitVector *a, const BtorSimBitVector *b)
 {
@@ -1881,10 +2739,10 @@ btorsim_bv_udiv (const BtorSimBitVector *a, const BtorSimBitVector *b)
   assert (a->len == b->len);
   assert (a->width == b->width);
 
-  BtorSimBitVector *res = 0;
-  udiv_urem_bv (a, b, &res, 0);
-  assert (res);
-  assert (rem_bits_zero_dbg (res));
+  BtorSimBitVector *res;
+
+  res = btorsim_bv_new (a->width);
+  btorsim_bv_udiv_into (res, a, b, pool_scratch (a->width));
   return res;
 }
 
@@ -1896,46 +2754,10 @@ btorsim_bv_sdiv (const BtorSimBitVector *a, const BtorSimBitVector *b)
   assert (a->len == b->len);
   assert (a->width == b->width);
 
-  BtorSimBitVector *res = 0, *not_a, *not_a_and_b, *sign_a, *sign_b, *xor;
-  BtorSimBitVector *neg_a, *neg_b, *cond_a, *cond_b, *udiv, *neg_udiv;
-
-  if (a->width == 1)
-  {
-    not_a       = btorsim_bv_not (a);
-    not_a_and_b = btorsim_bv_and (not_a, b);
-    res         = btorsim_bv_not (not_a_and_b);
-    btorsim_bv_free (not_a);
-    btorsim_bv_free (not_a_and_b);
-  }
-  else
-  {
-    sign_a   = btorsim_bv_slice (a, a->width - 1, a->width - 1);
-    sign_b   = btorsim_bv_slice (b, b->width - 1, b->width - 1);
-    xor      = btorsim_bv_xor (sign_a, sign_b);
-    neg_a    = btorsim_bv_neg (a);
-    neg_b    = btorsim_bv_neg (b);
-    cond_a   = btorsim_bv_is_true (sign_a) ? btorsim_bv_copy (neg_a)
-                                           : btorsim_bv_copy (a);
-    cond_b   = btorsim_bv_is_true (sign_b) ? btorsim_bv_copy (neg_b)
-                                           : btorsim_bv_copy (b);
-    udiv     = btorsim_bv_udiv (cond_a, cond_b);
-    neg_udiv = btorsim_bv_neg (udiv);
-    res      = btorsim_bv_is_true (xor) ? btorsim_bv_copy (neg_udiv)
-                                        : btorsim_bv_copy (udiv);
-    btorsim_bv_free (sign_a);
-    btorsim_bv_free (sign_b);
-    btorsim_bv_free (xor);
-    btorsim_bv_free (neg_a);
-    btorsim_bv_free (neg_b);
-    btorsim_bv_free (cond_a);
-    btorsim_bv_free (cond_b);
-    btorsim_bv_free (udiv);
-    btorsim_bv_free (neg_udiv);
-  }
-
-  assert (res);
-  assert (rem_bits_zero_dbg (res));
+  BtorSimBitVector *res;
 
+  res = btorsim_bv_new (a->width);
+  btorsim_bv_sdiv_into (res, a, b, pool_scratch (a->width));
   return res;
 }
 
@@ -1947,10 +2769,10 @@ btorsim_bv_urem (const BtorSimBitVector *a, const BtorSimBitVector *b)
   assert (a->len == b->len);
   assert (a->width == b->width);
 
-  BtorSimBitVector *res = 0;
-  udiv_urem_bv (a, b, 0, &res);
-  assert (res);
-  assert (rem_bits_zero_dbg (res));
+  BtorSimBitVector *res;
+
+  res = btorsim_bv_new (a->width);
+  btorsim_bv_urem_into (res, a, b, pool_scratch (a->width));
   return res;
 }
 
@@ -1962,42 +2784,28 @@ btorsim_bv_srem (const BtorSimBitVector *a, const BtorSimBitVector *b)
   assert (a->len == b->len);
   assert (a->width == b->width);
 
-  BtorSimBitVector *res = 0, *not_b, *sign_a, *sign_b, *neg_a, *neg_b;
-  BtorSimBitVector *cond_a, *cond_b, *urem, *neg_urem;
+  BtorSimBitVector *res;
 
-  if (a->width == 1)
-  {
-    not_b = btorsim_bv_not (b);
-    res   = btorsim_bv_and (a, not_b);
-    btorsim_bv_free (not_b);
-  }
-  else
-  {
-    sign_a = btorsim_bv_slice (a, a->width - 1, a->width - 1);
-    sign_b = btorsim_bv_slice (b, b->width - 1, b->width - 1);
-    neg_a  = btorsim_bv_neg (a);
-    neg_b  = btorsim_bv_neg (b);
-    /* normalize a and b if necessary */
-    cond_a   = btorsim_bv_is_true (sign_a) ? btorsim_bv_copy (neg_a)
-                                           : btorsim_bv_copy (a);
-    cond_b   = btorsim_bv_is_true (sign_b) ? btorsim_bv_copy (neg_b)
-                                           : btorsim_bv_copy (b);
-    urem     = btorsim_bv_urem (cond_a, cond_b);
-    neg_urem = btorsim_bv_neg (urem);
-    res      = btorsim_bv_is_true (sign_a) ? btorsim_bv_copy (neg_urem)
-                                           : btorsim_bv_copy (urem);
-    btorsim_bv_free (sign_a);
-    btorsim_bv_free (sign_b);
-    btorsim_bv_free (neg_a);
-    btorsim_bv_free (neg_b);
-    btorsim_bv_free (cond_a);
-    btorsim_bv_free (cond_b);
-    btorsim_bv_free (urem);
-    btorsim_bv_free (neg_urem);
-  }
+  res = btorsim_bv_new (a->width);
+  btorsim_bv_srem_into (res, a, b, pool_scratch (a->width));
+  return res;
+}
 
-  assert (res);
-  assert (rem_bits_zero_dbg (res));
+BtorSimBitVector *
+btorsim_bv_ite (const BtorSimBitVector *c,
+                const BtorSimBitVector *t,
+                const BtorSimBitVector *e)
+{
+  assert (c);
+  assert (c->len == 1);
+  assert (t);
+  assert (t->len > 0);
+  assert (e);
+  assert (t->len == e->len);
+  assert (t->width == e->width);
+
+  BtorSimBitVector *res = btorsim_bv_new (t->width);
+  btorsim_bv_ite_into (res, c, t, e);
   return res;
 }
 
@@ -2007,42 +2815,8 @@ btorsim_bv_concat (const BtorSimBitVector *a, const BtorSimBitVector *b)
   assert (a);
   assert (b);
 
-  int64_t i, j, k;
-  BTORSIM_BV_TYPE v;
-  BtorSimBitVector *res;
-
-  res = btorsim_bv_new (a->width + b->width);
-
-  j = res->len - 1;
-
-  /* copy bits from bit vector b */
-  for (i = b->len - 1; i >= 0; i--) res->bits[j--] = b->bits[i];
-
-  k = b->width % BTORSIM_BV_TYPE_BW;
-
-  /* copy bits from bit vector a */
-  if (k == 0)
-  {
-    assert (j >= 0);
-    for (i = a->len - 1; i >= 0; i--) res->bits[j--] = a->bits[i];
-  }
-  else
-  {
-    j += 1;
-    assert (res->bits[j] >> k == 0);
-    v = res->bits[j];
-    for (i = a->len - 1; i >= 0; i--)
-    {
-      v = v | (a->bits[i] << k);
-      assert (j >= 0);
-      res->bits[j--] = v;
-      v              = a->bits[i] >> (BTORSIM_BV_TYPE_BW - k);
-    }
-    assert (j <= 0);
-    if (j == 0) res->bits[j] = v;
-  }
-
-  assert (rem_bits_zero_dbg (res));
+  BtorSimBitVector *res = btorsim_bv_new (a->width + b->width);
+  btorsim_bv_concat_into (res, a, b);
   return res;
 }
 
@@ -2050,15 +2824,10 @@ BtorSimBitVector *
 btorsim_bv_slice (const BtorSimBitVector *bv, uint32_t upper, uint32_t lower)
 {
   assert (bv);
+  assert (lower <= upper);
 
-  uint32_t i, j;
-  BtorSimBitVector *res;
-
-  res = btorsim_bv_new (upper - lower + 1);
-  for (i = lower, j = 0; i <= upper; i++)
-    btorsim_bv_set_bit (res, j++, btorsim_bv_get_bit (bv, i));
-
-  assert (rem_bits_zero_dbg (res));
+  BtorSimBitVector *res = btorsim_bv_new (upper - lower + 1);
+  btorsim_bv_slice_into (res, bv, upper, lower);
   return res;
 }
 
@@ -2068,14 +2837,8 @@ btorsim_bv_sext (const BtorSimBitVector *bv, uint32_t len)
   assert (bv);
   assert (len > 0);
 
-  uint32_t msb;
-  BtorSimBitVector *res, *tmp;
-
-  msb = btorsim_bv_get_bit (bv, bv->width - 1);
-  tmp = msb ? btorsim_bv_ones (len) : btorsim_bv_zero (len);
-  res = btorsim_bv_concat (tmp, bv);
-  btorsim_bv_free (tmp);
-  assert (rem_bits_zero_dbg (res));
+  BtorSimBitVector *res = btorsim_bv_new (bv->width + len);
+  btorsim_bv_sext_into (res, bv);
   return res;
 }
 
@@ -2085,41 +2848,8 @@ btorsim_bv_uext (const BtorSimBitVector *bv, uint32_t len)
   assert (bv);
   assert (len > 0);
 
-  BtorSimBitVector *res;
-
-  res = btorsim_bv_new (bv->width + len);
-  memcpy (
-      res->bits + res->len - bv->len, bv->bits, sizeof (*(bv->bits)) * bv->len);
-
-  assert (rem_bits_zero_dbg (res));
-  return res;
-}
-
-BtorSimBitVector *
-btorsim_bv_ite (const BtorSimBitVector *c,
-                const BtorSimBitVector *t,
-                const BtorSimBitVector *e)
-{
-  assert (c);
-  assert (c->len == 1);
-  assert (t);
-  assert (t->len > 0);
-  assert (e);
-  assert (t->len == e->len);
-  assert (t->width == e->width);
-
-  BtorSimBitVector *res;
-  BTORSIM_BV_TYPE cc, nn;
-  uint32_t i;
-
-  cc = btorsim_bv_get_bit (c, 0) ? (~(BTORSIM_BV_TYPE) 0) : 0;
-  nn = ~cc;
-
-  res = btorsim_bv_new (t->width);
-  for (i = 0; i < t->len; i++)
-    res->bits[i] = (cc & t->bits[i]) | (nn & e->bits[i]);
-
-  assert (rem_bits_zero_dbg (res));
+  BtorSimBitVector *res = btorsim_bv_new (bv->width + len);
+  btorsim_bv_uext_into (res, bv);
   return res;
 }
 
@@ -24,7 +24,7 @@ extern "C" {
 #include "btorsimrng.h"
 #include "util/btor2stack.h"
 
-#define BTORSIM_BV_TYPE uint32_t
+#define BTORSIM_BV_TYPE uint64_t
 #define BTORSIM_BV_TYPE_BW (sizeof (BTORSIM_BV_TYPE) * 8)
 
 struct BtorSimBitVector
@@ -32,14 +32,15 @@ struct BtorSimBitVector
   uint32_t width; /* length of bit vector */
   uint32_t len;   /* length of 'bits' array */
 
-  /* 'bits' represents the bit vector in 32-bit chunks, first bit of 32-bit bv
-   * in bits[0] is MSB, bit vector is 'filled' from LSB, hence spare bits (if
-   * any) come in front of the MSB and are zeroed out.
-   * E.g., for a bit vector of width 31, representing value 1:
+  /* 'bits' represents the bit vector in 64-bit limbs, least significant limb
+   * first, i.e., bit 'i' is bit 'i % 64' of bits[i / 64].  Spare bits (if
+   * any) of the last limb come in front of the MSB and are zeroed out.
+   * E.g., for a bit vector of width 65, representing value 1:
    *
-   *    bits[0] = 0 0000....1
-   *              ^ ^--- MSB
-   *              |--- spare bit
+   *    bits[0] = 0000....1
+   *    bits[1] = 0....0 0
+   *              ^      ^--- MSB
+   *              |--- spare bits
    * */
   BTORSIM_BV_TYPE bits[];
 };
@@ -50,6 +51,14 @@ BTOR2_DECLARE_STACK (BtorSimBitVectorPtr, BtorSimBitVector *);
 
 BtorSimBitVector *btorsim_bv_new (uint32_t bw);
 
+/* bytes of a bit vector of width 'bw' */
+size_t btorsim_bv_bytes (uint32_t bw);
+/* a zero bit vector of width 'bw' in 'btorsim_bv_bytes (bw)' bytes at 'mem',
+ * which is still owned by the caller */
+BtorSimBitVector *btorsim_bv_init (void *mem, uint32_t bw);
+/* limbs of scratch space taken by the division and remainder of width 'bw' */
+uint32_t btorsim_bv_scratch_limbs (uint32_t bw);
+
 BtorSimBitVector *btorsim_bv_new_random (BtorSimRNG *rng, uint32_t bw);
 
 BtorSimBitVector *btorsim_bv_new_random_bit_range (BtorSimRNG *rng,
@@ -64,6 +73,9 @@ BtorSimBitVector *btorsim_bv_dec_to_bv (const char *decimal_string,
 
 BtorSimBitVector *btorsim_bv_uint64_to_bv (uint64_t value, uint32_t bw);
 
+/* 'words' holds 64 bits per word, least significant word first */
+BtorSimBitVector *btorsim_bv_words_to_bv (const uint64_t *words, uint32_t bw);
+
 BtorSimBitVector *btorsim_bv_int64_to_bv (int64_t value, uint32_t bw);
 
 BtorSimBitVector *btorsim_bv_const (const char *str, uint32_t bw);
@@ -78,10 +90,32 @@ BtorSimBitVector *btorsim_bv_copy (const BtorSimBitVector *bv);
 
 size_t btorsim_bv_size (const BtorSimBitVector *bv);
 void btorsim_bv_free (BtorSimBitVector *bv);
+
+/* The library keeps no state shared between threads: bit-vectors freed by a
+ * thread are cached in a pool of that thread and reused by its next
+ * allocations.  A thread that ends returns its pool to the heap with
+ * 'btorsim_bv_pool_release', which may also be called at any other time. */
+void btorsim_bv_pool_release (void);
+
 int32_t btorsim_bv_compare (const BtorSimBitVector *a,
                             const BtorSimBitVector *b);
 uint32_t btorsim_bv_hash (const BtorSimBitVector *bv);
 
+/* finalizer of MurmurHash3, a bijection on 64-bit words */
+static inline uint64_t
+btorsim_bv_mix64 (uint64_t h)
+{
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdull;
+  h ^= h >> 33;
+  h *= 0xc4ceb9fe1a85ec53ull;
+  h ^= h >> 33;
+  return h;
+}
+/* hash of the value of 'bv' word by word under a random 'key', two distinct
+ * values of the same width collide with probability about 2^-64 */
+uint64_t btorsim_bv_keyed_hash (const BtorSimBitVector *bv, uint64_t key);
+
 void btorsim_bv_print (const BtorSimBitVector *bv);
 void btorsim_bv_print_all (const BtorSimBitVector *bv);
 void btorsim_bv_print_without_new_line (const BtorSimBitVector *bv);
@@ -92,6 +126,9 @@ char *btorsim_bv_to_dec_char (const BtorSimBitVector *bv);
 
 uint64_t btorsim_bv_to_uint64 (const BtorSimBitVector *bv);
 
+/* store 'bv' into its '(width + 63) / 64' words, least significant first */
+void btorsim_bv_to_words (const BtorSimBitVector *bv, uint64_t *words);
+
 /*------------------------------------------------------------------------*/
 
 /* index 0 is LSB, width - 1 is MSB */
@@ -230,6 +267,147 @@ BtorSimBitVector *btorsim_bv_flipped_bit_range (const BtorSimBitVector *bv,
 
 /*------------------------------------------------------------------------*/
 
+/* The '_into' variants write the result into 'res', which is provided by the
+ * caller and has the width of the result, and do not allocate.  'res' may be
+ * one of the operands except for mul, concat, slice and the extensions.  The
+ * division and remainder take 'btorsim_bv_scratch_limbs (width)' limbs of
+ * 'scratch'. */
+
+void btorsim_bv_copy_into (BtorSimBitVector *res, const BtorSimBitVector *bv);
+/* 'words' holds 64 bits per word, least significant word first */
+void btorsim_bv_words_into (BtorSimBitVector *res, const uint64_t *words);
+void btorsim_bv_uint64_into (BtorSimBitVector *res, uint64_t value);
+void btorsim_bv_random_into (BtorSimBitVector *res, BtorSimRNG *rng);
+
+void btorsim_bv_zero_into (BtorSimBitVector *res);
+void btorsim_bv_one_into (BtorSimBitVector *res);
+void btorsim_bv_ones_into (BtorSimBitVector *res);
+
+void btorsim_bv_neg_into (BtorSimBitVector *res, const BtorSimBitVector *bv);
+void btorsim_bv_not_into (BtorSimBitVector *res, const BtorSimBitVector *bv);
+void btorsim_bv_inc_into (BtorSimBitVector *res, const BtorSimBitVector *bv);
+void btorsim_bv_dec_into (BtorSimBitVector *res, const BtorSimBitVector *bv);
+
+void btorsim_bv_redor_into (BtorSimBitVector *res, const BtorSimBitVector *bv);
+void btorsim_bv_redand_into (BtorSimBitVector *res, const BtorSimBitVector *bv);
+void btorsim_bv_redxor_into (BtorSimBitVector *res, const BtorSimBitVector *bv);
+
+void btorsim_bv_add_into (BtorSimBitVector *res,
+                          const BtorSimBitVector *a,
+                          const BtorSimBitVector *b);
+
+void btorsim_bv_sub_into (BtorSimBitVector *res,
+                          const BtorSimBitVector *a,
+                          const BtorSimBitVector *b);
+
+void btorsim_bv_and_into (BtorSimBitVector *res,
+                          const BtorSimBitVector *a,
+                          const BtorSimBitVector *b);
+
+void btorsim_bv_implies_into (BtorSimBitVector *res,
+                              const BtorSimBitVector *a,
+                              const BtorSimBitVector *b);
+
+void btorsim_bv_nand_into (BtorSimBitVector *res,
+                           const BtorSimBitVector *a,
+                           const BtorSimBitVector *b);
+
+void btorsim_bv_nor_into (BtorSimBitVector *res,
+                          const BtorSimBitVector *a,
+                          const BtorSimBitVector *b);
+
+void btorsim_bv_or_into (BtorSimBitVector *res,
+                         const BtorSimBitVector *a,
+                         const BtorSimBitVector *b);
+
+void btorsim_bv_xnor_into (BtorSimBitVector *res,
+                           const BtorSimBitVector *a,
+                           const BtorSimBitVector *b);
+
+void btorsim_bv_xor_into (BtorSimBitVector *res,
+                          const BtorSimBitVector *a,
+                          const BtorSimBitVector *b);
+
+void btorsim_bv_eq_into (BtorSimBitVector *res,
+                         const BtorSimBitVector *a,
+                         const BtorSimBitVector *b);
+
+void btorsim_bv_neq_into (BtorSimBitVector *res,
+                          const BtorSimBitVector *a,
+                          const BtorSimBitVector *b);
+
+void btorsim_bv_ult_into (BtorSimBitVector *res,
+                          const BtorSimBitVector *a,
+                          const BtorSimBitVector *b);
+
+void btorsim_bv_ulte_into (BtorSimBitVector *res,
+                           const BtorSimBitVector *a,
+                           const BtorSimBitVector *b);
+
+void btorsim_bv_slt_into (BtorSimBitVector *res,
+                          const BtorSimBitVector *a,
+                          const BtorSimBitVector *b);
+
+void btorsim_bv_slte_into (BtorSimBitVector *res,
+                           const BtorSimBitVector *a,
+                           const BtorSimBitVector *b);
+
+void btorsim_bv_sll_into (BtorSimBitVector *res,
+                          const BtorSimBitVector *a,
+                          const BtorSimBitVector *b);
+
+void btorsim_bv_srl_into (BtorSimBitVector *res,
+                          const BtorSimBitVector *a,
+                          const BtorSimBitVector *b);
+
+void btorsim_bv_sra_into (BtorSimBitVector *res,
+                          const BtorSimBitVector *a,
+                          const BtorSimBitVector *b);
+
+void btorsim_bv_mul_into (BtorSimBitVector *res,
+                          const BtorSimBitVector *a,
+                          const BtorSimBitVector *b);
+
+void btorsim_bv_udiv_into (BtorSimBitVector *res,
+                           const BtorSimBitVector *a,
+                           const BtorSimBitVector *b,
+                           BTORSIM_BV_TYPE *scratch);
+
+void btorsim_bv_sdiv_into (BtorSimBitVector *res,
+                           const BtorSimBitVector *a,
+                           const BtorSimBitVector *b,
+                           BTORSIM_BV_TYPE *scratch);
+
+void btorsim_bv_urem_into (BtorSimBitVector *res,
+                           const BtorSimBitVector *a,
+                           const BtorSimBitVector *b,
+                           BTORSIM_BV_TYPE *scratch);
+
+void btorsim_bv_srem_into (BtorSimBitVector *res,
+                           const BtorSimBitVector *a,
+                           const BtorSimBitVector *b,
+                           BTORSIM_BV_TYPE *scratch);
+
+void btorsim_bv_ite_into (BtorSimBitVector *res,
+                          const BtorSimBitVector *c,
+                          const BtorSimBitVector *t,
+                          const BtorSimBitVector *e);
+
+void btorsim_bv_concat_into (BtorSimBitVector *res,
+                             const BtorSimBitVector *a,
+                             const BtorSimBitVector *b);
+
+void btorsim_bv_slice_into (BtorSimBitVector *res,
+                            const BtorSimBitVector *bv,
+                            uint32_t upper,
+                            uint32_t lower);
+
+/* extend 'bv' to the width of 'res' */
+void btorsim_bv_uext_into (BtorSimBitVector *res, const BtorSimBitVector *bv);
+void btorsim_bv_sext_into (BtorSimBitVector *res, const BtorSimBitVector *bv);
+
+/*------------------------------------------------------------------------*/
+
 bool btorsim_bv_is_umulo (const BtorSimBitVector *bv0,
                           const BtorSimBitVector *bv1);
 
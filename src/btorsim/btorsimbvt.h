@@ -0,0 +1,388 @@
+//
+// Created by CSHwang on 2026/10/18.
+//
+
+#ifndef BTOR2TOOLS_SRC_BTORSIM_BTORSIMBVT_H_
+#define BTOR2TOOLS_SRC_BTORSIM_BTORSIMBVT_H_
+
+#include <cstdint>
+
+/*------------------------------------------------------------------------*/
+
+/* Bit-vectors of a fixed width class for the lane-parallel engine.
+ *
+ * 'BtorSimBV<W>' holds a value of at most 'W' bits, W = 64, 128 or 256, in
+ * 'W / 64' words, least significant word first, with all bits above the
+ * width of the value zeroed out.  The word loops have compile-time bounds
+ * and are unrolled, the 128-bit class multiplies and divides with the
+ * native 'unsigned __int128'.  The actual width of a node only enters
+ * through its top mask and sign bit.
+ */
+
+#define BTORSIM_BVT_MAXWIDTH 256
+
+template <uint32_t W>
+struct BtorSimBV {
+  static_assert(W == 64 || W == 128 || W == 256, "width class must be 64, 128 or 256");
+  static constexpr uint32_t N = W / 64;
+  uint64_t w[N];
+};
+
+typedef unsigned __int128 btorsim_bvt_u128;
+
+/* the smallest width class of a 'width'-bit value */
+constexpr uint32_t btorsim_bvt_class(uint32_t width) {
+  return width <= 64 ? 64 : width <= 128 ? 128 : 256;
+}
+
+constexpr uint32_t btorsim_bvt_words(uint32_t width) { return btorsim_bvt_class(width) / 64; }
+
+/*------------------------------------------------------------------------*/
+
+/* the first 'n' words from 'p', zero-extended (or truncated) to 'W' */
+template <uint32_t W>
+inline BtorSimBV<W> btorsim_bvt_load(const uint64_t *p, uint32_t n) {
+  BtorSimBV<W> r;
+  for (uint32_t i = 0; i < BtorSimBV<W>::N; ++i) r.w[i] = i < n ? p[i] : 0;
+  return r;
+}
+
+template <uint32_t W>
+inline void btorsim_bvt_store(const BtorSimBV<W> &a, uint64_t *p, uint32_t n) {
+  for (uint32_t i = 0; i < BtorSimBV<W>::N && i < n; ++i) p[i] = a.w[i];
+}
+
+template <uint32_t W>
+inline BtorSimBV<W> btorsim_bvt_word(uint64_t v) {
+  BtorSimBV<W> r;
+  r.w[0] = v;
+  for (uint32_t i = 1; i < BtorSimBV<W>::N; ++i) r.w[i] = 0;
+  return r;
+}
+
+/* clear all bits from 'width' on */
+template <uint32_t W>
+inline BtorSimBV<W> btorsim_bvt_mask(BtorSimBV<W> a, uint32_t width) {
+  for (uint32_t i = 0; i < BtorSimBV<W>::N; ++i) {
+    if (width <= 64 * i)
+      a.w[i] = 0;
+    else if (width - 64 * i < 64)
+      a.w[i] &= (1ull << (width - 64 * i)) - 1;
+  }
+  return a;
+}
+
+template <uint32_t W>
+inline BtorSimBV<W> btorsim_bvt_ones(uint32_t width) {
+  BtorSimBV<W> r;
+  for (uint32_t i = 0; i < BtorSimBV<W>::N; ++i) r.w[i] = ~0ull;
+  return btorsim_bvt_mask(r, width);
+}
+
+template <uint32_t W>
+inline uint64_t btorsim_bvt_bit(const BtorSimBV<W> &a, uint32_t pos) {
+  return a.w[pos / 64] >> (pos % 64) & 1;
+}
+
+template <uint32_t W>
+inline bool btorsim_bvt_is_zero(const BtorSimBV<W> &a) {
+  uint64_t r = 0;
+  for (uint32_t i = 0; i < BtorSimBV<W>::N; ++i) r |= a.w[i];
+  return !r;
+}
+
+/* shift amounts of at least 'W' are handled by the callers */
+template <uint32_t W>
+inline BtorSimBV<W> btorsim_bvt_shl(const BtorSimBV<W> &a, uint32_t k) {
+  const uint32_t s = k / 64, b = k % 64;
+  BtorSimBV<W> r;
+  for (uint32_t i = 0; i < BtorSimBV<W>::N; ++i) {
+    uint64_t v = i >= s ? a.w[i - s] << b : 0;
+    if (b && i > s) v |= a.w[i - s - 1] >> (64 - b);
+    r.w[i] = v;
+  }
+  return r;
+}
+
+template <uint32_t W>
+inline BtorSimBV<W> btorsim_bvt_shr(const BtorSimBV<W> &a, uint32_t k) {
+  constexpr uint32_t N = BtorSimBV<W>::N;
+  const uint32_t s = k / 64, b = k % 64;
+  BtorSimBV<W> r;
+  for (uint32_t i = 0; i < N; ++i) {
+    uint64_t v = i + s < N ? a.w[i + s] >> b : 0;
+    if (b && i + s + 1 < N) v |= a.w[i + s + 1] << (64 - b);
+    r.w[i] = v;
+  }
+  return r;
+}
+
+/* shift amount of 'b' saturated to 'width' */
+template <uint32_t W>
+inline uint32_t btorsim_bvt_shift(const BtorSimBV<W> &b, uint32_t width) {
+  for (uint32_t i = 1; i < BtorSimBV<W>::N; ++i)
+    if (b.w[i]) return width;
+  return b.w[0] < width ? (uint32_t) b.w[0] : width;
+}
+
+/*------------------------------------------------------------------------*/
+
+template <uint32_t W>
+inline BtorSimBV<W> btorsim_bvt_not(BtorSimBV<W> a, uint32_t width) {
+  for (uint32_t i = 0; i < BtorSimBV<W>::N; ++i) a.w[i] = ~a.w[i];
+  return btorsim_bvt_mask(a, width);
+}
+
+template <uint32_t W>
+inline BtorSimBV<W> btorsim_bvt_and(BtorSimBV<W> a, const BtorSimBV<W> &b) {
+  for (uint32_t i = 0; i < BtorSimBV<W>::N; ++i) a.w[i] &= b.w[i];
+  return a;
+}
+
+template <uint32_t W>
+inline BtorSimBV<W> btorsim_bvt_or(BtorSimBV<W> a, const BtorSimBV<W> &b) {
+  for (uint32_t i = 0; i < BtorSimBV<W>::N; ++i) a.w[i] |= b.w[i];
+  return a;
+}
+
+template <uint32_t W>
+inline BtorSimBV<W> btorsim_bvt_xor(BtorSimBV<W> a, const BtorSimBV<W> &b) {
+  for (uint32_t i = 0; i < BtorSimBV<W>::N; ++i) a.w[i] ^= b.w[i];
+  return a;
+}
+
+/* sum and difference of the full 'W' bits, callers mask the result */
+template <uint32_t W>
+inline BtorSimBV<W> btorsim_bvt_add_raw(const BtorSimBV<W> &a, const BtorSimBV<W> &b) {
+  BtorSimBV<W> r;
+  uint64_t c = 0;
+  for (uint32_t i = 0; i < BtorSimBV<W>::N; ++i) {
+    btorsim_bvt_u128 t = (btorsim_bvt_u128) a.w[i] + b.w[i] + c;
+    r.w[i] = (uint64_t) t, c = (uint64_t) (t >> 64);
+  }
+  return r;
+}
+
+template <uint32_t W>
+inline BtorSimBV<W> btorsim_bvt_sub_raw(const BtorSimBV<W> &a, const BtorSimBV<W> &b) {
+  BtorSimBV<W> r;
+  uint64_t c = 0;
+  for (uint32_t i = 0; i < BtorSimBV<W>::N; ++i) {
+    btorsim_bvt_u128 t = (btorsim_bvt_u128) a.w[i] - b.w[i] - c;
+    r.w[i] = (uint64_t) t, c = (uint64_t) (t >> 64) & 1;
+  }
+  return r;
+}
+
+template <uint32_t W>
+inline BtorSimBV<W> btorsim_bvt_add(const BtorSimBV<W> &a, const BtorSimBV<W> &b, uint32_t width) {
+  return btorsim_bvt_mask(btorsim_bvt_add_raw(a, b), width);
+}
+
+template <uint32_t W>
+inline BtorSimBV<W> btorsim_bvt_sub(const BtorSimBV<W> &a, const BtorSimBV<W> &b, uint32_t width) {
+  return btorsim_bvt_mask(btorsim_bvt_sub_raw(a, b), width);
+}
+
+template <uint32_t W>
+inline BtorSimBV<W> btorsim_bvt_neg(const BtorSimBV<W> &a, uint32_t width) {
+  return btorsim_bvt_sub(btorsim_bvt_word<W>(0), a, width);
+}
+
+/* the product truncated to 'W' bits only needs the lower triangle of the
+ * partial products */
+template <uint32_t W>
+inline BtorSimBV<W> btorsim_bvt_mul(const BtorSimBV<W> &a, const BtorSimBV<W> &b, uint32_t width) {
+  constexpr uint32_t N = BtorSimBV<W>::N;
+  BtorSimBV<W> r;
+  if constexpr (N == 1)
+    r.w[0] = a.w[0] * b.w[0];
+  else if constexpr (N == 2) {
+    btorsim_bvt_u128 x = (btorsim_bvt_u128) a.w[1] << 64 | a.w[0];
+    btorsim_bvt_u128 y = (btorsim_bvt_u128) b.w[1] << 64 | b.w[0];
+    btorsim_bvt_u128 z = x * y;
+    r.w[0] = (uint64_t) z, r.w[1] = (uint64_t) (z >> 64);
+  } else {
+    for (uint32_t i = 0; i < N; ++i) r.w[i] = 0;
+    for (uint32_t i = 0; i < N; ++i) {
+      uint64_t c = 0;
+      for (uint32_t j = 0; i + j < N; ++j) {
+        btorsim_bvt_u128 t = (btorsim_bvt_u128) a.w[j] * b.w[i] + r.w[i + j] + c;
+        r.w[i + j] = (uint64_t) t, c = (uint64_t) (t >> 64);
+      }
+    }
+  }
+  return btorsim_bvt_mask(r, width);
+}
+
+/*------------------------------------------------------------------------*/
+
+template <uint32_t W>
+inline bool btorsim_bvt_eq(const BtorSimBV<W> &a, const BtorSimBV<W> &b) {
+  uint64_t r = 0;
+  for (uint32_t i = 0; i < BtorSimBV<W>::N; ++i) r |= a.w[i] ^ b.w[i];
+  return !r;
+}
+
+template <uint32_t W>
+inline bool btorsim_bvt_ult(const BtorSimBV<W> &a, const BtorSimBV<W> &b) {
+  for (uint32_t i = BtorSimBV<W>::N; i-- > 0;)
+    if (a.w[i] != b.w[i]) return a.w[i] < b.w[i];
+  return false;
+}
+
+template <uint32_t W>
+inline bool btorsim_bvt_ulte(const BtorSimBV<W> &a, const BtorSimBV<W> &b) {
+  return !btorsim_bvt_ult(b, a);
+}
+
+/* flipping the sign bit maps signed order onto unsigned order */
+template <uint32_t W>
+inline BtorSimBV<W> btorsim_bvt_flip_sign(BtorSimBV<W> a, uint32_t width) {
+  a.w[(width - 1) / 64] ^= 1ull << ((width - 1) % 64);
+  return a;
+}
+
+template <uint32_t W>
+inline bool btorsim_bvt_slt(const BtorSimBV<W> &a, const BtorSimBV<W> &b, uint32_t width) {
+  return btorsim_bvt_ult(btorsim_bvt_flip_sign(a, width), btorsim_bvt_flip_sign(b, width));
+}
+
+template <uint32_t W>
+inline bool btorsim_bvt_slte(const BtorSimBV<W> &a, const BtorSimBV<W> &b, uint32_t width) {
+  return !btorsim_bvt_slt(b, a, width);
+}
+
+template <uint32_t W>
+inline uint64_t btorsim_bvt_redand(const BtorSimBV<W> &a, uint32_t width) {
+  return btorsim_bvt_eq(a, btorsim_bvt_ones<W>(width));
+}
+
+template <uint32_t W>
+inline uint64_t btorsim_bvt_redor(const BtorSimBV<W> &a) {
+  return !btorsim_bvt_is_zero(a);
+}
+
+template <uint32_t W>
+inline uint64_t btorsim_bvt_redxor(const BtorSimBV<W> &a) {
+  uint64_t r = 0;
+  for (uint32_t i = 0; i < BtorSimBV<W>::N; ++i) r ^= a.w[i];
+  return __builtin_parityll(r);
+}
+
+/*------------------------------------------------------------------------*/
+
+template <uint32_t W>
+inline BtorSimBV<W> btorsim_bvt_sll(const BtorSimBV<W> &a, const BtorSimBV<W> &b, uint32_t width) {
+  uint32_t k = btorsim_bvt_shift(b, width);
+  return k == width ? btorsim_bvt_word<W>(0) : btorsim_bvt_mask(btorsim_bvt_shl(a, k), width);
+}
+
+template <uint32_t W>
+inline BtorSimBV<W> btorsim_bvt_srl(const BtorSimBV<W> &a, const BtorSimBV<W> &b, uint32_t width) {
+  uint32_t k = btorsim_bvt_shift(b, width);
+  return k == width ? btorsim_bvt_word<W>(0) : btorsim_bvt_shr(a, k);
+}
+
+template <uint32_t W>
+inline BtorSimBV<W> btorsim_bvt_sra(const BtorSimBV<W> &a, const BtorSimBV<W> &b, uint32_t width) {
+  uint32_t k = btorsim_bvt_shift(b, width);
+  if (k == width) k = width - 1;
+  if (!btorsim_bvt_bit(a, width - 1)) return btorsim_bvt_shr(a, k);
+  return btorsim_bvt_not(btorsim_bvt_shr(btorsim_bvt_not(a, width), k), width);
+}
+
+/*------------------------------------------------------------------------*/
+
+/* division by zero follows btorsim: the quotient is ones and the remainder
+ * the dividend */
+template <uint32_t W>
+inline void btorsim_bvt_udivrem(const BtorSimBV<W> &a, const BtorSimBV<W> &b, uint32_t width,
+                                BtorSimBV<W> &q, BtorSimBV<W> &r) {
+  constexpr uint32_t N = BtorSimBV<W>::N;
+  if (btorsim_bvt_is_zero(b)) {
+    q = btorsim_bvt_ones<W>(width), r = a;
+    return;
+  }
+  if constexpr (N == 1) {
+    q.w[0] = a.w[0] / b.w[0], r.w[0] = a.w[0] % b.w[0];
+  } else if constexpr (N == 2) {
+    btorsim_bvt_u128 x = (btorsim_bvt_u128) a.w[1] << 64 | a.w[0];
+    btorsim_bvt_u128 y = (btorsim_bvt_u128) b.w[1] << 64 | b.w[0];
+    btorsim_bvt_u128 z = x / y, m = x % y;
+    q.w[0] = (uint64_t) z, q.w[1] = (uint64_t) (z >> 64);
+    r.w[0] = (uint64_t) m, r.w[1] = (uint64_t) (m >> 64);
+  } else {
+    /* restoring division from the most significant set bit of 'a' on,
+     * the remainder may carry out of 'W' bits before it is reduced */
+    q = r = btorsim_bvt_word<W>(0);
+    if (btorsim_bvt_ult(a, b)) {
+      r = a;
+      return;
+    }
+    uint32_t top = N - 1;
+    while (!a.w[top]) --top;
+    for (int32_t i = (int32_t) (64 * top + 63 - __builtin_clzll(a.w[top])); i >= 0; --i) {
+      uint64_t carry = btorsim_bvt_bit(r, W - 1);
+      r = btorsim_bvt_shl(r, 1);
+      r.w[0] |= btorsim_bvt_bit(a, i);
+      if (carry || !btorsim_bvt_ult(r, b)) {
+        r = btorsim_bvt_sub_raw(r, b);
+        q.w[i / 64] |= 1ull << (i % 64);
+      }
+    }
+  }
+}
+
+template <uint32_t W>
+inline BtorSimBV<W> btorsim_bvt_udiv(const BtorSimBV<W> &a, const BtorSimBV<W> &b, uint32_t width) {
+  BtorSimBV<W> q, r;
+  btorsim_bvt_udivrem(a, b, width, q, r);
+  return q;
+}
+
+template <uint32_t W>
+inline BtorSimBV<W> btorsim_bvt_urem(const BtorSimBV<W> &a, const BtorSimBV<W> &b, uint32_t width) {
+  BtorSimBV<W> q, r;
+  btorsim_bvt_udivrem(a, b, width, q, r);
+  return r;
+}
+
+template <uint32_t W>
+inline BtorSimBV<W> btorsim_bvt_sdiv(const BtorSimBV<W> &a, const BtorSimBV<W> &b, uint32_t width) {
+  const bool sa = btorsim_bvt_bit(a, width - 1), sb = btorsim_bvt_bit(b, width - 1);
+  BtorSimBV<W> q = btorsim_bvt_udiv(sa ? btorsim_bvt_neg(a, width) : a,
+                                    sb ? btorsim_bvt_neg(b, width) : b, width);
+  return sa != sb ? btorsim_bvt_neg(q, width) : q;
+}
+
+template <uint32_t W>
+inline BtorSimBV<W> btorsim_bvt_srem(const BtorSimBV<W> &a, const BtorSimBV<W> &b, uint32_t width) {
+  const bool sa = btorsim_bvt_bit(a, width - 1), sb = btorsim_bvt_bit(b, width - 1);
+  BtorSimBV<W> r = btorsim_bvt_urem(sa ? btorsim_bvt_neg(a, width) : a,
+                                    sb ? btorsim_bvt_neg(b, width) : b, width);
+  return sa ? btorsim_bvt_neg(r, width) : r;
+}
+
+/*------------------------------------------------------------------------*/
+
+/* 'width' of concat is the width of the lower operand 'b' */
+template <uint32_t W>
+inline BtorSimBV<W> btorsim_bvt_concat(const BtorSimBV<W> &a, const BtorSimBV<W> &b, uint32_t width) {
+  return btorsim_bvt_or(btorsim_bvt_shl(a, width), b);
+}
+
+template <uint32_t W>
+inline BtorSimBV<W> btorsim_bvt_slice(const BtorSimBV<W> &a, uint32_t upper, uint32_t lower) {
+  return btorsim_bvt_mask(btorsim_bvt_shr(a, lower), upper - lower + 1);
+}
+
+/* 'width' of sext is the width of the operand, 'padding' the extension */
+template <uint32_t W>
+inline BtorSimBV<W> btorsim_bvt_sext(const BtorSimBV<W> &a, uint32_t width, uint32_t padding) {
+  if (!btorsim_bvt_bit(a, width - 1)) return a;
+  BtorSimBV<W> ext = btorsim_bvt_ones<W>(width + padding);
+  return btorsim_bvt_or(a, btorsim_bvt_xor(ext, btorsim_bvt_ones<W>(width)));
+}
+
+#endif //BTOR2TOOLS_SRC_BTORSIM_BTORSIMBVT_H_
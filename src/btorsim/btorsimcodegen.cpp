@@ -0,0 +1,301 @@
+//
+// Created by CSHwang on 2026/10/18.
+//
+
+#include "btorsimcodegen.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cinttypes>
+
+#include <dlfcn.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include "btorsimbv.h"
+
+/*------------------------------------------------------------------------*/
+
+static const char *prelude =
+    "#include <stdint.h>\n"
+    "\n"
+    "static inline uint64_t sx(uint64_t a, uint64_t s) { return (a ^ s) - s; }\n"
+    "\n"
+    "static inline uint64_t sdiv(uint64_t a, uint64_t b, uint64_t m, uint64_t s) {\n"
+    "  const int sa = (a & s) != 0, sb = (b & s) != 0;\n"
+    "  const uint64_t x = sa ? (0 - a) & m : a, y = sb ? (0 - b) & m : b;\n"
+    "  const uint64_t q = y ? x / y : m;\n"
+    "  return sa != sb ? (0 - q) & m : q;\n"
+    "}\n"
+    "\n"
+    "static inline uint64_t srem(uint64_t a, uint64_t b, uint64_t m, uint64_t s) {\n"
+    "  const int sa = (a & s) != 0, sb = (b & s) != 0;\n"
+    "  const uint64_t x = sa ? (0 - a) & m : a, y = sb ? (0 - b) & m : b;\n"
+    "  const uint64_t r = y ? x % y : x;\n"
+    "  return sa ? (0 - r) & m : r;\n"
+    "}\n"
+    "\n";
+
+static uint64_t mask(uint32_t width) {
+  return width == 64 ? ~0ull : (1ull << width) - 1;
+}
+
+static std::string literal(uint64_t value) {
+  char buf[32];
+  snprintf(buf, sizeof buf, "0x%" PRIx64 "ull", value);
+  return buf;
+}
+
+static uint32_t width_of(Btor2Parser *model, int64_t id) {
+  return btor2parser_get_line_by_id(model, labs(id))->sort.bitvec.width;
+}
+
+static std::string operand(Btor2Parser *model, int64_t id) {
+  std::string t = "t" + std::to_string(labs(id));
+  if (id > 0) return t;
+  return "(~" + t + " & " + literal(mask(width_of(model, id))) + ")";
+}
+
+static uint64_t constant(Btor2Line *l) {
+  uint32_t width = l->sort.bitvec.width;
+  BtorSimBitVector *bv;
+  switch (l->tag) {
+    case BTOR2_TAG_const:bv = btorsim_bv_char_to_bv(l->constant);
+      break;
+    case BTOR2_TAG_constd:bv = btorsim_bv_constd(l->constant, width);
+      break;
+    case BTOR2_TAG_consth:bv = btorsim_bv_consth(l->constant, width);
+      break;
+    case BTOR2_TAG_one:return 1;
+    case BTOR2_TAG_ones:return mask(width);
+    default:return 0;
+  }
+  uint64_t res = btorsim_bv_to_uint64(bv);
+  btorsim_bv_free(bv);
+  return res;
+}
+
+bool btorsim_codegen_supported(Btor2Line *l) {
+  if (l->sort.tag != BTOR2_TAG_SORT_bitvec || l->sort.bitvec.width > 64) return false;
+  switch (l->tag) {
+    case BTOR2_TAG_input:
+    case BTOR2_TAG_state:
+    case BTOR2_TAG_const:
+    case BTOR2_TAG_constd:
+    case BTOR2_TAG_consth:
+    case BTOR2_TAG_one:
+    case BTOR2_TAG_ones:
+    case BTOR2_TAG_zero:
+    case BTOR2_TAG_add:
+    case BTOR2_TAG_and:
+    case BTOR2_TAG_concat:
+    case BTOR2_TAG_dec:
+    case BTOR2_TAG_eq:
+    case BTOR2_TAG_implies:
+    case BTOR2_TAG_inc:
+    case BTOR2_TAG_ite:
+    case BTOR2_TAG_mul:
+    case BTOR2_TAG_nand:
+    case BTOR2_TAG_neg:
+    case BTOR2_TAG_neq:
+    case BTOR2_TAG_nor:
+    case BTOR2_TAG_not:
+    case BTOR2_TAG_or:
+    case BTOR2_TAG_redand:
+    case BTOR2_TAG_redor:
+    case BTOR2_TAG_redxor:
+    case BTOR2_TAG_sdiv:
+    case BTOR2_TAG_sext:
+    case BTOR2_TAG_sgt:
+    case BTOR2_TAG_sgte:
+    case BTOR2_TAG_slice:
+    case BTOR2_TAG_sll:
+    case BTOR2_TAG_slt:
+    case BTOR2_TAG_slte:
+    case BTOR2_TAG_sra:
+    case BTOR2_TAG_srem:
+    case BTOR2_TAG_srl:
+    case BTOR2_TAG_sub:
+    case BTOR2_TAG_udiv:
+    case BTOR2_TAG_uext:
+    case BTOR2_TAG_ugt:
+    case BTOR2_TAG_ugte:
+    case BTOR2_TAG_ult:
+    case BTOR2_TAG_ulte:
+    case BTOR2_TAG_urem:
+    case BTOR2_TAG_iff:
+    case BTOR2_TAG_xnor:
+    case BTOR2_TAG_xor:return true;
+    default:return false;
+  }
+}
+
+/* right hand side of node 'l', an empty string for loaded nodes */
+static std::string expression(Btor2Parser *model, Btor2Line *l, const std::vector<Btor2Line *> &inits) {
+  if (l->tag == BTOR2_TAG_input) return "";
+  if (l->tag == BTOR2_TAG_state)
+    return inits[l->id] ? operand(model, inits[l->id]->args[1]) : "";
+
+  uint32_t w = l->sort.bitvec.width, aw = l->nargs ? width_of(model, l->args[0]) : w;
+  std::string a = l->nargs > 0 ? operand(model, l->args[0]) : "",
+      b = l->nargs > 1 ? operand(model, l->args[1]) : "",
+      c = l->nargs > 2 ? operand(model, l->args[2]) : "";
+  std::string m = literal(mask(w)), s = literal(1ull << (aw - 1));
+  switch (l->tag) {
+    case BTOR2_TAG_const:
+    case BTOR2_TAG_constd:
+    case BTOR2_TAG_consth:
+    case BTOR2_TAG_one:
+    case BTOR2_TAG_ones:
+    case BTOR2_TAG_zero:return literal(constant(l));
+    case BTOR2_TAG_add:return "(" + a + " + " + b + ") & " + m;
+    case BTOR2_TAG_sub:return "(" + a + " - " + b + ") & " + m;
+    case BTOR2_TAG_mul:return "(" + a + " * " + b + ") & " + m;
+    case BTOR2_TAG_and:return a + " & " + b;
+    case BTOR2_TAG_or:return a + " | " + b;
+    case BTOR2_TAG_xor:return a + " ^ " + b;
+    case BTOR2_TAG_nand:return "~(" + a + " & " + b + ") & " + m;
+    case BTOR2_TAG_nor:return "~(" + a + " | " + b + ") & " + m;
+    case BTOR2_TAG_iff:
+    case BTOR2_TAG_xnor:return "~(" + a + " ^ " + b + ") & " + m;
+    case BTOR2_TAG_implies:return "(~" + a + " | " + b + ") & 1";
+    case BTOR2_TAG_not:return "~" + a + " & " + m;
+    case BTOR2_TAG_neg:return "(0 - " + a + ") & " + m;
+    case BTOR2_TAG_inc:return "(" + a + " + 1) & " + m;
+    case BTOR2_TAG_dec:return "(" + a + " - 1) & " + m;
+    case BTOR2_TAG_redand:return a + " == " + literal(mask(aw));
+    case BTOR2_TAG_redor:return a + " != 0";
+    case BTOR2_TAG_redxor:return "__builtin_parityll(" + a + ")";
+    case BTOR2_TAG_eq:return a + " == " + b;
+    case BTOR2_TAG_neq:return a + " != " + b;
+    case BTOR2_TAG_ult:return a + " < " + b;
+    case BTOR2_TAG_ulte:return a + " <= " + b;
+    case BTOR2_TAG_ugt:return a + " > " + b;
+    case BTOR2_TAG_ugte:return a + " >= " + b;
+    /* flipping the sign bit maps signed order onto unsigned order */
+    case BTOR2_TAG_slt:return "(" + a + " ^ " + s + ") < (" + b + " ^ " + s + ")";
+    case BTOR2_TAG_slte:return "(" + a + " ^ " + s + ") <= (" + b + " ^ " + s + ")";
+    case BTOR2_TAG_sgt:return "(" + a + " ^ " + s + ") > (" + b + " ^ " + s + ")";
+    case BTOR2_TAG_sgte:return "(" + a + " ^ " + s + ") >= (" + b + " ^ " + s + ")";
+    case BTOR2_TAG_sll:
+      return b + " >= " + std::to_string(w) + " ? 0 : (" + a + " << " + b + ") & " + m;
+    case BTOR2_TAG_srl:return b + " >= " + std::to_string(w) + " ? 0 : " + a + " >> " + b;
+    case BTOR2_TAG_sra:
+      return "(uint64_t) ((int64_t) sx(" + a + ", " + s + ") >> (" + b + " >= " + std::to_string(w)
+          + " ? " + std::to_string(w - 1) + " : " + b + ")) & " + m;
+    case BTOR2_TAG_udiv:return b + " ? " + a + " / " + b + " : " + m;
+    case BTOR2_TAG_urem:return b + " ? " + a + " % " + b + " : " + a;
+    case BTOR2_TAG_sdiv:return "sdiv(" + a + ", " + b + ", " + m + ", " + s + ")";
+    case BTOR2_TAG_srem:return "srem(" + a + ", " + b + ", " + m + ", " + s + ")";
+    case BTOR2_TAG_ite:return a + " ? " + b + " : " + c;
+    case BTOR2_TAG_concat:
+      return "(" + a + " << " + std::to_string(width_of(model, l->args[1])) + ") | " + b;
+    case BTOR2_TAG_slice:
+      return "(" + a + " >> " + std::to_string(l->args[2]) + ") & " + m;
+    case BTOR2_TAG_uext:return a;
+    case BTOR2_TAG_sext:return "sx(" + a + ", " + s + ") & " + m;
+    default:return "";
+  }
+}
+
+std::string btorsim_codegen_source(Btor2Parser *model,
+                                   const std::vector<int64_t> &order,
+                                   const std::vector<Btor2Line *> &inits) {
+  std::string res = prelude;
+  res += "void simubtor_eval(uint64_t *const *nodes, uint32_t n) {\n";
+  /* constants are not part of 'order' */
+  for (int64_t id = 1, max = btor2parser_max_id(model); id <= max; ++id) {
+    Btor2Line *l = btor2parser_get_line_by_id(model, id);
+    if (!l || l->sort.tag != BTOR2_TAG_SORT_bitvec || l->sort.bitvec.width > 64) continue;
+    if (l->tag != BTOR2_TAG_const && l->tag != BTOR2_TAG_constd && l->tag != BTOR2_TAG_consth
+        && l->tag != BTOR2_TAG_one && l->tag != BTOR2_TAG_ones && l->tag != BTOR2_TAG_zero)
+      continue;
+    res += "  const uint64_t t" + std::to_string(id) + " = " + expression(model, l, inits) + ";\n";
+  }
+  res += "  for (uint32_t p = 0; p < n; ++p) {\n";
+  for (int64_t id : order) {
+    Btor2Line *l = btor2parser_get_line_by_id(model, id);
+    std::string t = "t" + std::to_string(id), rhs = expression(model, l, inits);
+    std::string lanes = "nodes[" + std::to_string(id) + "][p]";
+    if (rhs.empty())
+      res += "    const uint64_t " + t + " = " + lanes + ";\n";
+    else {
+      res += "    const uint64_t " + t + " = " + rhs + ";\n";
+      res += "    " + lanes + " = " + t + ";\n";
+    }
+  }
+  res += "  }\n}\n";
+  return res;
+}
+
+/*------------------------------------------------------------------------*/
+
+static bool make_dirs(const std::string &path) {
+  for (size_t pos = 1; pos <= path.size(); ++pos) {
+    if (pos < path.size() && path[pos] != '/') continue;
+    std::string dir = path.substr(0, pos);
+    if (mkdir(dir.c_str(), 0755) && errno != EEXIST) return false;
+  }
+  return true;
+}
+
+BtorSimCompiledModel btorsim_codegen_load(const std::string &source,
+                                          const std::string &cache_dir,
+                                          std::string &error) {
+  /* the object is built for any CPU, so that cache directories can be
+   * shared, and by the compiler named in 'CC' */
+  const char *cc = getenv("CC");
+  std::string compiler = std::string(cc ? cc : "cc") + " -O2 -w -shared -fPIC";
+
+  /* FNV-1a of the compiler and the generated source, which determines the
+   * model as well as the translation */
+  uint64_t hash = 0xcbf29ce484222325ull;
+  for (char ch : compiler) hash = (hash ^ (unsigned char) ch) * 0x100000001b3ull;
+  hash = hash * 0x100000001b3ull;
+  for (char ch : source) hash = (hash ^ (unsigned char) ch) * 0x100000001b3ull;
+  char name[64];
+  snprintf(name, sizeof name, "simubtor-%016" PRIx64, hash);
+  std::string base = cache_dir + "/" + name, object = base + ".so";
+
+  if (access(object.c_str(), R_OK)) {
+    if (!make_dirs(cache_dir)) {
+      error = "can not create cache directory '" + cache_dir + "'";
+      return nullptr;
+    }
+    /* concurrent runs on the same model compile in distinct files */
+    std::string tmp = base + "." + std::to_string(getpid()), file = tmp + ".c";
+    tmp += ".so";
+    FILE *out = fopen(file.c_str(), "w");
+    if (!out) {
+      error = "can not write '" + file + "'";
+      return nullptr;
+    }
+    fwrite(source.data(), 1, source.size(), out);
+    fclose(out);
+
+    std::string cmd = compiler + " -o '" + tmp + "' '" + file + "'";
+    int failed = system(cmd.c_str());
+    unlink(file.c_str());
+    if (failed) {
+      unlink(tmp.c_str());
+      error = "'" + cmd + "' failed";
+      return nullptr;
+    }
+    if (rename(tmp.c_str(), object.c_str())) {
+      unlink(tmp.c_str());
+      error = "can not rename '" + tmp + "'";
+      return nullptr;
+    }
+  }
+
+  void *handle = dlopen(object.c_str(), RTLD_NOW | RTLD_LOCAL);
+  if (!handle) {
+    error = dlerror();
+    return nullptr;
+  }
+  auto res = (BtorSimCompiledModel) dlsym(handle, "simubtor_eval");
+  if (!res) error = "'simubtor_eval' not found in '" + object + "'";
+  return res;
+}
@@ -0,0 +1,44 @@
+//
+// Created by CSHwang on 2026/10/18.
+//
+
+#ifndef BTOR2TOOLS_SRC_BTORSIM_BTORSIMCODEGEN_H_
+#define BTOR2TOOLS_SRC_BTORSIM_BTORSIMCODEGEN_H_
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+#include "btor2parser/btor2parser.h"
+
+/*------------------------------------------------------------------------*/
+
+/* Native back end of the lane-parallel engine (see btorsimlane.h).
+ *
+ * The nodes of a model whose widths are all at most 64 are translated into
+ * one straight-line C function, which evaluates every pattern with the
+ * intermediate values kept in local variables.  The function is compiled
+ * by the system compiler into a shared object, cached under the hash of
+ * its source and loaded with 'dlopen'.
+ */
+
+/* evaluate 'n' patterns, 'nodes[id]' points to the lanes of node 'id' */
+typedef void (*BtorSimCompiledModel)(uint64_t *const *nodes, uint32_t n);
+
+/* whether 'l' can be translated, given that all its operands can */
+bool btorsim_codegen_supported(Btor2Line *l);
+
+/* C source evaluating the nodes in 'order' (topologically sorted), inputs
+ * and states without init are read from 'nodes', all other nodes are
+ * computed and stored back */
+std::string btorsim_codegen_source(Btor2Parser *model,
+                                   const std::vector<int64_t> &order,
+                                   const std::vector<Btor2Line *> &inits);
+
+/* compile 'source' into 'cache_dir' unless it is cached already and load
+ * it, on failure 'nullptr' is returned and 'error' is set */
+BtorSimCompiledModel btorsim_codegen_load(const std::string &source,
+                                          const std::string &cache_dir,
+                                          std::string &error);
+
+#endif //BTOR2TOOLS_SRC_BTORSIM_BTORSIMCODEGEN_H_
@@ -0,0 +1,248 @@
+//
+// Created by CSHwang on 2026/10/18.
+//
+
+#include "btorsimlane.h"
+
+#include <cassert>
+
+/*------------------------------------------------------------------------*/
+
+#define LANE_LOOP(EXPR)                         \
+  do {                                          \
+    for (uint32_t i = 0; i < n; ++i) EXPR;      \
+  } while (0)
+
+uint64_t btorsim_lane_mask(uint32_t width) {
+  assert (0 < width && width <= BTORSIM_LANE_MAXWIDTH);
+  return width == 64 ? ~0ull : (1ull << width) - 1;
+}
+
+static inline uint64_t sign_bit(uint32_t width) { return 1ull << (width - 1); }
+
+/* sign-extend a 'width'-bit value to 64 bits */
+static inline int64_t to_signed(uint64_t a, uint32_t width) {
+  const uint64_t s = sign_bit(width);
+  return (int64_t) ((a ^ s) - s);
+}
+
+/*------------------------------------------------------------------------*/
+
+void btorsim_lane_fill(uint64_t *__restrict res, uint64_t value, uint32_t n) {
+  LANE_LOOP(res[i] = value);
+}
+
+void btorsim_lane_copy(uint64_t *__restrict res, const uint64_t *__restrict a, uint32_t n) {
+  LANE_LOOP(res[i] = a[i]);
+}
+
+void btorsim_lane_not(uint64_t *__restrict res, const uint64_t *__restrict a, uint32_t n, uint32_t width) {
+  const uint64_t m = btorsim_lane_mask(width);
+  LANE_LOOP(res[i] = ~a[i] & m);
+}
+
+void btorsim_lane_neg(uint64_t *__restrict res, const uint64_t *__restrict a, uint32_t n, uint32_t width) {
+  const uint64_t m = btorsim_lane_mask(width);
+  LANE_LOOP(res[i] = (0 - a[i]) & m);
+}
+
+void btorsim_lane_inc(uint64_t *__restrict res, const uint64_t *__restrict a, uint32_t n, uint32_t width) {
+  const uint64_t m = btorsim_lane_mask(width);
+  LANE_LOOP(res[i] = (a[i] + 1) & m);
+}
+
+void btorsim_lane_dec(uint64_t *__restrict res, const uint64_t *__restrict a, uint32_t n, uint32_t width) {
+  const uint64_t m = btorsim_lane_mask(width);
+  LANE_LOOP(res[i] = (a[i] - 1) & m);
+}
+
+void btorsim_lane_redand(uint64_t *__restrict res, const uint64_t *__restrict a, uint32_t n, uint32_t width) {
+  const uint64_t m = btorsim_lane_mask(width);
+  LANE_LOOP(res[i] = a[i] == m);
+}
+
+void btorsim_lane_redor(uint64_t *__restrict res, const uint64_t *__restrict a, uint32_t n) {
+  LANE_LOOP(res[i] = a[i] != 0);
+}
+
+void btorsim_lane_redxor(uint64_t *__restrict res, const uint64_t *__restrict a, uint32_t n) {
+  LANE_LOOP(res[i] = __builtin_parityll(a[i]));
+}
+
+/*------------------------------------------------------------------------*/
+
+void btorsim_lane_add(uint64_t *__restrict res, const uint64_t *__restrict a,
+                      const uint64_t *__restrict b, uint32_t n, uint32_t width) {
+  const uint64_t m = btorsim_lane_mask(width);
+  LANE_LOOP(res[i] = (a[i] + b[i]) & m);
+}
+
+void btorsim_lane_sub(uint64_t *__restrict res, const uint64_t *__restrict a,
+                      const uint64_t *__restrict b, uint32_t n, uint32_t width) {
+  const uint64_t m = btorsim_lane_mask(width);
+  LANE_LOOP(res[i] = (a[i] - b[i]) & m);
+}
+
+void btorsim_lane_mul(uint64_t *__restrict res, const uint64_t *__restrict a,
+                      const uint64_t *__restrict b, uint32_t n, uint32_t width) {
+  const uint64_t m = btorsim_lane_mask(width);
+  LANE_LOOP(res[i] = (a[i] * b[i]) & m);
+}
+
+void btorsim_lane_and(uint64_t *__restrict res, const uint64_t *__restrict a,
+                      const uint64_t *__restrict b, uint32_t n) {
+  LANE_LOOP(res[i] = a[i] & b[i]);
+}
+
+void btorsim_lane_or(uint64_t *__restrict res, const uint64_t *__restrict a,
+                     const uint64_t *__restrict b, uint32_t n) {
+  LANE_LOOP(res[i] = a[i] | b[i]);
+}
+
+void btorsim_lane_xor(uint64_t *__restrict res, const uint64_t *__restrict a,
+                      const uint64_t *__restrict b, uint32_t n) {
+  LANE_LOOP(res[i] = a[i] ^ b[i]);
+}
+
+void btorsim_lane_nand(uint64_t *__restrict res, const uint64_t *__restrict a,
+                       const uint64_t *__restrict b, uint32_t n, uint32_t width) {
+  const uint64_t m = btorsim_lane_mask(width);
+  LANE_LOOP(res[i] = ~(a[i] & b[i]) & m);
+}
+
+void btorsim_lane_nor(uint64_t *__restrict res, const uint64_t *__restrict a,
+                      const uint64_t *__restrict b, uint32_t n, uint32_t width) {
+  const uint64_t m = btorsim_lane_mask(width);
+  LANE_LOOP(res[i] = ~(a[i] | b[i]) & m);
+}
+
+void btorsim_lane_xnor(uint64_t *__restrict res, const uint64_t *__restrict a,
+                       const uint64_t *__restrict b, uint32_t n, uint32_t width) {
+  const uint64_t m = btorsim_lane_mask(width);
+  LANE_LOOP(res[i] = ~(a[i] ^ b[i]) & m);
+}
+
+void btorsim_lane_implies(uint64_t *__restrict res, const uint64_t *__restrict a,
+                          const uint64_t *__restrict b, uint32_t n) {
+  LANE_LOOP(res[i] = (~a[i] | b[i]) & 1);
+}
+
+/*------------------------------------------------------------------------*/
+
+void btorsim_lane_eq(uint64_t *__restrict res, const uint64_t *__restrict a,
+                     const uint64_t *__restrict b, uint32_t n) {
+  LANE_LOOP(res[i] = a[i] == b[i]);
+}
+
+void btorsim_lane_neq(uint64_t *__restrict res, const uint64_t *__restrict a,
+                      const uint64_t *__restrict b, uint32_t n) {
+  LANE_LOOP(res[i] = a[i] != b[i]);
+}
+
+void btorsim_lane_ult(uint64_t *__restrict res, const uint64_t *__restrict a,
+                      const uint64_t *__restrict b, uint32_t n) {
+  LANE_LOOP(res[i] = a[i] < b[i]);
+}
+
+void btorsim_lane_ulte(uint64_t *__restrict res, const uint64_t *__restrict a,
+                       const uint64_t *__restrict b, uint32_t n) {
+  LANE_LOOP(res[i] = a[i] <= b[i]);
+}
+
+/* flipping the sign bit maps signed order onto unsigned order */
+void btorsim_lane_slt(uint64_t *__restrict res, const uint64_t *__restrict a,
+                      const uint64_t *__restrict b, uint32_t n, uint32_t width) {
+  const uint64_t s = sign_bit(width);
+  LANE_LOOP(res[i] = (a[i] ^ s) < (b[i] ^ s));
+}
+
+void btorsim_lane_slte(uint64_t *__restrict res, const uint64_t *__restrict a,
+                       const uint64_t *__restrict b, uint32_t n, uint32_t width) {
+  const uint64_t s = sign_bit(width);
+  LANE_LOOP(res[i] = (a[i] ^ s) <= (b[i] ^ s));
+}
+
+/*------------------------------------------------------------------------*/
+
+void btorsim_lane_sll(uint64_t *__restrict res, const uint64_t *__restrict a,
+                      const uint64_t *__restrict b, uint32_t n, uint32_t width) {
+  const uint64_t m = btorsim_lane_mask(width);
+  LANE_LOOP(res[i] = b[i] >= width ? 0 : (a[i] << b[i]) & m);
+}
+
+void btorsim_lane_srl(uint64_t *__restrict res, const uint64_t *__restrict a,
+                      const uint64_t *__restrict b, uint32_t n, uint32_t width) {
+  LANE_LOOP(res[i] = b[i] >= width ? 0 : a[i] >> b[i]);
+}
+
+void btorsim_lane_sra(uint64_t *__restrict res, const uint64_t *__restrict a,
+                      const uint64_t *__restrict b, uint32_t n, uint32_t width) {
+  const uint64_t m = btorsim_lane_mask(width);
+  LANE_LOOP(res[i] = (uint64_t) (to_signed(a[i], width) >> (b[i] >= width ? width - 1 : b[i])) & m);
+}
+
+/*------------------------------------------------------------------------*/
+
+/* division by zero follows btorsim: 'udiv' yields ones, 'urem' the dividend */
+
+void btorsim_lane_udiv(uint64_t *__restrict res, const uint64_t *__restrict a,
+                       const uint64_t *__restrict b, uint32_t n, uint32_t width) {
+  const uint64_t m = btorsim_lane_mask(width);
+  LANE_LOOP(res[i] = b[i] ? a[i] / b[i] : m);
+}
+
+void btorsim_lane_urem(uint64_t *__restrict res, const uint64_t *__restrict a,
+                       const uint64_t *__restrict b, uint32_t n, uint32_t width) {
+  (void) width;
+  LANE_LOOP(res[i] = b[i] ? a[i] % b[i] : a[i]);
+}
+
+void btorsim_lane_sdiv(uint64_t *__restrict res, const uint64_t *__restrict a,
+                       const uint64_t *__restrict b, uint32_t n, uint32_t width) {
+  const uint64_t m = btorsim_lane_mask(width), s = sign_bit(width);
+  for (uint32_t i = 0; i < n; ++i) {
+    const bool sa = a[i] & s, sb = b[i] & s;
+    const uint64_t x = sa ? (0 - a[i]) & m : a[i];
+    const uint64_t y = sb ? (0 - b[i]) & m : b[i];
+    const uint64_t q = y ? x / y : m;
+    res[i] = sa != sb ? (0 - q) & m : q;
+  }
+}
+
+void btorsim_lane_srem(uint64_t *__restrict res, const uint64_t *__restrict a,
+                       const uint64_t *__restrict b, uint32_t n, uint32_t width) {
+  const uint64_t m = btorsim_lane_mask(width), s = sign_bit(width);
+  for (uint32_t i = 0; i < n; ++i) {
+    const bool sa = a[i] & s, sb = b[i] & s;
+    const uint64_t x = sa ? (0 - a[i]) & m : a[i];
+    const uint64_t y = sb ? (0 - b[i]) & m : b[i];
+    const uint64_t r = y ? x % y : x;
+    res[i] = sa ? (0 - r) & m : r;
+  }
+}
+
+/*------------------------------------------------------------------------*/
+
+void btorsim_lane_ite(uint64_t *__restrict res, const uint64_t *__restrict c,
+                      const uint64_t *__restrict t, const uint64_t *__restrict e, uint32_t n) {
+  LANE_LOOP(res[i] = (t[i] & (0 - c[i])) | (e[i] & (c[i] - 1)));
+}
+
+void btorsim_lane_concat(uint64_t *__restrict res, const uint64_t *__restrict a,
+                         const uint64_t *__restrict b, uint32_t n, uint32_t width) {
+  assert (width < 64);
+  LANE_LOOP(res[i] = (a[i] << width) | b[i]);
+}
+
+void btorsim_lane_slice(uint64_t *__restrict res, const uint64_t *__restrict a,
+                        uint32_t n, uint32_t upper, uint32_t lower) {
+  assert (lower <= upper);
+  const uint64_t m = btorsim_lane_mask(upper - lower + 1);
+  LANE_LOOP(res[i] = (a[i] >> lower) & m);
+}
+
+void btorsim_lane_sext(uint64_t *__restrict res, const uint64_t *__restrict a,
+                       uint32_t n, uint32_t width, uint32_t padding) {
+  const uint64_t m = btorsim_lane_mask(width + padding);
+  LANE_LOOP(res[i] = (uint64_t) to_signed(a[i], width) & m);
+}
@@ -0,0 +1,74 @@
+//
+// Created by CSHwang on 2026/10/18.
+//
+
+#ifndef BTOR2TOOLS_SRC_BTORSIM_BTORSIMLANE_H_
+#define BTOR2TOOLS_SRC_BTORSIM_BTORSIMLANE_H_
+
+#include <cstdint>
+
+/*------------------------------------------------------------------------*/
+
+/* Lane-parallel kernels for bit-vectors of width 1 up to 64.
+ *
+ * Every operand holds the values of 'n' patterns stored contiguously
+ * (structure of arrays), one 'uint64_t' per pattern, with all bits above
+ * the width of the operand zeroed out.  The loops are kept free of
+ * cross-lane dependencies so that the compiler can map them onto SIMD
+ * registers (e.g. 8 x uint64_t per AVX-512 register).
+ */
+
+#define BTORSIM_LANE_MAXWIDTH 64
+
+uint64_t btorsim_lane_mask (uint32_t width);
+
+void btorsim_lane_fill (uint64_t *res, uint64_t value, uint32_t n);
+void btorsim_lane_copy (uint64_t *res, const uint64_t *a, uint32_t n);
+
+void btorsim_lane_not (uint64_t *res, const uint64_t *a, uint32_t n, uint32_t width);
+void btorsim_lane_neg (uint64_t *res, const uint64_t *a, uint32_t n, uint32_t width);
+void btorsim_lane_inc (uint64_t *res, const uint64_t *a, uint32_t n, uint32_t width);
+void btorsim_lane_dec (uint64_t *res, const uint64_t *a, uint32_t n, uint32_t width);
+
+void btorsim_lane_redand (uint64_t *res, const uint64_t *a, uint32_t n, uint32_t width);
+void btorsim_lane_redor (uint64_t *res, const uint64_t *a, uint32_t n);
+void btorsim_lane_redxor (uint64_t *res, const uint64_t *a, uint32_t n);
+
+void btorsim_lane_add (uint64_t *res, const uint64_t *a, const uint64_t *b, uint32_t n, uint32_t width);
+void btorsim_lane_sub (uint64_t *res, const uint64_t *a, const uint64_t *b, uint32_t n, uint32_t width);
+void btorsim_lane_mul (uint64_t *res, const uint64_t *a, const uint64_t *b, uint32_t n, uint32_t width);
+
+void btorsim_lane_and (uint64_t *res, const uint64_t *a, const uint64_t *b, uint32_t n);
+void btorsim_lane_or (uint64_t *res, const uint64_t *a, const uint64_t *b, uint32_t n);
+void btorsim_lane_xor (uint64_t *res, const uint64_t *a, const uint64_t *b, uint32_t n);
+void btorsim_lane_nand (uint64_t *res, const uint64_t *a, const uint64_t *b, uint32_t n, uint32_t width);
+void btorsim_lane_nor (uint64_t *res, const uint64_t *a, const uint64_t *b, uint32_t n, uint32_t width);
+void btorsim_lane_xnor (uint64_t *res, const uint64_t *a, const uint64_t *b, uint32_t n, uint32_t width);
+void btorsim_lane_implies (uint64_t *res, const uint64_t *a, const uint64_t *b, uint32_t n);
+
+/* comparisons produce 1-bit results, 'width' is the width of the operands */
+void btorsim_lane_eq (uint64_t *res, const uint64_t *a, const uint64_t *b, uint32_t n);
+void btorsim_lane_neq (uint64_t *res, const uint64_t *a, const uint64_t *b, uint32_t n);
+void btorsim_lane_ult (uint64_t *res, const uint64_t *a, const uint64_t *b, uint32_t n);
+void btorsim_lane_ulte (uint64_t *res, const uint64_t *a, const uint64_t *b, uint32_t n);
+void btorsim_lane_slt (uint64_t *res, const uint64_t *a, const uint64_t *b, uint32_t n, uint32_t width);
+void btorsim_lane_slte (uint64_t *res, const uint64_t *a, const uint64_t *b, uint32_t n, uint32_t width);
+
+void btorsim_lane_sll (uint64_t *res, const uint64_t *a, const uint64_t *b, uint32_t n, uint32_t width);
+void btorsim_lane_srl (uint64_t *res, const uint64_t *a, const uint64_t *b, uint32_t n, uint32_t width);
+void btorsim_lane_sra (uint64_t *res, const uint64_t *a, const uint64_t *b, uint32_t n, uint32_t width);
+
+void btorsim_lane_udiv (uint64_t *res, const uint64_t *a, const uint64_t *b, uint32_t n, uint32_t width);
+void btorsim_lane_urem (uint64_t *res, const uint64_t *a, const uint64_t *b, uint32_t n, uint32_t width);
+void btorsim_lane_sdiv (uint64_t *res, const uint64_t *a, const uint64_t *b, uint32_t n, uint32_t width);
+void btorsim_lane_srem (uint64_t *res, const uint64_t *a, const uint64_t *b, uint32_t n, uint32_t width);
+
+void btorsim_lane_ite (uint64_t *res, const uint64_t *c, const uint64_t *t, const uint64_t *e, uint32_t n);
+
+/* 'width' of concat is the width of the lower operand 'b' */
+void btorsim_lane_concat (uint64_t *res, const uint64_t *a, const uint64_t *b, uint32_t n, uint32_t width);
+void btorsim_lane_slice (uint64_t *res, const uint64_t *a, uint32_t n, uint32_t upper, uint32_t lower);
+/* 'width' of sext is the width of the operand, 'padding' the extension */
+void btorsim_lane_sext (uint64_t *res, const uint64_t *a, uint32_t n, uint32_t width, uint32_t padding);
+
+#endif //BTOR2TOOLS_SRC_BTORSIM_BTORSIMLANE_H_
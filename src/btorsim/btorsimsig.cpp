@@ -0,0 +1,97 @@
+//
+// Created by CSHwang on 2026/10/18.
+//
+
+#include "btorsimsig.h"
+
+#include <cassert>
+#include <cstdlib>
+#include <cstring>
+
+#include <algorithm>
+
+#include <unistd.h>
+#include <sys/mman.h>
+
+/*------------------------------------------------------------------------*/
+
+/* words of the bitmap of an id of width 'w' */
+static size_t num_words(uint32_t w, int64_t steps) {
+  return (size_t) (((uint64_t) w * (uint64_t) steps + 63) / 64);
+}
+
+BtorSimSignatures::~BtorSimSignatures() {
+  if (bits) munmap(bits, size);
+}
+
+bool BtorSimSignatures::init(const std::vector<uint32_t> &widths, int64_t n, const char *dir, std::string &error) {
+  assert (!bits);
+  width = widths;
+  steps = n;
+  offset.resize(width.size() + 1);
+  size_t words = 0;
+  for (size_t i = 0; i < width.size(); ++i) {
+    offset[i] = words;
+    words += num_words(width[i], steps);
+  }
+  offset[width.size()] = words;
+  size = std::max<size_t>(words, 1) * sizeof(uint64_t);
+
+  void *p;
+  if (!dir)
+    p = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+  else {
+    std::string path = std::string(dir) + "/simubtor-sig-XXXXXX";
+    int fd = mkstemp(&path[0]);
+    if (fd < 0) {
+      error = "can not create a signature file in '" + std::string(dir) + "'";
+      return false;
+    }
+    /* the file disappears with the mapping */
+    unlink(path.c_str());
+    if (ftruncate(fd, (off_t) size)) {
+      close(fd);
+      error = "can not resize '" + path + "' to " + std::to_string(size) + " bytes";
+      return false;
+    }
+    p = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+  }
+  if (p == MAP_FAILED) {
+    error = "can not map " + std::to_string(size) + " bytes of signatures";
+    return false;
+  }
+  bits = (uint64_t *) p;
+  return true;
+}
+
+void BtorSimSignatures::record(int64_t id, int64_t step, uint32_t lower, uint64_t value, uint32_t n) {
+  assert (recorded(id));
+  assert (0 <= step && step < steps);
+  assert (lower + n <= width[id] && n <= 64);
+  assert (n == 64 || !(value >> n));
+  if (!value) return;
+  uint64_t pos = (uint64_t) step * width[id] + lower;
+  uint64_t *w = bits + offset[id] + pos / 64;
+  uint32_t b = pos % 64;
+  __atomic_fetch_or(w, value << b, __ATOMIC_RELAXED);
+  if (b && b + n > 64) __atomic_fetch_or(w + 1, value >> (64 - b), __ATOMIC_RELAXED);
+}
+
+void BtorSimSignatures::clear(int64_t id, int64_t step) {
+  assert (recorded(id));
+  assert (0 <= step && step < steps);
+  uint64_t pos = (uint64_t) step * width[id], end = pos + width[id];
+  while (pos < end) {
+    uint32_t b = pos % 64, n = (uint32_t) std::min<uint64_t>(64 - b, end - pos);
+    uint64_t m = n == 64 ? ~0ull : ((1ull << n) - 1) << b;
+    __atomic_fetch_and(bits + offset[id] + pos / 64, ~m, __ATOMIC_RELAXED);
+    pos += n;
+  }
+}
+
+int BtorSimSignatures::compare(int64_t a, int64_t b) const {
+  assert (recorded(a) && recorded(b));
+  assert (width[a] == width[b]);
+  return memcmp(bits + offset[a], bits + offset[b], (offset[a + 1] - offset[a]) * sizeof(uint64_t));
+}
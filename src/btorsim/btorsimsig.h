@@ -0,0 +1,55 @@
+//
+// Created by CSHwang on 2026/10/18.
+//
+
+#ifndef BTOR2TOOLS_SRC_BTORSIM_BTORSIMSIG_H_
+#define BTOR2TOOLS_SRC_BTORSIM_BTORSIMSIG_H_
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+/*------------------------------------------------------------------------*/
+
+/* Exact simulation signatures.
+ *
+ * The value of a node in every step is kept in a packed bitmap, 'width'
+ * bits per step, so that nodes with the same hash can be told apart by
+ * their simulation vectors.  All bitmaps live in one zero-initialized
+ * mapping, either anonymous or backed by an unlinked file in a given
+ * directory for runs that do not fit into main memory.  Distinct steps may
+ * be recorded by different threads at the same time.
+ */
+struct BtorSimSignatures {
+  BtorSimSignatures() = default;
+  BtorSimSignatures(const BtorSimSignatures &) = delete;
+  BtorSimSignatures &operator=(const BtorSimSignatures &) = delete;
+  ~BtorSimSignatures();
+
+  /* reserve 'steps' steps for every id 'i' with 'widths[i]' > 0, backed by
+   * a file in 'dir' unless it is 'nullptr', on failure 'error' is set */
+  bool init(const std::vector<uint32_t> &widths, int64_t steps, const char *dir, std::string &error);
+
+  bool recorded(int64_t id) const { return id < (int64_t) width.size() && width[id]; }
+
+  /* set the 'n' (at most 64) bits of 'value' from bit 'lower' on in step
+   * 'step' (from 0) of 'id', the bits above 'n' of 'value' must be zero */
+  void record(int64_t id, int64_t step, uint32_t lower, uint64_t value, uint32_t n);
+  /* forget step 'step' of 'id' */
+  void clear(int64_t id, int64_t step);
+
+  /* total order on the bitmaps of two ids of the same width */
+  int compare(int64_t a, int64_t b) const;
+
+  size_t bytes() const { return size; }
+
+ private:
+  std::vector<uint32_t> width;
+  std::vector<size_t> offset;
+  int64_t steps = 0;
+  uint64_t *bits = nullptr;
+  size_t size = 0;
+};
+
+#endif //BTOR2TOOLS_SRC_BTORSIM_BTORSIMSIG_H_
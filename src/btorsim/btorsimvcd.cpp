@@ -333,12 +333,15 @@ BtorSimVCDWriter::add_value_change (int64_t k, int64_t id, BtorSimState state)
           || state.array_state != prev_value[id].array_state)
       {
         update_time (k);
-        for (auto it : state.array_state->data)
+        std::map<std::string, const BtorSimBitVector*> prev_data;
+        if (prev_value[id].array_state)
+          prev_data = prev_value[id].array_state->data ();
+        for (auto it : state.array_state->data ())
         {
-          if (!prev_value[id].array_state
-              || prev_value[id].array_state->data.find (it.first)
-                     == prev_value[id].array_state->data.end ()
-              || prev_value[id].array_state->data.at (it.first) != it.second)
+          auto prev = prev_data.find (it.first);
+          if (prev == prev_data.end ()
+              || (prev->second != it.second
+                  && btorsim_bv_compare (prev->second, it.second)))
           {
             std::string sval ("");
             if (it.second->width > 1) sval += "b";
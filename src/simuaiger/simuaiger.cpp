@@ -21,6 +21,7 @@ extern "C" {
 #include "btorfunc.h"
 #include "twosat.h"
 #include "btorsim/btorsimstate.h"
+#include "btorsim/btorsimsig.h"
 
 /*------------------------------------------------------------------------*/
 
@@ -47,6 +48,9 @@ static const char *usage =
     "  --help                  print this command line option summary\n"
     "  --var                   print variables' value to log\n"
     "  --hash                  print variables' hash value to log\n"
+    "  --exact                 also keep the simulation vectors and split the groups\n"
+    "                          of equal hashes by them (no hash collisions)\n"
+    "  --exact-dir <dir>       same as '--exact' with the vectors in a file in <dir>\n"
     "\n"
     "  --model <model>         load model from <model> in 'BTOR' format\n"
     "  --output <output>       write result to <output>\n"
@@ -56,6 +60,11 @@ static BtorSimRNG rng, hrng;
 static bool print_var = false;
 static bool print_hash = false;
 
+/* '--exact': the value of every variable in every step is kept bit by bit */
+static bool exact = false;
+static const char *exact_dir;
+static BtorSimSignatures signatures;
+
 static std::vector<short> cons;
 static std::vector<uint64_t> hvalue;
 
@@ -194,7 +203,9 @@ static void random_simulation(int k) {
       for (uint i = 1; i <= model->maxvar; ++i) {
         uint lit = i << 1;
         if (table[lit] == -1) continue;
-        if (table[lit]) hvalue[i] ^= base;
+        if (!table[lit]) continue;
+        hvalue[i] ^= base;
+        if (exact) signatures.record(i, step - 1, 0, 1, 1);
       }
 
       ++succ;
@@ -287,7 +298,16 @@ int main(int argc, char const *argv[]) {
       print_hash = true;
     else if (!strcmp(argv[i], "--var"))
       print_var = true;
-    else {
+    else if (!strcmp(argv[i], "--exact"))
+      exact = true;
+    else if (!strcmp(argv[i], "--exact-dir")) {
+      if (++i == argc) {
+        fprintf(stderr, "*** 'simuaiger' error: argument to '--exact-dir' missing\n");
+        exit(1);
+      }
+      exact = true;
+      exact_dir = argv[i];
+    } else {
       fprintf(stderr, "*** 'simuaiger' error: invalid command line option '%s'", argv[i]);
       exit(1);
     }
@@ -319,18 +339,46 @@ int main(int argc, char const *argv[]) {
   btorsim_rng_init(&hrng, hash_seed);
   hvalue.resize(model->maxvar + 1, 0);
 
+  if (exact) {
+    std::vector<uint32_t> widths(model->maxvar + 1, 1);
+    widths[0] = 0;
+    std::string error;
+    if (!signatures.init(widths, std::max(step, 0), exact_dir, error)) {
+      fprintf(stderr, "*** 'simuaiger' error: %s\n", error.c_str());
+      exit(1);
+    }
+  }
+
   preprocessing();
   random_simulation(step);
 
   std::vector<std::pair<uint64_t, uint>> hash_set;
   for (uint i = 1; i <= model->maxvar; ++i) hash_set.emplace_back(hvalue[i], i);
   std::sort(hash_set.begin(), hash_set.end());
+  /* with exact signatures the variables of equal hashes are ordered and
+   * grouped by their simulation vectors */
+  auto same_signature = [&](size_t a, size_t b) {
+    return !exact || !signatures.compare(hash_set[a].second, hash_set[b].second);
+  };
+  if (exact) {
+    int collisions = 0;
+    for (size_t i = 0, j, n = hash_set.size(); i < n; i = j + 1) {
+      for (j = i; j + 1 < n && hash_set[i].first == hash_set[j + 1].first; ++j);
+      std::sort(hash_set.begin() + i, hash_set.begin() + j + 1, [](const auto &x, const auto &y) {
+        int c = signatures.compare(x.second, y.second);
+        return c ? c < 0 : x.second < y.second;
+      });
+      for (size_t k = i; k < j; ++k)
+        if (!same_signature(k, k + 1)) ++collisions;
+    }
+    fprintf(log_file, "[simuaiger] split %d hash collisions by exact signatures\n", collisions);
+  }
 
   int group = 0;
   std::vector<std::pair<int, int>> candidate;
   for (size_t i = 0, n = hash_set.size(); i < n;) {
     size_t j;
-    for (j = i; j + 1 < n && hash_set[i].first == hash_set[j].first; ++j);
+    for (j = i; j + 1 < n && hash_set[i].first == hash_set[j + 1].first && same_signature(i, j + 1); ++j);
 
     if (1 < j - i + 1 && j - i + 1 <= capacity) {
       for (size_t x = i; x <= j; ++x)
@@ -30,7 +30,8 @@ static const char *usage =
     "where <option> is one of the following\n"
     "\n"
     "  -h                      print this command line option summary\n"
-    "  --node [ <n> ... ]      set key node(end with '0')\n"
+    "  --node [ <n> ... ]      set key node(end with '0'), '<n>[<u>:<l>]' selects\n"
+    "                          the bits <u> down to <l> of node <n>\n"
     "  --model <model>         load model from <model> in 'BTOR' format\n"
     "  --output <output>       write eliminated model to <output>\n";
 
@@ -52,24 +53,6 @@ static int64_t num_unreached_bads;
 
 /*------------------------------------------------------------------------*/
 
-static int32_t parse_int(const char *str, int32_t *res_ptr) {
-  const char *p = str;
-  if (!*p) return 0;
-  if (*p == '0' && p[1]) return 0;
-  int32_t res = 0;
-  while (*p) {
-    const int32_t ch = *p++;
-    if (!isdigit(ch)) return 0;
-    if (INT_MAX / 10 < res) return 0;
-    res *= 10;
-    const int32_t digit = ch - '0';
-    if (INT_MAX - digit < res) return 0;
-    res += digit;
-  }
-  *res_ptr = res;
-  return 1;
-}
-
 static void parse_model_line(Btor2Line *l) {
   switch (l->tag) {
     case BTOR2_TAG_bad: {
@@ -243,16 +226,22 @@ static void parse_model() {
 
 /*------------------------------------------------------------------------*/
 
-static void extract(const std::vector<int64_t> &knode) {
+static void extract(const std::vector<NodeRef> &knode) {
   int64_t number_of_lines = btor2parser_max_id(model);
   std::vector<bool> keep(number_of_lines + 1, 0);
 
-  for (int64_t node : knode) {
-    if (node > number_of_lines || node <= 0) {
+  for (const NodeRef &node : knode) {
+    Btor2Line *line = btor2parser_get_line_by_id(model, node.id);
+    if (!line) {
       fprintf(stderr, "*** 'btorextract' error: argument to '--node' out of range\n");
       exit(1);
     }
-    keep[node] = 1;
+    if (node.is_slice() && (line->sort.tag != BTOR2_TAG_SORT_bitvec
+        || node.upper >= line->sort.bitvec.width)) {
+      fprintf(stderr, "*** 'btorextract' error: slice of node %" PRId64 " out of range\n", node.id);
+      exit(1);
+    }
+    keep[node.id] = 1;
   }
 
   transition(model, keep);
@@ -262,7 +251,7 @@ static void extract(const std::vector<int64_t> &knode) {
 
     if (classification(line) != BTOR2_TAG_constraint) keep[i] = 0;
   }
-  for (int64_t node : knode) keep[node] = 1;
+  for (const NodeRef &node : knode) keep[node.id] = 1;
 
   for (int64_t i = number_of_lines; i > 0; --i) {
     Btor2Line *line = btor2parser_get_line_by_id(model, i);
@@ -293,20 +282,24 @@ static void extract(const std::vector<int64_t> &knode) {
 }
 
 int main(int argc, char const *argv[]) {
-  std::vector<int64_t> knode;
+  std::vector<NodeRef> knode;
   for (int i = 1; i < argc; ++i) {
     if (!strcmp(argv[i], "-h")) {
       fputs(usage, stdout);
       exit(1);
     } else if (!strcmp(argv[i], "--node")) {
-      int32_t node = -1;
-      while (node != 0) {
+      NodeRef node;
+      node.id = -1;
+      while (node.id != 0) {
         if (++i == argc) {
           fprintf(stderr, "*** 'btorextract' error: argument to '--node' missing\n");
           exit(1);
         }
-        parse_int(argv[i], &node);
-        if (node != 0) knode.emplace_back(node);
+        if (!parse_node_ref(argv[i], node)) {
+          fprintf(stderr, "*** 'btorextract' error: invalid node in '--node %s'\n", argv[i]);
+          exit(1);
+        }
+        if (node.id != 0) knode.emplace_back(node);
       }
     } else if (!strcmp(argv[i], "--model")) {
       if (++i == argc) {
@@ -344,16 +337,28 @@ int main(int argc, char const *argv[]) {
   }
 
   if (knode.size() > 1) {
+    /* slices of the key nodes are cut out first, each with a sort of its own */
+    std::vector<std::pair<int64_t, int64_t>> key(knode.size());
+    for (size_t i = 0; i < knode.size(); ++i) {
+      Btor2Line *line = btor2parser_get_line_by_id(model, knode[i].id);
+      key[i] = std::make_pair(line->id, line->sort.id);
+      if (!knode[i].is_slice()) continue;
+      int64_t sid = ++line_id;
+      fprintf(output_file, "%" PRId64 " sort bitvec %" PRId64 "\n",
+              sid, knode[i].upper - knode[i].lower + 1);
+      fprintf(output_file, "%" PRId64 " slice %" PRId64 " %" PRId64 " %" PRId64 " %" PRId64 "\n",
+              ++line_id, sid, line->id, knode[i].upper, knode[i].lower);
+      key[i] = std::make_pair(line_id, sid);
+    }
+
     int64_t bid = ++line_id;
     fprintf(output_file, "%" PRId64 " sort bitvec 1\n", bid);
     for (int i = 1; i < (int) knode.size(); ++i) {
-      Btor2Line *prev = btor2parser_get_line_by_id(model, knode[i - 1]),
-          *nw = btor2parser_get_line_by_id(model, knode[i]);
-      int64_t sid = prev->sort.id;
+      int64_t prev = key[i - 1].first, nw = key[i].first, sid = key[i - 1].second;
 
       fprintf(output_file, "%" PRId64 " zero %" PRId64 "\n", ++line_id, sid);
       fprintf(output_file, "%" PRId64 " xor %" PRId64 " %" PRId64 " %" PRId64 "\n",
-              ++line_id, sid, prev->id, nw->id);
+              ++line_id, sid, prev, nw);
 
       ++line_id;
       fprintf(output_file, "%" PRId64 " neq %" PRId64 " %" PRId64 " %" PRId64 "\n",
@@ -12,7 +12,9 @@
 #include <cinttypes>
 
 #include <cassert>
+#include <string>
 #include <vector>
+#include <utility>
 
 #include "btorfunc.h"
 #include "btorsim/btorsimhelpers.h"
@@ -34,7 +36,8 @@ static const char *usage =
     "\n"
     "  -h                      print this command line option summary\n"
     "  --model <model>         load model from <model> in 'BTOR' format\n"
-    "  --list <list>           load merged list from <list>\n"
+    "  --list <list>           load merged list from <list>, a pair may contain\n"
+    "                          slices '<n>[<u>:<l>]' of nodes\n"
     "  --output <output>       write eliminated model to <output>\n";
 
 static Btor2Parser *model;
@@ -265,7 +268,44 @@ struct UnionSet {
   ~UnionSet() {}
 };
 
-void btormerge(UnionSet *union_set) {
+/* of a pair with a slice the node defined later is replaced: a whole node
+ * becomes the slice of the other one, the slices taken from within a slice
+ * are taken from the other node instead */
+static void merge_slice(UnionSet *union_set, NodeRef rep, NodeRef mem) {
+  Btor2Line *lines[2];
+  NodeRef *refs[2] = {&rep, &mem};
+  for (int k = 0; k < 2; ++k) {
+    NodeRef &ref = *refs[k];
+    ref.id = union_set->findset(ref.id);
+    lines[k] = btor2parser_get_line_by_id(model, ref.id);
+    if (!ref.is_slice()) ref.upper = lines[k]->sort.bitvec.width - 1, ref.lower = 0;
+  }
+  if (rep.id > mem.id || (rep.id == mem.id && rep.lower > mem.lower))
+    std::swap(rep, mem), std::swap(lines[0], lines[1]);
+  if (rep.id == mem.id && rep.lower == mem.lower) return;
+
+  Btor2Line *line = lines[1];
+  if (!mem.lower && mem.upper + 1 == line->sort.bitvec.width && rep.id != mem.id) {
+    if (line->tag == BTOR2_TAG_state) {
+      msg(1, "state %" PRId64 " is not merged into a slice", line->id);
+      return;
+    }
+    line->constant = nullptr;
+    line->tag = BTOR2_TAG_slice, line->name = "slice";
+    line->nargs = 1;
+    line->args[0] = rep.id, line->args[1] = rep.upper, line->args[2] = rep.lower;
+    return;
+  }
+  for (int64_t i = mem.id + 1; i <= num_format_lines; ++i) {
+    Btor2Line *l = btor2parser_get_line_by_id(model, i);
+    if (!l || l->tag != BTOR2_TAG_slice || labs(l->args[0]) != mem.id) continue;
+    if (l->args[2] < mem.lower || mem.upper < l->args[1]) continue;
+    l->args[0] = l->args[0] < 0 ? -rep.id : rep.id;
+    l->args[1] += rep.lower - mem.lower, l->args[2] += rep.lower - mem.lower;
+  }
+}
+
+void btormerge(UnionSet *union_set, const std::vector<std::pair<NodeRef, NodeRef>> &slices) {
   for (int64_t i = 1; i <= num_format_lines; ++i) {
     Btor2Line *line = btor2parser_get_line_by_id(model, i);
     if (!line) continue;
@@ -276,6 +316,7 @@ void btormerge(UnionSet *union_set) {
       line->args[j] = arg;
     }
   }
+  for (auto &p : slices) merge_slice(union_set, p.first, p.second);
 
   std::vector<bool> keep(num_format_lines + 1, 0);
   for (int64_t i = 1; i <= num_format_lines; ++i) {
@@ -356,10 +397,25 @@ int main(int argc, char const *argv[]) {
     exit(1);
   }
   UnionSet union_set(num_format_lines + 1);
-  for (int x, y; fin >> x >> y;) union_set.merge(x, y);
+  std::vector<std::pair<NodeRef, NodeRef>> slices;
+  for (std::string x, y; fin >> x >> y;) {
+    NodeRef a, b;
+    if (!parse_node_ref(x.c_str(), a) || !parse_node_ref(y.c_str(), b))
+      die("invalid pair '%s %s' in '%s'", x.c_str(), y.c_str(), list_path);
+    const std::pair<const NodeRef *, const std::string *> refs[2] = {{&a, &x}, {&b, &y}};
+    for (auto &r : refs) {
+      const NodeRef &ref = *r.first;
+      Btor2Line *line = btor2parser_get_line_by_id(model, ref.id);
+      if (!line || (ref.is_slice() && (line->sort.tag != BTOR2_TAG_SORT_bitvec
+          || ref.upper >= line->sort.bitvec.width)))
+        die("node '%s' in '%s' out of range", r.second->c_str(), list_path);
+    }
+    if (a.is_slice() || b.is_slice()) slices.emplace_back(a, b);
+    else union_set.merge(a.id, b.id);
+  }
   fin.close();
 
-  btormerge(&union_set);
+  btormerge(&union_set, slices);
   for (int i = 1; i <= num_format_lines; ++i) {
     Btor2Line *line = btor2parser_get_line_by_id(model, i);
     if (!line) continue;
@@ -6,15 +6,28 @@
 #include <climits>
 #include <cstdlib>
 #include <cstring>
+#include <cstdarg>
 #include <cinttypes>
+#include <dirent.h>
+#include <unistd.h>
 
 #include <map>
-#include <set>
+#include <queue>
+#include <mutex>
+#include <atomic>
+#include <string>
+#include <thread>
 #include <vector>
 #include <cassert>
+#include <chrono>
 #include <algorithm>
+#include <condition_variable>
 
 #include "btorfunc.h"
+#include "btorsim/btorsimbvt.h"
+#include "btorsim/btorsimlane.h"
+#include "btorsim/btorsimsig.h"
+#include "btorsim/btorsimcodegen.h"
 #include "btorsim/btorsimstate.h"
 #include "btorsim/btorsimhelpers.h"
 #include "btor2parser/btor2parser.h"
@@ -38,11 +51,27 @@ static const char *usage =
     "  -h <s>                  random hash seed (default 0)\n"
     "  -c <c>                  set check capacity (default 4)\n"
     "  -r <n>                  generate <n> random transitions (default 10000)\n"
+    "  -l <l>                  simulate <l> patterns at once in lane-parallel mode\n"
+    "  -t <t>                  split the transitions over <t> threads\n"
+    "  --stress <n>            simulate all transitions on <n> threads at once, one\n"
+    "                          simulator each, and check that they agree\n"
+    "  --flip <f>              redraw only <f> inputs per transition and re-evaluate\n"
+    "                          the nodes they affect (event-driven)\n"
     "\n"
     "  --help                  print this command line option summary\n"
     "  --states                print state's bitvec to log\n"
     "  --hash                  print state's hash value to log\n"
+    "  --poly-hash             hash bit by bit with the former polynomial scheme\n"
+    "  --native                compile the model to native code (implies '-l 64')\n"
+    "  --cache <dir>           cache compiled models in <dir> (default '~/.cache/simubtor')\n"
     "  --check-all             check all node's equivalence(default 'state only')\n"
+    "  --slices <w>            with '--check-all' also compare the <w>-bit slices\n"
+    "                          of wider nodes, reported as '<n>[<u>:<l>]'\n"
+    "  --bound <b>             simulate the sequential model for frames 0 to <b>\n"
+    "                          and report the nodes as 'btorexpand -e <b>' numbers them\n"
+    "  --exact                 also keep the simulation vectors and split the classes\n"
+    "                          of equal hashes by them (no hash collisions)\n"
+    "  --exact-dir <dir>       same as '--exact' with the vectors in a file in <dir>\n"
     "\n"
     "  --model <model>         load model from <model> in 'BTOR' format\n"
     "  --output <output>       write result to <output>\n"
@@ -67,13 +96,235 @@ static int64_t num_unreached_bads;
 static bool all_hash = false;
 static bool print_hash = false;
 static bool print_states = false;
-static std::vector<BtorSimState> current_state;
+static bool poly_hash = false;
 
-static BtorSimRNG rng, base_rng;
+static uint32_t threads;
+static uint32_t stress;
+static double hash_time;
 static std::vector<BtorSimBitVector *> fixed_input;
+
+/* unsigned interval an input of at most 64 bits is sampled from, derived
+ * from the comparisons with constants the constraints imply */
+struct InputRange {
+  bool restricted = false;
+  uint64_t lo = 0, hi = 0;
+};
+static std::vector<InputRange> input_range;
 static std::vector<std::pair<uint64_t, uint64_t>> hash_value;
 static std::vector<std::pair<Btor2Line *, std::pair<int, int>>> parse_states;
 
+/* engine of every node in lane-parallel mode, see 'Simulator' */
+enum LaneKind { LANE_NONE, LANE_WORD, LANE_LIMBS, LANE_WIDE };
+
+/* kernel of a node evaluated in the width class of its widest operand,
+ * see 'select_limb_kernel' */
+typedef void (*LaneLimbKernel)(Btor2Line *l, uint64_t *res, const uint64_t *const *args, uint32_t n);
+
+static uint32_t lanes;
+static std::vector<char> lane_kind;
+static std::vector<bool> lane_kernel;
+static std::vector<LaneLimbKernel> lane_limb_kernel;
+static std::vector<int64_t> lane_order;
+
+/* the nodes evaluated in every step: all with '--check-all', otherwise the
+ * cone of influence of the hashed states, constraints, bads and inputs */
+static std::vector<char> in_cone;
+static std::vector<int64_t> cone;
+
+/* '--flip <f>': after the first pattern of a block every step redraws only
+ * 'flips' of the free inputs and states ('event_leaves') and re-evaluates
+ * the nodes they reach through 'fanout' in topological order ('event_rank')
+ * as long as their values change, see 'Simulator::event_simulation' */
+static uint32_t flips;
+static std::vector<int64_t> event_leaves;
+static std::vector<int64_t> event_rank;
+static std::vector<int64_t> fanout_start, fanout;
+
+/* '--exact': the value of every reported node in every step is also kept
+ * in 'signatures', indexed by the number of the step, and nodes with equal
+ * hashes are only grouped if their simulation vectors are equal too */
+static bool exact = false;
+static const char *exact_dir;
+static BtorSimSignatures signatures;
+
+static bool native = false;
+static const char *cache_dir;
+static BtorSimCompiledModel compiled_model;
+
+/* sequential mode: every transition simulates the original model for the
+ * frames 0 to 'bound', applying the next functions in between.  The value
+ * of node 'i' in frame 't' is hashed under the id 'expand_id[t][i]' the
+ * node has in the model unrolled by 'btorexpand -e <bound>' (0 if the node
+ * does not appear there again, e.g. constants after the first frame), and
+ * 'expand_zero' lists the zeros btorexpand adds for every bit-vector sort */
+static int64_t bound = -1;
+static std::vector<std::vector<int64_t>> expand_id;
+static std::vector<std::pair<int64_t, uint32_t>> expand_zero;
+static int64_t num_hash_ids;
+/* 'expand_symbol[i]' is the symbol btorexpand gives to 'parse_states[i]' */
+static std::vector<std::string> expand_symbol;
+
+/* '--slices <w>': every hashed bit-vector wider than 'slice_width' is cut
+ * into slices of 'slice_width' bits from the LSB on (the topmost one may be
+ * narrower), slice 'j' of hash id 'i' gets the signature of its own hash id
+ * 'slice_base[i] + j', all of them from 'first_slice_id' on */
+static uint32_t slice_width;
+static int64_t first_slice_id;
+static std::vector<int64_t> slice_base;
+static std::vector<int64_t> slice_parent;
+static std::vector<uint32_t> hash_width;
+static std::vector<std::pair<int64_t, int64_t>> hash_node;
+
+/*------------------------------------------------------------------------*/
+
+/* log of one simulator, written straight to 'file' if set, otherwise
+ * buffered together with the positions of the numbers of the successful
+ * steps, so that a block simulated by a worker thread can be renumbered
+ * once all preceding blocks are known */
+struct LogBuffer {
+  FILE *file = nullptr;
+  std::string text;
+  std::vector<std::pair<size_t, int64_t>> numbers;
+
+  void print(const char *fmt, ...) {
+    va_list ap;
+    va_start(ap, fmt);
+    if (file)
+      vfprintf(file, fmt, ap);
+    else {
+      va_list aq;
+      va_copy(aq, ap);
+      size_t old = text.size();
+      int n = vsnprintf(nullptr, 0, fmt, aq);
+      va_end(aq);
+      text.resize(old + n + 1);
+      vsnprintf(&text[old], n + 1, fmt, ap);
+      text.resize(old + n);
+    }
+    va_end(ap);
+  }
+  void put(char ch) {
+    if (file) fputc(ch, file);
+    else text.push_back(ch);
+  }
+  void number(int64_t n) {
+    if (file) fprintf(file, "%" PRId64, n);
+    else numbers.emplace_back(text.size(), n);
+  }
+  /* move the contents of 'other', which has to be buffered, to the end */
+  void append(LogBuffer &other) {
+    assert (!other.file);
+    if (file) {
+      other.flush(file, 0);
+      return;
+    }
+    for (auto &e : other.numbers) numbers.emplace_back(text.size() + e.first, e.second);
+    text += other.text;
+    std::string().swap(other.text);
+    std::vector<std::pair<size_t, int64_t>>().swap(other.numbers);
+  }
+  void flush(FILE *out, int64_t offset) {
+    size_t pos = 0;
+    for (auto &e : numbers) {
+      fwrite(text.data() + pos, 1, e.first - pos, out);
+      fprintf(out, "%" PRId64, e.second + offset);
+      pos = e.first;
+    }
+    fwrite(text.data() + pos, 1, text.size() - pos, out);
+    std::string().swap(text);
+    std::vector<std::pair<size_t, int64_t>>().swap(numbers);
+  }
+};
+
+/* all mutable state of a simulation run, the model and the tables above
+ * are shared read-only, so every worker thread owns one instance */
+struct Simulator {
+  std::vector<BtorSimState> current_state;
+  std::vector<std::pair<uint64_t, uint64_t>> hash_value;
+  std::vector<int64_t> reached_bads;
+  int64_t num_unreached_bads;
+  bool stop_at_bads = true;
+
+  BtorSimRNG rng, base_rng;
+  int64_t succ = 0;
+  LogBuffer log;
+  double hash_time = 0;
+  /* if set, every hash added to 'hash_value' is recorded */
+  std::vector<std::tuple<int64_t, uint64_t, uint64_t>> *hash_trail = nullptr;
+  /* the step the hashed values belong to, see 'exact' */
+  int64_t hash_step = 0;
+  std::vector<uint64_t> exact_words;
+
+  /* event-driven mode: the value of a node is hashed once it changes,
+   * weighted with the sum of the step keys since its last change */
+  std::vector<std::pair<uint64_t, uint64_t>> event_since;
+  std::pair<uint64_t, uint64_t> event_sum, event_weight;
+  uint64_t event_key1, event_key2;
+  std::vector<char> event_queued;
+
+  /* lane-parallel engine: 'lane_word' keeps <lanes> patterns of a node of
+   * width <= 64 contiguously and those of a node of width <= 256 as the
+   * words of a 'BtorSimBV' one pattern after the other, wider nodes fall
+   * back to one bit-vector per pattern in 'lane_wide', which are stored in
+   * the words of 'lane_word' as well */
+  std::vector<std::vector<uint64_t>> lane_word;
+  std::vector<std::vector<BtorSimBitVector *>> lane_wide;
+  std::vector<uint64_t> lane_tmp[3];
+  std::vector<uint64_t *> lane_ptr;
+  /* the fallback unpacks operands and results of narrower nodes into the
+   * bit-vectors in 'lane_bv_mem' and divides in 'lane_div_scratch', such
+   * that a step does not allocate */
+  std::vector<uint64_t> lane_bv_mem[4];
+  std::vector<BTORSIM_BV_TYPE> lane_div_scratch;
+
+  Simulator();
+  ~Simulator();
+  void seed(uint32_t s, uint32_t hash_seed);
+
+  void update_current_state(int64_t id, BtorSimBitVector *bv);
+  void update_current_state(int64_t id, BtorSimArrayModel *am);
+  void update_current_state(int64_t id, BtorSimState &s);
+  void delete_current_state(int64_t id);
+  BtorSimState simulate(int64_t id);
+
+  void print_state_or_input(int64_t id, int64_t pos, int64_t step, bool is_input, const char *symbol);
+  void initialize_states(int32_t randomly);
+  void initialize_inputs(int64_t k, int32_t randomize);
+  bool simulate_step(int64_t k);
+  bool check_step(int64_t k);
+  bool run_step(int64_t k, int32_t randomize);
+  void reset_state();
+  void draw_keys(uint64_t &key1, uint64_t &key2);
+  void add_hash(int64_t id, uint64_t h1, uint64_t h2);
+  void hash_word(int64_t id, uint64_t value, uint32_t width, uint64_t key1, uint64_t key2);
+  void hash_bv(int64_t id, const BtorSimBitVector *bv, uint64_t key1, uint64_t key2);
+  void hash_limbs(int64_t id, const uint64_t *words, uint32_t width, uint64_t key1, uint64_t key2);
+  void record(int64_t id, const uint64_t *words, uint32_t width);
+  void print_pattern();
+  void scalar_simulation(int64_t first, int64_t last);
+
+  void event_flush(int64_t id);
+  void event_draw(Btor2Line *leaf);
+  bool event_step(int64_t k);
+  void event_simulation(int64_t first, int64_t last);
+
+  bool run_frames(int64_t k, uint64_t key1, uint64_t key2);
+  void sequential_simulation(int64_t first, int64_t last);
+
+  const uint64_t *lane_arg(int64_t id, uint32_t n, std::vector<uint64_t> &tmp);
+  BtorSimBitVector *lane_bv(uint32_t k, uint32_t width);
+  const BtorSimBitVector *lane_get_bv(int64_t id, uint32_t p, uint32_t k);
+  void lane_set_bv(int64_t id, uint32_t p, const BtorSimBitVector *bv);
+  uint64_t lane_random_word(uint32_t width);
+  uint64_t random_input_word(Btor2Line *input);
+  void lane_kernel_step(Btor2Line *l, uint32_t n);
+  void simulate_lanes(uint32_t n);
+  uint32_t lane_get_bit(int64_t id, uint32_t p, uint32_t pos);
+  bool lane_check(uint32_t p, int64_t k);
+  void print_lane(int64_t id, int64_t pos, int64_t step, uint32_t p, bool is_input);
+  void lane_simulation(int64_t first, int64_t last);
+};
+
 /*------------------------------------------------------------------------*/
 
 static int32_t parse_int(const char *str, int32_t *res_ptr) {
@@ -251,8 +502,8 @@ static void parse_model() {
   if (!btor2parser_read_lines(model, model_file))
     die("parse error in '%s' at %s", model_path, btor2parser_error(model));
   num_format_lines = btor2parser_max_id(model);
-  inits.resize(num_format_lines, nullptr);
-  nexts.resize(num_format_lines, nullptr);
+  inits.resize(num_format_lines + 1, nullptr);
+  nexts.resize(num_format_lines + 1, nullptr);
   Btor2LineIterator it = btor2parser_iter_init(model);
   Btor2Line *line;
   while ((line = btor2parser_iter_next(&it))) parse_model_line(line);
@@ -265,33 +516,40 @@ static void parse_model() {
   }
 }
 
-static void update_current_state(int64_t id, BtorSimBitVector *bv) {
-  assert (0 <= id), assert (id < num_format_lines);
+static bool is_evaluated(Btor2Line *l) {
+  return !(l->tag == BTOR2_TAG_sort || l->tag == BTOR2_TAG_init
+      || l->tag == BTOR2_TAG_next || l->tag == BTOR2_TAG_bad
+      || l->tag == BTOR2_TAG_constraint || l->tag == BTOR2_TAG_fair
+      || l->tag == BTOR2_TAG_justice || l->tag == BTOR2_TAG_output);
+}
+
+void Simulator::update_current_state(int64_t id, BtorSimBitVector *bv) {
+  assert (0 <= id), assert (id <= num_format_lines);
   msg(5, "updating state %" PRId64, id);
   current_state[id].update(bv);
 }
 
-static void update_current_state(int64_t id, BtorSimArrayModel *am) {
-  assert (0 <= id), assert (id < num_format_lines);
+void Simulator::update_current_state(int64_t id, BtorSimArrayModel *am) {
+  assert (0 <= id), assert (id <= num_format_lines);
   msg(5, "updating state %" PRId64, id);
   current_state[id].update(am);
 }
 
-static void update_current_state(int64_t id, BtorSimState &s) {
-  assert (0 <= id), assert (id < num_format_lines);
+void Simulator::update_current_state(int64_t id, BtorSimState &s) {
+  assert (0 <= id), assert (id <= num_format_lines);
   msg(5, "updating state %" PRId64, id);
   current_state[id].update(s);
 }
 
-static void delete_current_state(int64_t id) {
-  assert (0 <= id), assert (id < num_format_lines);
+void Simulator::delete_current_state(int64_t id) {
+  assert (0 <= id), assert (id <= num_format_lines);
   if (current_state[id].type) current_state[id].remove();
 }
 
-static BtorSimState simulate(int64_t id) {
+BtorSimState Simulator::simulate(int64_t id) {
   int32_t sign = id < 0 ? -1 : 1;
   if (sign < 0) id = -id;
-  assert (0 <= id), assert (id < num_format_lines);
+  assert (0 <= id), assert (id <= num_format_lines);
   BtorSimState res = current_state[id];
   if (!res.is_set()) {
     Btor2Line *l = btor2parser_get_line_by_id(model, id);
@@ -635,32 +893,26 @@ static BtorSimState simulate(int64_t id) {
 
 /*------------------------------------------------------------------------*/
 
-static void setup_states() {
-  current_state.resize(num_format_lines);
-  hash_value.resize(num_format_lines, std::make_pair(0ull, 0ull));
-  for (int i = 0; i < num_format_lines; i++) {
-    Btor2Line *l = btor2parser_get_line_by_id(model, i);
-    if (l) {
-      Btor2Sort *sort = get_sort(l, model);
-      switch (sort->tag) {
-        case BTOR2_TAG_SORT_bitvec:current_state[i].type = BtorSimState::Type::BITVEC;
-          break;
-        case BTOR2_TAG_SORT_array:current_state[i].type = BtorSimState::Type::ARRAY;
-          break;
-        default:die("Unknown sort");
-      }
-    }
-  }
-  for (auto state : states) {
-    assert (current_state[state->id].type != BtorSimState::Type::INVALID);
-  }
+/* whether node 'i' is a simulated bit-vector carrying a hash value */
+static bool has_hash(int64_t i) {
+  Btor2Line *l = btor2parser_get_line_by_id(model, i);
+  return l && is_evaluated(l) && l->sort.tag == BTOR2_TAG_SORT_bitvec;
 }
 
 static void print_all_hash(int64_t step) {
+  if (bound >= 0) {
+    for (int64_t t = 0; t <= bound; ++t)
+      for (int64_t i = 1; i <= num_format_lines; ++i) {
+        int64_t id = expand_id[t][i];
+        if (!id || !has_hash(i)) continue;
+        fprintf(log_file, "%" PRId64 " id_%" PRId64 ".time_%" PRId64 " %lX,%lX\n",
+                id, i, t, hash_value[id].first, hash_value[id].second);
+      }
+    return;
+  }
   for (int64_t i = 1; i <= num_format_lines; ++i) {
     Btor2Line *line = btor2parser_get_line_by_id(model, i);
-    BtorSimBitVector *bv = current_state[i].bv_state;
-    if (!bv) continue;
+    if (!has_hash(i)) continue;
 
     fprintf(log_file, "%" PRId64 "", i);
     if (line->symbol) fprintf(log_file, " %s", line->symbol);
@@ -668,28 +920,31 @@ static void print_all_hash(int64_t step) {
   }
 }
 
-static void print_state_or_input(int64_t id, int64_t pos, int64_t step, bool is_input) {
-  auto print_bv = [](const BtorSimBitVector *bv) {
+void Simulator::print_state_or_input(int64_t id, int64_t pos, int64_t step, bool is_input, const char *symbol) {
+  auto print_bv = [this](const BtorSimBitVector *bv) {
     assert (bv);
     for (int i = bv->width - 1; i >= 0; --i)
-      fprintf(log_file, "%d", btorsim_bv_get_bit(bv, i));
+      log.put('0' + btorsim_bv_get_bit(bv, i));
   };
 
-  Btor2Line *l = btor2parser_get_line_by_id(model, id);
   switch (current_state[id].type) {
-    case BtorSimState::Type::BITVEC:fprintf(log_file, "%" PRId64 " ", pos);
+    case BtorSimState::Type::BITVEC:log.print("%" PRId64 " ", pos);
       print_bv(current_state[id].bv_state);
-      if (l->symbol)
-        fprintf(log_file, " %s%s%" PRId64, l->symbol, is_input ? "@" : "#", step);
-      fputc('\n', log_file);
+      if (symbol) {
+        log.print(" %s%s", symbol, is_input ? "@" : "#");
+        log.number(step);
+      }
+      log.put('\n');
       break;
     case BtorSimState::Type::ARRAY:
-      for (auto e : current_state[id].array_state->data) {
-        fprintf(log_file, "%" PRId64 " [%s]", pos, e.first.c_str());
+      for (auto e : current_state[id].array_state->data()) {
+        log.print("%" PRId64 " [%s]", pos, e.first.c_str());
         print_bv(e.second);
-        if (l->symbol)
-          fprintf(log_file, " %s%s%" PRId64, l->symbol, is_input ? "@" : "#", step);
-        fputc('\n', log_file);
+        if (symbol) {
+          log.print(" %s%s", symbol, is_input ? "@" : "#");
+          log.number(step);
+        }
+        log.put('\n');
       }
       break;
     default:die("uninitialized current_state %" PRId64, id);
@@ -708,10 +963,10 @@ static void report() {
     fprintf(log_file, "[simubtor] no bad state property reached\n");
 }
 
-static void initialize_states(int32_t randomly) {
+void Simulator::initialize_states(int32_t randomly) {
   for (size_t i = 0; i < states.size(); i++) {
     Btor2Line *state = states[i];
-    assert (0 <= state->id), assert (state->id < num_format_lines);
+    assert (0 <= state->id), assert (state->id <= num_format_lines);
     Btor2Line *init = inits[state->id];
     switch (current_state[state->id].type) {
       case BtorSimState::Type::BITVEC: {
@@ -775,14 +1030,16 @@ static void initialize_states(int32_t randomly) {
   }
 }
 
-static void initialize_inputs(int64_t k, int32_t randomize) {
+void Simulator::initialize_inputs(int64_t k, int32_t randomize) {
   for (size_t i = 0; i < inputs.size(); i++) {
     Btor2Line *input = inputs[i];
     if (input->sort.tag == BTOR2_TAG_SORT_bitvec) {
       uint32_t width = input->sort.bitvec.width;
       BtorSimBitVector *update;
       if (!input->next) {
-        if (randomize)
+        if (randomize && input_range[input->id].restricted)
+          update = btorsim_bv_uint64_to_bv(random_input_word(input), width);
+        else if (randomize)
           update = btorsim_bv_new_random(&rng, width);
         else
           update = btorsim_bv_new(width);
@@ -808,27 +1065,24 @@ static void initialize_inputs(int64_t k, int32_t randomize) {
   }
 }
 
-static bool simulate_step(int64_t k) {
+bool Simulator::simulate_step(int64_t k) {
   msg(1, "simulating step %" PRId64, k);
-  for (int64_t i = 0; i < num_format_lines; i++) {
-    Btor2Line *l = btor2parser_get_line_by_id(model, i);
-    if (!l) continue;
-    if (l->tag == BTOR2_TAG_sort || l->tag == BTOR2_TAG_init
-        || l->tag == BTOR2_TAG_next || l->tag == BTOR2_TAG_bad
-        || l->tag == BTOR2_TAG_constraint || l->tag == BTOR2_TAG_fair
-        || l->tag == BTOR2_TAG_justice || l->tag == BTOR2_TAG_output)
-      continue;
-
+  for (int64_t i : cone) {
     BtorSimState s = simulate(i);
     s.remove();
   }
+  return check_step(k);
+}
 
+/* check the constraints and bads on the values of step 'k' */
+bool Simulator::check_step(int64_t k) {
   if (!k) return 0;
   for (size_t i = 0; i < constraints.size(); i++) {
     Btor2Line *constraint = constraints[i];
-    BtorSimState s = current_state[constraint->args[0]];
+    int64_t id = constraint->args[0];
+    BtorSimState s = current_state[labs(id)];
     assert (s.type == BtorSimState::Type::BITVEC);
-    if (!btorsim_bv_is_zero(s.bv_state)) continue;
+    if (btorsim_bv_is_zero(s.bv_state) == (id < 0)) continue;
     return 0;
   }
 
@@ -836,9 +1090,10 @@ static bool simulate_step(int64_t k) {
     int64_t r = reached_bads[i];
     if (r >= 0) continue;
     Btor2Line *bad = bads[i];
-    BtorSimState s = current_state[bad->args[0]];
+    int64_t id = bad->args[0];
+    BtorSimState s = current_state[labs(id)];
     assert (s.type == BtorSimState::Type::BITVEC);
-    if (btorsim_bv_is_zero(s.bv_state)) continue;
+    if (btorsim_bv_is_zero(s.bv_state) != (id < 0)) continue;
     int64_t bound = reached_bads[i];
     if (bound >= 0) continue;
     reached_bads[i] = k;
@@ -851,124 +1106,1703 @@ static bool simulate_step(int64_t k) {
   return 1;
 }
 
-static void random_simulation(int64_t k) {
-  auto run_step = [](int64_t k, int32_t randomize) {
-    initialize_states(randomize);
-    initialize_inputs(k, randomize);
-    return simulate_step(k);
-  };
-  auto reset_state = []() {
-    for (int64_t i = 1; i <= num_format_lines; i++) {
-      Btor2Line *l = btor2parser_get_line_by_id(model, i);
-      if (!l) continue;
-      if (l->tag == BTOR2_TAG_sort || l->tag == BTOR2_TAG_init
-          || l->tag == BTOR2_TAG_next || l->tag == BTOR2_TAG_bad
-          || l->tag == BTOR2_TAG_constraint || l->tag == BTOR2_TAG_fair
-          || l->tag == BTOR2_TAG_justice || l->tag == BTOR2_TAG_output)
-        continue;
-//      current_state[i].remove();
-      current_state[i].bv_state = nullptr;
+static uint32_t lane_width(int64_t id) {
+  Btor2Line *l = btor2parser_get_line_by_id(model, labs(id));
+  return l->sort.bitvec.width;
+}
+
+/* words per pattern of a node in 'lane_word' */
+static uint32_t lane_stride(int64_t id) {
+  return lane_kind[labs(id)] == LANE_LIMBS ? btorsim_bvt_words(lane_width(id)) : 1;
+}
+
+static bool has_lane_op(Btor2Line *l) {
+  switch (l->tag) {
+    case BTOR2_TAG_add:
+    case BTOR2_TAG_and:
+    case BTOR2_TAG_concat:
+    case BTOR2_TAG_dec:
+    case BTOR2_TAG_eq:
+    case BTOR2_TAG_implies:
+    case BTOR2_TAG_inc:
+    case BTOR2_TAG_ite:
+    case BTOR2_TAG_mul:
+    case BTOR2_TAG_nand:
+    case BTOR2_TAG_neg:
+    case BTOR2_TAG_neq:
+    case BTOR2_TAG_nor:
+    case BTOR2_TAG_not:
+    case BTOR2_TAG_or:
+    case BTOR2_TAG_redand:
+    case BTOR2_TAG_redor:
+    case BTOR2_TAG_redxor:
+    case BTOR2_TAG_sdiv:
+    case BTOR2_TAG_sext:
+    case BTOR2_TAG_sgt:
+    case BTOR2_TAG_sgte:
+    case BTOR2_TAG_slice:
+    case BTOR2_TAG_sll:
+    case BTOR2_TAG_slt:
+    case BTOR2_TAG_slte:
+    case BTOR2_TAG_sra:
+    case BTOR2_TAG_srem:
+    case BTOR2_TAG_srl:
+    case BTOR2_TAG_sub:
+    case BTOR2_TAG_udiv:
+    case BTOR2_TAG_uext:
+    case BTOR2_TAG_ugt:
+    case BTOR2_TAG_ugte:
+    case BTOR2_TAG_ult:
+    case BTOR2_TAG_ulte:
+    case BTOR2_TAG_urem:
+    case BTOR2_TAG_iff:
+    case BTOR2_TAG_xnor:
+    case BTOR2_TAG_xor:return true;
+    default:return false;
+  }
+}
+
+static bool has_lane_kernel(Btor2Line *l) {
+  if (!has_lane_op(l)) return false;
+  for (uint32_t i = 0; i < l->nargs; ++i)
+    if (lane_kind[labs(l->args[i])] != LANE_WORD) return false;
+  return lane_kind[l->id] == LANE_WORD;
+}
+
+/* lanes of a word argument, negated into 'tmp' if 'id' is negative */
+const uint64_t *Simulator::lane_arg(int64_t id, uint32_t n, std::vector<uint64_t> &tmp) {
+  const uint64_t *a = lane_word[labs(id)].data();
+  if (id > 0) return a;
+  const uint32_t stride = lane_stride(id), width = lane_width(id);
+  tmp.resize(lanes * stride);
+  if (stride == 1) {
+    btorsim_lane_not(tmp.data(), a, n, width);
+    return tmp.data();
+  }
+  for (uint32_t p = 0; p < n; ++p)
+    for (uint32_t k = 0, lo = 0; k < stride; ++k, lo += 64) {
+      uint64_t v = ~a[p * stride + k];
+      tmp[p * stride + k] = width <= lo ? 0 : v & btorsim_lane_mask(std::min(width - lo, 64u));
     }
-  };
+  return tmp.data();
+}
 
-  int64_t succ = 0;
-  run_step(0, 1);
-  std::vector<short> cons(num_format_lines + 1, 0);
-  for (int64_t i = num_format_lines; i > 0; --i) {
-    Btor2Line *line = btor2parser_get_line_by_id(model, i);
-    if (!line) continue;
+/* the 'k'-th bit-vector of 'lane_bv_mem', 3 is for results */
+BtorSimBitVector *Simulator::lane_bv(uint32_t k, uint32_t width) {
+  return btorsim_bv_init(lane_bv_mem[k].data(), width);
+}
 
-    if (line->tag == BTOR2_TAG_constraint)
-      cons[line->args[0]] = 1;
-    else if (line->tag == BTOR2_TAG_and) {
-      if (cons[i] <= 0) continue;
-      for (int64_t j = 0; j < line->nargs; ++j) {
-        int id = labs(line->args[j]);
-        if (line->args[j] < 0) cons[id] = -1;
-        else cons[id] = 1;
-      }
-    } else if (line->tag == BTOR2_TAG_or) {
-      if (cons[i] >= 0) continue;
-      for (int64_t j = 0; j < line->nargs; ++j) {
-        int id = labs(line->args[j]);
-        if (line->args[j] < 0) cons[id] = 1;
-        else cons[id] = -1;
-      }
-    } else if (line->tag == BTOR2_TAG_eq) {
-      if (cons[i] <= 0) continue;
-      int p = line->args[0], q = line->args[1];
-      Btor2Line *model_p = btor2parser_get_line_by_id(model, p),
-          *model_q = btor2parser_get_line_by_id(model, q);
+/* pattern 'p' of a node, unpacked into the 'k'-th bit-vector unless it is
+ * a wide one which is not negated */
+const BtorSimBitVector *Simulator::lane_get_bv(int64_t id, uint32_t p, uint32_t k) {
+  int64_t i = labs(id);
+  BtorSimBitVector *res;
+  if (lane_kind[i] == LANE_WIDE) {
+    if (id > 0) return lane_wide[i][p];
+    res = lane_bv(k, lane_width(i));
+    btorsim_bv_not_into(res, lane_wide[i][p]);
+    return res;
+  }
+  res = lane_bv(k, lane_width(i));
+  if (lane_kind[i] == LANE_WORD)
+    btorsim_bv_uint64_into(res, lane_word[i][p]);
+  else
+    btorsim_bv_words_into(res, lane_word[i].data() + p * lane_stride(i));
+  if (id < 0) btorsim_bv_not_into(res, res);
+  return res;
+}
 
-      if (model_q->tag == BTOR2_TAG_input) {
-        std::swap(p, q);
-        std::swap(model_p, model_q);
-      }
-      if (model_p->tag != BTOR2_TAG_input || model_q->tag == BTOR2_TAG_input) continue;
+void Simulator::lane_set_bv(int64_t id, uint32_t p, const BtorSimBitVector *bv) {
+  if (lane_kind[id] == LANE_WORD)
+    lane_word[id][p] = btorsim_bv_to_uint64(bv);
+  else if (lane_kind[id] == LANE_LIMBS)
+    btorsim_bv_to_words(bv, lane_word[id].data() + p * lane_stride(id));
+  else {
+    assert (lane_kind[id] == LANE_WIDE);
+    if (bv != lane_wide[id][p]) btorsim_bv_copy_into(lane_wide[id][p], bv);
+  }
+}
 
-      if (p < 0) p = -p, q = -q;
-      model_p->next = fixed_input.size();
+uint64_t Simulator::lane_random_word(uint32_t width) {
+  uint64_t v = btorsim_rng_rand(&rng);
+  if (width > 32) v = v << 32 | btorsim_rng_rand(&rng);
+  return v & btorsim_lane_mask(width);
+}
 
-      BtorSimBitVector *bv = btorsim_bv_copy(current_state[model_q->id].bv_state);
-      fixed_input.push_back(bv);
-      if (q < 0) {
-        for (uint32_t j = bv->width - 1; j >= 0; --j)
-          bv->bits[j] ^= 1;
-      }
+/* random value of a free input, within its range if it has one */
+uint64_t Simulator::random_input_word(Btor2Line *input) {
+  const InputRange &r = input_range[input->id];
+  if (!r.restricted) return lane_random_word(input->sort.bitvec.width);
+  uint64_t v = (uint64_t) btorsim_rng_rand(&rng) << 32 | btorsim_rng_rand(&rng);
+  uint64_t span = r.hi - r.lo;
+  return span == ~0ull ? v : r.lo + v % (span + 1);
+}
 
-      fprintf(log_file, "[simubtor] parse constraints: %s must equal to ", model_p->symbol);
-      for (int j = bv->width - 1; j >= 0; --j)
-        fprintf(log_file, "%d", btorsim_bv_get_bit(bv, j));
-      fprintf(log_file, "\n");
-    }
+/* the value of a constant node */
+static BtorSimBitVector *lane_const(Btor2Line *l) {
+  switch (l->tag) {
+    case BTOR2_TAG_const:return btorsim_bv_char_to_bv(l->constant);
+    case BTOR2_TAG_constd:return btorsim_bv_constd(l->constant, l->sort.bitvec.width);
+    case BTOR2_TAG_consth:return btorsim_bv_consth(l->constant, l->sort.bitvec.width);
+    case BTOR2_TAG_one:return btorsim_bv_one(l->sort.bitvec.width);
+    case BTOR2_TAG_ones:return btorsim_bv_ones(l->sort.bitvec.width);
+    default:assert (l->tag == BTOR2_TAG_zero);
+      return btorsim_bv_zero(l->sort.bitvec.width);
   }
-  reset_state();
+}
 
-  for (int64_t step = 1; step <= k; ++step) {
-    if (!num_unreached_bads) break;
-    uint32_t base1 = btorsim_rng_rand(&base_rng), base2 = btorsim_rng_rand(&base_rng);
-    if (run_step(step, 1)) {
-      ++succ;
-      fprintf(log_file, "[simubtor] constraints satisfied at time %" PRId64 "\n", step);
-      for (size_t i = 1; i <= num_format_lines; ++i) {
-        if (current_state[i].type != BtorSimState::BITVEC) continue;
-        BtorSimBitVector *bv = current_state[i].bv_state;
-        if (!bv) continue;
+/* evaluate one pattern of a node into 'r' with the generic bit-vector
+ * operators, 'scratch' holds the limbs of the division and remainder */
+static void lane_fallback(Btor2Line *l,
+                          BtorSimBitVector *r,
+                          const BtorSimBitVector **a,
+                          BTORSIM_BV_TYPE *scratch) {
+  switch (l->tag) {
+    case BTOR2_TAG_add:btorsim_bv_add_into(r, a[0], a[1]);
+      break;
+    case BTOR2_TAG_and:btorsim_bv_and_into(r, a[0], a[1]);
+      break;
+    case BTOR2_TAG_concat:btorsim_bv_concat_into(r, a[0], a[1]);
+      break;
+    case BTOR2_TAG_dec:btorsim_bv_dec_into(r, a[0]);
+      break;
+    case BTOR2_TAG_eq:btorsim_bv_eq_into(r, a[0], a[1]);
+      break;
+    case BTOR2_TAG_implies:btorsim_bv_implies_into(r, a[0], a[1]);
+      break;
+    case BTOR2_TAG_inc:btorsim_bv_inc_into(r, a[0]);
+      break;
+    case BTOR2_TAG_ite:btorsim_bv_ite_into(r, a[0], a[1], a[2]);
+      break;
+    case BTOR2_TAG_mul:btorsim_bv_mul_into(r, a[0], a[1]);
+      break;
+    case BTOR2_TAG_nand:btorsim_bv_nand_into(r, a[0], a[1]);
+      break;
+    case BTOR2_TAG_neg:btorsim_bv_neg_into(r, a[0]);
+      break;
+    case BTOR2_TAG_neq:btorsim_bv_neq_into(r, a[0], a[1]);
+      break;
+    case BTOR2_TAG_nor:btorsim_bv_nor_into(r, a[0], a[1]);
+      break;
+    case BTOR2_TAG_not:btorsim_bv_not_into(r, a[0]);
+      break;
+    case BTOR2_TAG_or:btorsim_bv_or_into(r, a[0], a[1]);
+      break;
+    case BTOR2_TAG_redand:btorsim_bv_redand_into(r, a[0]);
+      break;
+    case BTOR2_TAG_redor:btorsim_bv_redor_into(r, a[0]);
+      break;
+    case BTOR2_TAG_redxor:btorsim_bv_redxor_into(r, a[0]);
+      break;
+    case BTOR2_TAG_slice:btorsim_bv_slice_into(r, a[0], l->args[1], l->args[2]);
+      break;
+    case BTOR2_TAG_sub:btorsim_bv_sub_into(r, a[0], a[1]);
+      break;
+    case BTOR2_TAG_uext:btorsim_bv_uext_into(r, a[0]);
+      break;
+    case BTOR2_TAG_sext:btorsim_bv_sext_into(r, a[0]);
+      break;
+    case BTOR2_TAG_udiv:btorsim_bv_udiv_into(r, a[0], a[1], scratch);
+      break;
+    case BTOR2_TAG_sdiv:btorsim_bv_sdiv_into(r, a[0], a[1], scratch);
+      break;
+    case BTOR2_TAG_sll:btorsim_bv_sll_into(r, a[0], a[1]);
+      break;
+    case BTOR2_TAG_srl:btorsim_bv_srl_into(r, a[0], a[1]);
+      break;
+    case BTOR2_TAG_sra:btorsim_bv_sra_into(r, a[0], a[1]);
+      break;
+    case BTOR2_TAG_srem:btorsim_bv_srem_into(r, a[0], a[1], scratch);
+      break;
+    case BTOR2_TAG_ugt:btorsim_bv_ult_into(r, a[1], a[0]);
+      break;
+    case BTOR2_TAG_ugte:btorsim_bv_ulte_into(r, a[1], a[0]);
+      break;
+    case BTOR2_TAG_ult:btorsim_bv_ult_into(r, a[0], a[1]);
+      break;
+    case BTOR2_TAG_ulte:btorsim_bv_ulte_into(r, a[0], a[1]);
+      break;
+    case BTOR2_TAG_urem:btorsim_bv_urem_into(r, a[0], a[1], scratch);
+      break;
+    case BTOR2_TAG_sgt:btorsim_bv_slt_into(r, a[1], a[0]);
+      break;
+    case BTOR2_TAG_sgte:btorsim_bv_slte_into(r, a[1], a[0]);
+      break;
+    case BTOR2_TAG_slt:btorsim_bv_slt_into(r, a[0], a[1]);
+      break;
+    case BTOR2_TAG_slte:btorsim_bv_slte_into(r, a[0], a[1]);
+      break;
+    case BTOR2_TAG_iff:
+    case BTOR2_TAG_xnor:btorsim_bv_xnor_into(r, a[0], a[1]);
+      break;
+    case BTOR2_TAG_xor:btorsim_bv_xor_into(r, a[0], a[1]);
+      break;
+    default:
+      die("can not randomly simulate operator '%s' at line %" PRId64,
+          l->name,
+          l->lineno);
+  }
+}
 
-        uint64_t val1 = 0, val2 = 0;
-        for (int j = (int) bv->width - 1; j >= 0; --j) {
-          val1 = val1 * base1 + (btorsim_bv_get_bit(bv, j) + 1);
-          val2 = val2 * base2 + (btorsim_bv_get_bit(bv, j) + 1);
-        }
-        val1 *= base1;
-        val2 *= base2;
-        hash_value[i].first ^= val1;
-        hash_value[i].second ^= val2;
-      }
+void Simulator::lane_kernel_step(Btor2Line *l, uint32_t n) {
+  const uint64_t *a[3];
+  for (uint32_t i = 0; i < l->nargs; ++i) a[i] = lane_arg(l->args[i], n, lane_tmp[i]);
+  uint64_t *r = lane_word[l->id].data();
+  uint32_t w = l->sort.bitvec.width, aw = l->nargs ? lane_width(l->args[0]) : w;
+  switch (l->tag) {
+    case BTOR2_TAG_add:btorsim_lane_add(r, a[0], a[1], n, w);
+      break;
+    case BTOR2_TAG_and:btorsim_lane_and(r, a[0], a[1], n);
+      break;
+    case BTOR2_TAG_concat:btorsim_lane_concat(r, a[0], a[1], n, lane_width(l->args[1]));
+      break;
+    case BTOR2_TAG_dec:btorsim_lane_dec(r, a[0], n, w);
+      break;
+    case BTOR2_TAG_eq:btorsim_lane_eq(r, a[0], a[1], n);
+      break;
+    case BTOR2_TAG_implies:btorsim_lane_implies(r, a[0], a[1], n);
+      break;
+    case BTOR2_TAG_inc:btorsim_lane_inc(r, a[0], n, w);
+      break;
+    case BTOR2_TAG_ite:btorsim_lane_ite(r, a[0], a[1], a[2], n);
+      break;
+    case BTOR2_TAG_mul:btorsim_lane_mul(r, a[0], a[1], n, w);
+      break;
+    case BTOR2_TAG_nand:btorsim_lane_nand(r, a[0], a[1], n, w);
+      break;
+    case BTOR2_TAG_neg:btorsim_lane_neg(r, a[0], n, w);
+      break;
+    case BTOR2_TAG_neq:btorsim_lane_neq(r, a[0], a[1], n);
+      break;
+    case BTOR2_TAG_nor:btorsim_lane_nor(r, a[0], a[1], n, w);
+      break;
+    case BTOR2_TAG_not:btorsim_lane_not(r, a[0], n, w);
+      break;
+    case BTOR2_TAG_or:btorsim_lane_or(r, a[0], a[1], n);
+      break;
+    case BTOR2_TAG_redand:btorsim_lane_redand(r, a[0], n, aw);
+      break;
+    case BTOR2_TAG_redor:btorsim_lane_redor(r, a[0], n);
+      break;
+    case BTOR2_TAG_redxor:btorsim_lane_redxor(r, a[0], n);
+      break;
+    case BTOR2_TAG_sdiv:btorsim_lane_sdiv(r, a[0], a[1], n, w);
+      break;
+    case BTOR2_TAG_sext:btorsim_lane_sext(r, a[0], n, aw, w - aw);
+      break;
+    case BTOR2_TAG_sgt:btorsim_lane_slt(r, a[1], a[0], n, aw);
+      break;
+    case BTOR2_TAG_sgte:btorsim_lane_slte(r, a[1], a[0], n, aw);
+      break;
+    case BTOR2_TAG_slice:btorsim_lane_slice(r, a[0], n, l->args[1], l->args[2]);
+      break;
+    case BTOR2_TAG_sll:btorsim_lane_sll(r, a[0], a[1], n, w);
+      break;
+    case BTOR2_TAG_slt:btorsim_lane_slt(r, a[0], a[1], n, aw);
+      break;
+    case BTOR2_TAG_slte:btorsim_lane_slte(r, a[0], a[1], n, aw);
+      break;
+    case BTOR2_TAG_sra:btorsim_lane_sra(r, a[0], a[1], n, w);
+      break;
+    case BTOR2_TAG_srem:btorsim_lane_srem(r, a[0], a[1], n, w);
+      break;
+    case BTOR2_TAG_srl:btorsim_lane_srl(r, a[0], a[1], n, w);
+      break;
+    case BTOR2_TAG_sub:btorsim_lane_sub(r, a[0], a[1], n, w);
+      break;
+    case BTOR2_TAG_udiv:btorsim_lane_udiv(r, a[0], a[1], n, w);
+      break;
+    case BTOR2_TAG_uext:btorsim_lane_copy(r, a[0], n);
+      break;
+    case BTOR2_TAG_ugt:btorsim_lane_ult(r, a[1], a[0], n);
+      break;
+    case BTOR2_TAG_ugte:btorsim_lane_ulte(r, a[1], a[0], n);
+      break;
+    case BTOR2_TAG_ult:btorsim_lane_ult(r, a[0], a[1], n);
+      break;
+    case BTOR2_TAG_ulte:btorsim_lane_ulte(r, a[0], a[1], n);
+      break;
+    case BTOR2_TAG_urem:btorsim_lane_urem(r, a[0], a[1], n, w);
+      break;
+    case BTOR2_TAG_iff:
+    case BTOR2_TAG_xnor:btorsim_lane_xnor(r, a[0], a[1], n, w);
+      break;
+    case BTOR2_TAG_xor:btorsim_lane_xor(r, a[0], a[1], n);
+      break;
+    default:die("internal error: no lane kernel for '%s'", l->name);
+  }
+}
 
-      fprintf(log_file, "@%" PRId64 "\n", succ);
-      for (size_t i = 0, n = inputs.size(); i < n; ++i) {
-        Btor2Line *input = inputs[i];
-        print_state_or_input(input->id, i, succ, 1);
-      }
-      if (print_states) {
-        fprintf(log_file, "#%" PRId64 "\n", succ);
-        for (size_t i = 0, n = parse_states.size(); i < n; ++i) {
-          Btor2Line *state = parse_states[i].first;
-          print_state_or_input(state->id, i, succ, 0);
-        }
+/* evaluate 'n' patterns of 'l' in the width class 'W', the arguments are
+ * zero-extended to it and the result is truncated to the class of 'l' */
+template <uint32_t W, Btor2Tag TAG>
+static void limb_kernel(Btor2Line *l, uint64_t *res, const uint64_t *const *args, uint32_t n) {
+  const uint32_t w = l->sort.bitvec.width, rs = lane_stride(l->id);
+  const uint32_t aw = l->nargs ? lane_width(l->args[0]) : w;
+  uint32_t as[3] = {0, 0, 0};
+  for (uint32_t j = 0; j < l->nargs; ++j) as[j] = lane_stride(l->args[j]);
+  for (uint32_t p = 0; p < n; ++p) {
+    BtorSimBV<W> a[3], r;
+    for (uint32_t j = 0; j < l->nargs; ++j) a[j] = btorsim_bvt_load<W>(args[j] + p * as[j], as[j]);
+    if constexpr (TAG == BTOR2_TAG_add) r = btorsim_bvt_add(a[0], a[1], w);
+    else if constexpr (TAG == BTOR2_TAG_and) r = btorsim_bvt_and(a[0], a[1]);
+    else if constexpr (TAG == BTOR2_TAG_concat) r = btorsim_bvt_concat(a[0], a[1], lane_width(l->args[1]));
+    else if constexpr (TAG == BTOR2_TAG_dec) r = btorsim_bvt_sub(a[0], btorsim_bvt_word<W>(1), w);
+    else if constexpr (TAG == BTOR2_TAG_eq) r = btorsim_bvt_word<W>(btorsim_bvt_eq(a[0], a[1]));
+    else if constexpr (TAG == BTOR2_TAG_implies) r = btorsim_bvt_word<W>((~a[0].w[0] | a[1].w[0]) & 1);
+    else if constexpr (TAG == BTOR2_TAG_inc) r = btorsim_bvt_add(a[0], btorsim_bvt_word<W>(1), w);
+    else if constexpr (TAG == BTOR2_TAG_ite) r = a[0].w[0] ? a[1] : a[2];
+    else if constexpr (TAG == BTOR2_TAG_mul) r = btorsim_bvt_mul(a[0], a[1], w);
+    else if constexpr (TAG == BTOR2_TAG_nand) r = btorsim_bvt_not(btorsim_bvt_and(a[0], a[1]), w);
+    else if constexpr (TAG == BTOR2_TAG_neg) r = btorsim_bvt_neg(a[0], w);
+    else if constexpr (TAG == BTOR2_TAG_neq) r = btorsim_bvt_word<W>(!btorsim_bvt_eq(a[0], a[1]));
+    else if constexpr (TAG == BTOR2_TAG_nor) r = btorsim_bvt_not(btorsim_bvt_or(a[0], a[1]), w);
+    else if constexpr (TAG == BTOR2_TAG_not) r = btorsim_bvt_not(a[0], w);
+    else if constexpr (TAG == BTOR2_TAG_or) r = btorsim_bvt_or(a[0], a[1]);
+    else if constexpr (TAG == BTOR2_TAG_redand) r = btorsim_bvt_word<W>(btorsim_bvt_redand(a[0], aw));
+    else if constexpr (TAG == BTOR2_TAG_redor) r = btorsim_bvt_word<W>(btorsim_bvt_redor(a[0]));
+    else if constexpr (TAG == BTOR2_TAG_redxor) r = btorsim_bvt_word<W>(btorsim_bvt_redxor(a[0]));
+    else if constexpr (TAG == BTOR2_TAG_sdiv) r = btorsim_bvt_sdiv(a[0], a[1], w);
+    else if constexpr (TAG == BTOR2_TAG_sext) r = btorsim_bvt_sext(a[0], aw, w - aw);
+    else if constexpr (TAG == BTOR2_TAG_sgt) r = btorsim_bvt_word<W>(btorsim_bvt_slt(a[1], a[0], aw));
+    else if constexpr (TAG == BTOR2_TAG_sgte) r = btorsim_bvt_word<W>(btorsim_bvt_slte(a[1], a[0], aw));
+    else if constexpr (TAG == BTOR2_TAG_slice) r = btorsim_bvt_slice(a[0], l->args[1], l->args[2]);
+    else if constexpr (TAG == BTOR2_TAG_sll) r = btorsim_bvt_sll(a[0], a[1], w);
+    else if constexpr (TAG == BTOR2_TAG_slt) r = btorsim_bvt_word<W>(btorsim_bvt_slt(a[0], a[1], aw));
+    else if constexpr (TAG == BTOR2_TAG_slte) r = btorsim_bvt_word<W>(btorsim_bvt_slte(a[0], a[1], aw));
+    else if constexpr (TAG == BTOR2_TAG_sra) r = btorsim_bvt_sra(a[0], a[1], w);
+    else if constexpr (TAG == BTOR2_TAG_srem) r = btorsim_bvt_srem(a[0], a[1], w);
+    else if constexpr (TAG == BTOR2_TAG_srl) r = btorsim_bvt_srl(a[0], a[1], w);
+    else if constexpr (TAG == BTOR2_TAG_sub) r = btorsim_bvt_sub(a[0], a[1], w);
+    else if constexpr (TAG == BTOR2_TAG_udiv) r = btorsim_bvt_udiv(a[0], a[1], w);
+    else if constexpr (TAG == BTOR2_TAG_uext) r = a[0];
+    else if constexpr (TAG == BTOR2_TAG_ugt) r = btorsim_bvt_word<W>(btorsim_bvt_ult(a[1], a[0]));
+    else if constexpr (TAG == BTOR2_TAG_ugte) r = btorsim_bvt_word<W>(btorsim_bvt_ulte(a[1], a[0]));
+    else if constexpr (TAG == BTOR2_TAG_ult) r = btorsim_bvt_word<W>(btorsim_bvt_ult(a[0], a[1]));
+    else if constexpr (TAG == BTOR2_TAG_ulte) r = btorsim_bvt_word<W>(btorsim_bvt_ulte(a[0], a[1]));
+    else if constexpr (TAG == BTOR2_TAG_urem) r = btorsim_bvt_urem(a[0], a[1], w);
+    else if constexpr (TAG == BTOR2_TAG_iff || TAG == BTOR2_TAG_xnor)
+      r = btorsim_bvt_not(btorsim_bvt_xor(a[0], a[1]), w);
+    else if constexpr (TAG == BTOR2_TAG_xor) r = btorsim_bvt_xor(a[0], a[1]);
+    else static_assert(TAG == BTOR2_TAG_xor, "no limb kernel for this operator");
+    btorsim_bvt_store(r, res + p * rs, rs);
+  }
+}
+
+template <uint32_t W>
+static LaneLimbKernel limb_kernel_of(Btor2Tag tag) {
+  switch (tag) {
+#define LIMB_KERNEL(OP) \
+    case BTOR2_TAG_##OP:return limb_kernel<W, BTOR2_TAG_##OP>;
+    LIMB_KERNEL(add) LIMB_KERNEL(and) LIMB_KERNEL(concat) LIMB_KERNEL(dec)
+    LIMB_KERNEL(eq) LIMB_KERNEL(implies) LIMB_KERNEL(inc) LIMB_KERNEL(ite)
+    LIMB_KERNEL(mul) LIMB_KERNEL(nand) LIMB_KERNEL(neg) LIMB_KERNEL(neq)
+    LIMB_KERNEL(nor) LIMB_KERNEL(not) LIMB_KERNEL(or) LIMB_KERNEL(redand)
+    LIMB_KERNEL(redor) LIMB_KERNEL(redxor) LIMB_KERNEL(sdiv) LIMB_KERNEL(sext)
+    LIMB_KERNEL(sgt) LIMB_KERNEL(sgte) LIMB_KERNEL(slice) LIMB_KERNEL(sll)
+    LIMB_KERNEL(slt) LIMB_KERNEL(slte) LIMB_KERNEL(sra) LIMB_KERNEL(srem)
+    LIMB_KERNEL(srl) LIMB_KERNEL(sub) LIMB_KERNEL(udiv) LIMB_KERNEL(uext)
+    LIMB_KERNEL(ugt) LIMB_KERNEL(ugte) LIMB_KERNEL(ult) LIMB_KERNEL(ulte)
+    LIMB_KERNEL(urem) LIMB_KERNEL(iff) LIMB_KERNEL(xnor) LIMB_KERNEL(xor)
+#undef LIMB_KERNEL
+    default:return nullptr;
+  }
+}
+
+/* pick the instantiation of a node by the widest of its result and
+ * operands, nodes of the 64-bit class run the word kernels instead and
+ * nodes touching wider operands fall back to the generic bit-vectors */
+static LaneLimbKernel select_limb_kernel(Btor2Line *l) {
+  if (lane_kind[l->id] == LANE_WIDE || !has_lane_op(l)) return nullptr;
+  uint32_t width = l->sort.bitvec.width;
+  for (uint32_t i = 0; i < l->nargs; ++i) {
+    if (lane_kind[labs(l->args[i])] == LANE_WIDE) return nullptr;
+    width = std::max(width, lane_width(l->args[i]));
+  }
+  switch (btorsim_bvt_class(width)) {
+    case 128:return limb_kernel_of<128>(l->tag);
+    case 256:return limb_kernel_of<256>(l->tag);
+    default:return nullptr;
+  }
+}
+
+static bool is_lane_const(Btor2Line *l) {
+  return l->tag == BTOR2_TAG_const || l->tag == BTOR2_TAG_constd
+      || l->tag == BTOR2_TAG_consth || l->tag == BTOR2_TAG_one
+      || l->tag == BTOR2_TAG_ones || l->tag == BTOR2_TAG_zero;
+}
+
+/* nodes are evaluated in topological order, the initial value of a state
+ * may refer to nodes with larger ids */
+static void setup_lane_order() {
+  std::vector<char> mark(num_format_lines + 1, 0);
+  std::vector<std::pair<int64_t, uint32_t>> stack;
+  for (int64_t r = 1; r <= num_format_lines; ++r) {
+    if (lane_kind[r] == LANE_NONE || mark[r]) continue;
+    stack.emplace_back(r, 0);
+    mark[r] = 1;
+    while (!stack.empty()) {
+      int64_t i = stack.back().first;
+      uint32_t j = stack.back().second++;
+      Btor2Line *l = btor2parser_get_line_by_id(model, i);
+      int64_t next = 0;
+      if (l->tag == BTOR2_TAG_state) {
+        if (!j && inits[i]) next = labs(inits[i]->args[1]);
+      } else if (j < l->nargs && l->tag != BTOR2_TAG_input)
+        next = labs(l->args[j]);
+      else if (j < l->nargs)
+        continue;
+      if (next) {
+        if (!mark[next]) mark[next] = 1, stack.emplace_back(next, 0);
+        continue;
       }
-    } else
-      fprintf(log_file, "[simubtor] constraints violated at time %" PRId64 "\n", step);
-    if (step < k) reset_state();
+      stack.pop_back();
+      if (!is_lane_const(l)) lane_order.push_back(i);
+    }
   }
+}
 
-  if (print_hash) {
-    fprintf(log_file, "$hash value\n");
-    print_all_hash(succ);
+/* choose the engine of every node by its width, returns false if the model
+ * can not be simulated lane-parallel (arrays) */
+static bool setup_lanes() {
+  lane_kind.resize(num_format_lines + 1, LANE_NONE);
+  lane_kernel.resize(num_format_lines + 1, false);
+  lane_limb_kernel.resize(num_format_lines + 1, nullptr);
+  for (int64_t i = 1; i <= num_format_lines; ++i) {
+    Btor2Line *l = btor2parser_get_line_by_id(model, i);
+    if (!l || !in_cone[i]) continue;
+    if (l->sort.tag != BTOR2_TAG_SORT_bitvec) return false;
+    uint32_t width = l->sort.bitvec.width;
+    lane_kind[i] = width <= BTORSIM_LANE_MAXWIDTH ? LANE_WORD
+                 : width <= BTORSIM_BVT_MAXWIDTH ? LANE_LIMBS
+                                                 : LANE_WIDE;
+    lane_kernel[i] = has_lane_kernel(l);
+    if (!lane_kernel[i]) lane_limb_kernel[i] = select_limb_kernel(l);
   }
-  report();
-  fprintf(log_file, "[simubtor] successful simulation: %" PRId64 "/%" PRId64 "\n", succ, k);
+  setup_lane_order();
+  return true;
+}
+
+Simulator::Simulator() : reached_bads(::reached_bads), num_unreached_bads(::num_unreached_bads) {
+  current_state.resize(num_format_lines + 1);
+  hash_value.resize(num_hash_ids, std::make_pair(0ull, 0ull));
+  for (int i = 0; i <= num_format_lines; i++) {
+    Btor2Line *l = btor2parser_get_line_by_id(model, i);
+    if (l) {
+      Btor2Sort *sort = get_sort(l, model);
+      switch (sort->tag) {
+        case BTOR2_TAG_SORT_bitvec:current_state[i].type = BtorSimState::Type::BITVEC;
+          break;
+        case BTOR2_TAG_SORT_array:current_state[i].type = BtorSimState::Type::ARRAY;
+          break;
+        default:die("Unknown sort");
+      }
+    }
+  }
+  for (auto state : states) {
+    assert (current_state[state->id].type != BtorSimState::Type::INVALID);
+  }
+  if (!lanes) return;
+
+  lane_word.resize(num_format_lines + 1);
+  lane_wide.resize(num_format_lines + 1);
+  lane_ptr.resize(num_format_lines + 1, nullptr);
+  uint32_t max_width = 1;
+  for (int64_t i = 1; i <= num_format_lines; ++i) {
+    if (lane_kind[i] == LANE_WORD)
+      lane_word[i].resize(lanes, 0), lane_ptr[i] = lane_word[i].data();
+    else if (lane_kind[i] == LANE_LIMBS)
+      lane_word[i].resize((size_t) lanes * lane_stride(i), 0);
+    else if (lane_kind[i] == LANE_WIDE) {
+      size_t words = btorsim_bv_bytes(lane_width(i)) / sizeof(uint64_t);
+      lane_word[i].resize((size_t) lanes * words);
+      lane_wide[i].resize(lanes);
+      for (uint32_t p = 0; p < lanes; ++p)
+        lane_wide[i][p] = btorsim_bv_init(lane_word[i].data() + p * words, lane_width(i));
+    } else
+      continue;
+    max_width = std::max(max_width, lane_width(i));
+    Btor2Line *l = btor2parser_get_line_by_id(model, i);
+    if (!is_lane_const(l)) continue;
+    /* constants are the same in every pattern */
+    BtorSimBitVector *bv = lane_const(l);
+    for (uint32_t p = 0; p < lanes; ++p) lane_set_bv(i, p, bv);
+    btorsim_bv_free(bv);
+  }
+  for (auto &mem : lane_bv_mem)
+    mem.resize(btorsim_bv_bytes(max_width) / sizeof(uint64_t));
+  lane_div_scratch.resize(btorsim_bv_scratch_limbs(max_width));
+}
+
+Simulator::~Simulator() {
+  reset_state();
+}
+
+void Simulator::seed(uint32_t s, uint32_t hash_seed) {
+  btorsim_rng_init(&rng, s);
+  btorsim_rng_init(&base_rng, hash_seed);
+}
+
+/* evaluate the first 'n' patterns of all nodes */
+void Simulator::simulate_lanes(uint32_t n) {
+  if (compiled_model) {
+    /* the compiled model reads the free inputs and states */
+    for (int64_t i : lane_order) {
+      Btor2Line *l = btor2parser_get_line_by_id(model, i);
+      if (l->tag == BTOR2_TAG_state && inits[i]) continue;
+      if (l->tag != BTOR2_TAG_input && l->tag != BTOR2_TAG_state) continue;
+      uint32_t width = l->sort.bitvec.width;
+      bool is_fixed = l->tag == BTOR2_TAG_input && l->next;
+      uint64_t fixed = is_fixed ? btorsim_bv_to_uint64(fixed_input[l->next]) : 0;
+      for (uint32_t p = 0; p < n; ++p)
+        lane_word[i][p] = is_fixed ? fixed
+                                   : l->tag == BTOR2_TAG_input ? random_input_word(l)
+                                                               : lane_random_word(width);
+    }
+    compiled_model(lane_ptr.data(), n);
+    return;
+  }
+  for (int64_t i : lane_order) {
+    Btor2Line *l = btor2parser_get_line_by_id(model, i);
+    uint32_t width = l->sort.bitvec.width;
+    if (lane_kernel[i]) {
+      lane_kernel_step(l, n);
+      continue;
+    }
+    if (lane_limb_kernel[i]) {
+      const uint64_t *a[3];
+      for (uint32_t j = 0; j < l->nargs; ++j) a[j] = lane_arg(l->args[j], n, lane_tmp[j]);
+      lane_limb_kernel[i](l, lane_word[i].data(), a, n);
+      continue;
+    }
+    for (uint32_t p = 0; p < n; ++p) {
+      /* wide nodes are evaluated in place */
+      BtorSimBitVector *update = lane_kind[i] == LANE_WIDE ? lane_wide[i][p] : lane_bv(3, width);
+      if (l->tag == BTOR2_TAG_input) {
+        if (l->next)
+          btorsim_bv_copy_into(update, fixed_input[l->next]);
+        else if (lane_kind[i] == LANE_WORD) {
+          lane_word[i][p] = random_input_word(l);
+          continue;
+        } else
+          btorsim_bv_random_into(update, &rng);
+      } else if (l->tag == BTOR2_TAG_state) {
+        Btor2Line *init = inits[i];
+        if (init)
+          btorsim_bv_copy_into(update, lane_get_bv(init->args[1], p, 0));
+        else if (lane_kind[i] == LANE_WORD) {
+          lane_word[i][p] = lane_random_word(width);
+          continue;
+        } else
+          btorsim_bv_random_into(update, &rng);
+      } else {
+        const BtorSimBitVector *args[3];
+        for (uint32_t j = 0; j < l->nargs; ++j) args[j] = lane_get_bv(l->args[j], p, j);
+        lane_fallback(l, update, args, lane_div_scratch.data());
+      }
+      lane_set_bv(i, p, update);
+    }
+  }
+}
+
+uint32_t Simulator::lane_get_bit(int64_t id, uint32_t p, uint32_t pos) {
+  int64_t i = labs(id);
+  uint32_t bit;
+  if (lane_kind[i] == LANE_WORD)
+    bit = lane_word[i][p] >> pos & 1;
+  else if (lane_kind[i] == LANE_LIMBS)
+    bit = lane_word[i][p * lane_stride(i) + pos / 64] >> (pos % 64) & 1;
+  else
+    bit = btorsim_bv_get_bit(lane_wide[i][p], pos);
+  return id < 0 ? bit ^ 1 : bit;
+}
+
+/* check constraints and bads of pattern 'p' simulated as step 'k' */
+bool Simulator::lane_check(uint32_t p, int64_t k) {
+  for (size_t i = 0; i < constraints.size(); i++)
+    if (!lane_get_bit(constraints[i]->args[0], p, 0)) return 0;
+
+  for (size_t i = 0; i < bads.size(); i++) {
+    if (reached_bads[i] >= 0) continue;
+    if (!lane_get_bit(bads[i]->args[0], p, 0)) continue;
+    reached_bads[i] = k;
+    assert (num_unreached_bads > 0);
+    if (!--num_unreached_bads)
+      msg(1,
+          "all %" PRId64 " bad state properties reached",
+          (int64_t) bads.size());
+  }
+  return 1;
+}
+
+void Simulator::print_lane(int64_t id, int64_t pos, int64_t step, uint32_t p, bool is_input) {
+  Btor2Line *l = btor2parser_get_line_by_id(model, id);
+  log.print("%" PRId64 " ", pos);
+  for (int j = (int) l->sort.bitvec.width - 1; j >= 0; --j)
+    log.put('0' + lane_get_bit(id, p, j));
+  if (l->symbol) {
+    log.print(" %s%s", l->symbol, is_input ? "@" : "#");
+    log.number(step);
+  }
+  log.put('\n');
+}
+
+/* simulate the steps from 'first' to 'last' in batches of <lanes> patterns */
+void Simulator::lane_simulation(int64_t first, int64_t last) {
+  for (int64_t base = first; base <= last; base += lanes) {
+    uint32_t n = (uint32_t) std::min<int64_t>(lanes, last - base + 1);
+    simulate_lanes(n);
+    for (uint32_t p = 0; p < n; ++p) {
+      int64_t step = base + p;
+      if (stop_at_bads && !bads.empty() && !num_unreached_bads) return;
+      uint64_t key1, key2;
+      draw_keys(key1, key2);
+      hash_step = step;
+      if (!lane_check(p, step)) {
+        log.print("[simubtor] constraints violated at time %" PRId64 "\n", step);
+        continue;
+      }
+      ++succ;
+      log.print("[simubtor] constraints satisfied at time %" PRId64 "\n", step);
+      auto start = std::chrono::steady_clock::now();
+      for (int64_t i = 1; i <= num_format_lines; ++i) {
+        if (lane_kind[i] == LANE_WORD)
+          hash_word(i, lane_word[i][p], lane_width(i), key1, key2);
+        else if (lane_kind[i] == LANE_LIMBS)
+          hash_limbs(i, lane_word[i].data() + p * lane_stride(i), lane_width(i), key1, key2);
+        else if (lane_kind[i] == LANE_WIDE)
+          hash_bv(i, lane_wide[i][p], key1, key2);
+      }
+      hash_time += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+      log.put('@'), log.number(succ), log.put('\n');
+      for (size_t i = 0, m = inputs.size(); i < m; ++i)
+        print_lane(inputs[i]->id, i, succ, p, 1);
+      if (print_states) {
+        log.put('#'), log.number(succ), log.put('\n');
+        for (size_t i = 0, m = parse_states.size(); i < m; ++i)
+          print_lane(parse_states[i].first->id, i, succ, p, 0);
+      }
+    }
+  }
+}
+
+bool Simulator::run_step(int64_t k, int32_t randomize) {
+  initialize_states(randomize);
+  initialize_inputs(k, randomize);
+  return simulate_step(k);
+}
+
+void Simulator::reset_state() {
+  for (int64_t i = 1; i <= num_format_lines; i++) {
+    Btor2Line *l = btor2parser_get_line_by_id(model, i);
+    if (!l || !is_evaluated(l)) continue;
+    current_state[i].remove();
+  }
+}
+
+/* every successful step adds a keyed hash of each node into its 128-bit
+ * signature, the keys are drawn anew from 'base_rng' for every step */
+void Simulator::draw_keys(uint64_t &key1, uint64_t &key2) {
+  if (poly_hash) {
+    key1 = btorsim_rng_rand(&base_rng), key2 = btorsim_rng_rand(&base_rng);
+    return;
+  }
+  key1 = (uint64_t) btorsim_rng_rand(&base_rng) << 32 | btorsim_rng_rand(&base_rng);
+  key2 = (uint64_t) btorsim_rng_rand(&base_rng) << 32 | btorsim_rng_rand(&base_rng);
+}
+
+void Simulator::add_hash(int64_t id, uint64_t h1, uint64_t h2) {
+  if (flips) {
+    hash_value[id].first += h1 * event_weight.first;
+    hash_value[id].second += h2 * event_weight.second;
+    return;
+  }
+  hash_value[id].first ^= h1;
+  hash_value[id].second ^= h2;
+  if (hash_trail) hash_trail->emplace_back(id, h1, h2);
+}
+
+static std::pair<uint64_t, uint64_t> word_hash(uint64_t value, uint32_t width, uint64_t key1, uint64_t key2) {
+  if (poly_hash) {
+    uint64_t val1 = 0, val2 = 0;
+    for (int j = (int) width - 1; j >= 0; --j) {
+      uint32_t bit = value >> j & 1;
+      val1 = val1 * key1 + (bit + 1);
+      val2 = val2 * key2 + (bit + 1);
+    }
+    return std::make_pair(val1 * key1, val2 * key2);
+  }
+  return std::make_pair(btorsim_bv_mix64(key1 ^ value), btorsim_bv_mix64(key2 ^ value));
+}
+
+/* the 'width' bits of 'bv' from 'lower' on, 'width' is at most 64 */
+static uint64_t bv_bits(const BtorSimBitVector *bv, uint32_t lower, uint32_t width) {
+  uint64_t res = 0;
+  for (uint32_t j = width; j-- > 0;) res = res << 1 | btorsim_bv_get_bit(bv, lower + j);
+  return res;
+}
+
+void Simulator::hash_word(int64_t id, uint64_t value, uint32_t width, uint64_t key1, uint64_t key2) {
+  auto h = word_hash(value, width, key1, key2);
+  add_hash(id, h.first, h.second);
+  if (exact) record(id, &value, width);
+  if (!slice_width || !slice_base[id]) return;
+  int64_t s = slice_base[id];
+  for (uint32_t lower = 0; lower < width; lower += slice_width, ++s) {
+    uint32_t w = std::min(slice_width, width - lower);
+    uint64_t v = value >> lower & btorsim_lane_mask(w);
+    h = word_hash(v, w, key1, key2);
+    add_hash(s, h.first, h.second);
+    if (exact) record(s, &v, w);
+  }
+}
+
+void Simulator::hash_bv(int64_t id, const BtorSimBitVector *bv, uint64_t key1, uint64_t key2) {
+  uint64_t h1, h2;
+  if (poly_hash) {
+    uint64_t val1 = 0, val2 = 0;
+    for (int j = (int) bv->width - 1; j >= 0; --j) {
+      uint32_t bit = btorsim_bv_get_bit(bv, j);
+      val1 = val1 * key1 + (bit + 1);
+      val2 = val2 * key2 + (bit + 1);
+    }
+    h1 = val1 * key1, h2 = val2 * key2;
+  } else
+    h1 = btorsim_bv_keyed_hash(bv, key1), h2 = btorsim_bv_keyed_hash(bv, key2);
+  add_hash(id, h1, h2);
+  if (exact && signatures.recorded(id)) {
+    exact_words.resize((bv->width + 63) / 64);
+    btorsim_bv_to_words(bv, exact_words.data());
+    record(id, exact_words.data(), bv->width);
+  }
+  if (!slice_width || !slice_base[id]) return;
+  int64_t s = slice_base[id];
+  for (uint32_t lower = 0; lower < bv->width; lower += slice_width, ++s) {
+    uint32_t w = std::min(slice_width, bv->width - lower);
+    uint64_t v = bv_bits(bv, lower, w);
+    auto h = word_hash(v, w, key1, key2);
+    add_hash(s, h.first, h.second);
+    if (exact) record(s, &v, w);
+  }
+}
+
+/* the 'width' bits of 'words' from 'lower' on, 'width' is at most 64 */
+static uint64_t word_bits(const uint64_t *words, uint32_t lower, uint32_t width) {
+  uint32_t k = lower / 64, b = lower % 64;
+  uint64_t v = words[k] >> b;
+  if (b && b + width > 64) v |= words[k + 1] << (64 - b);
+  return v & btorsim_lane_mask(width);
+}
+
+/* same hash as 'hash_bv' for a value held as 64-bit words, LSB first */
+void Simulator::hash_limbs(int64_t id, const uint64_t *words, uint32_t width, uint64_t key1, uint64_t key2) {
+  uint64_t h1 = key1, h2 = key2;
+  if (poly_hash) {
+    uint64_t val1 = 0, val2 = 0;
+    for (int j = (int) width - 1; j >= 0; --j) {
+      uint32_t bit = words[j / 64] >> (j % 64) & 1;
+      val1 = val1 * key1 + (bit + 1);
+      val2 = val2 * key2 + (bit + 1);
+    }
+    h1 = val1 * key1, h2 = val2 * key2;
+  } else
+    for (uint32_t k = 0; k < (width + 63) / 64; ++k)
+      h1 = btorsim_bv_mix64(h1 ^ words[k]), h2 = btorsim_bv_mix64(h2 ^ words[k]);
+  add_hash(id, h1, h2);
+  if (exact) record(id, words, width);
+  if (!slice_width || !slice_base[id]) return;
+  int64_t s = slice_base[id];
+  for (uint32_t lower = 0; lower < width; lower += slice_width, ++s) {
+    uint32_t w = std::min(slice_width, width - lower);
+    uint64_t v = word_bits(words, lower, w);
+    auto h = word_hash(v, w, key1, key2);
+    add_hash(s, h.first, h.second);
+    if (exact) record(s, &v, w);
+  }
+}
+
+/* keep the value of 'id' in step 'hash_step' if it is reported */
+void Simulator::record(int64_t id, const uint64_t *words, uint32_t width) {
+  if (!signatures.recorded(id)) return;
+  for (uint32_t lower = 0, k = 0; lower < width; lower += 64, ++k)
+    signatures.record(id, hash_step - 1, lower, words[k], std::min(64u, width - lower));
+}
+
+void Simulator::scalar_simulation(int64_t first, int64_t last) {
+  for (int64_t step = first; step <= last; ++step) {
+    if (stop_at_bads && !bads.empty() && !num_unreached_bads) break;
+    uint64_t key1, key2;
+    draw_keys(key1, key2);
+    hash_step = step;
+    if (run_step(step, 1)) {
+      ++succ;
+      log.print("[simubtor] constraints satisfied at time %" PRId64 "\n", step);
+      auto start = std::chrono::steady_clock::now();
+      for (int64_t i : cone) {
+        if (current_state[i].type != BtorSimState::BITVEC) continue;
+        BtorSimBitVector *bv = current_state[i].bv_state;
+        if (bv) hash_bv(i, bv, key1, key2);
+      }
+      hash_time += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+      print_pattern();
+    } else
+      log.print("[simubtor] constraints violated at time %" PRId64 "\n", step);
+    reset_state();
+  }
+}
+
+/* log the inputs (and states) of the successful step 'succ' */
+void Simulator::print_pattern() {
+  log.put('@'), log.number(succ), log.put('\n');
+  for (size_t i = 0, n = inputs.size(); i < n; ++i) {
+    Btor2Line *input = inputs[i];
+    print_state_or_input(input->id, i, succ, 1, input->symbol);
+  }
+  if (print_states) {
+    log.put('#'), log.number(succ), log.put('\n');
+    for (size_t i = 0, n = parse_states.size(); i < n; ++i) {
+      Btor2Line *state = parse_states[i].first;
+      print_state_or_input(state->id, i, succ, 0, state->symbol);
+    }
+  }
+}
+
+/*------------------------------------------------------------------------*/
+
+/* The signature of a node is the sum of 'h(v_s) * r_s' over the successful
+ * steps 's', with its value 'v_s' and a random step key 'r_s'.  A value that
+ * lasts several steps is added once, multiplied with the sum of their keys,
+ * so only the nodes that change cost hashing time.  Values equal in all
+ * steps still give equal signatures, and the sums of the blocks of several
+ * threads are added up.
+ */
+void Simulator::event_flush(int64_t id) {
+  if (current_state[id].type != BtorSimState::BITVEC || !current_state[id].bv_state) return;
+  event_weight.first = event_sum.first - event_since[id].first;
+  event_weight.second = event_sum.second - event_since[id].second;
+  event_since[id] = event_sum;
+  if (event_weight.first || event_weight.second)
+    hash_bv(id, current_state[id].bv_state, event_key1, event_key2);
+}
+
+/* draw a new value of an input or a state without init */
+void Simulator::event_draw(Btor2Line *leaf) {
+  int64_t id = leaf->id;
+  if (leaf->sort.tag == BTOR2_TAG_SORT_bitvec) {
+    uint32_t width = leaf->sort.bitvec.width;
+    if (leaf->tag == BTOR2_TAG_input && input_range[id].restricted)
+      update_current_state(id, btorsim_bv_uint64_to_bv(random_input_word(leaf), width));
+    else
+      update_current_state(id, btorsim_bv_new_random(&rng, width));
+    return;
+  }
+  Btor2Line *li = btor2parser_get_line_by_id(model, leaf->sort.array.index);
+  Btor2Line *le = btor2parser_get_line_by_id(model, leaf->sort.array.element);
+  BtorSimArrayModel *am = new BtorSimArrayModel(li->sort.bitvec.width, le->sort.bitvec.width);
+  am->random_seed = btorsim_rng_rand(&rng);
+  update_current_state(id, am);
+}
+
+/* redraw 'flips' leaves and propagate the changes to their fanout */
+bool Simulator::event_step(int64_t k) {
+  std::priority_queue<std::pair<int64_t, int64_t>, std::vector<std::pair<int64_t, int64_t>>,
+                      std::greater<std::pair<int64_t, int64_t>>> queue;
+  auto schedule = [&](int64_t id) {
+    for (int64_t j = fanout_start[id]; j < fanout_start[id + 1]; ++j) {
+      int64_t f = fanout[j];
+      if (!event_queued[f]) event_queued[f] = 1, queue.emplace(event_rank[f], f);
+    }
+  };
+  for (uint32_t f = 0; f < flips && !event_leaves.empty(); ++f) {
+    Btor2Line *leaf = btor2parser_get_line_by_id(
+        model, event_leaves[btorsim_rng_pick_rand(&rng, 0, (uint32_t) event_leaves.size() - 1)]);
+    event_flush(leaf->id);
+    event_draw(leaf);
+    schedule(leaf->id);
+  }
+
+  while (!queue.empty()) {
+    int64_t id = queue.top().second;
+    queue.pop();
+    event_queued[id] = 0;
+    Btor2Line *l = btor2parser_get_line_by_id(model, id);
+    event_flush(id);
+    /* keep the old value aside to compare it with the new one */
+    BtorSimState old = current_state[id];
+    current_state[id].bv_state = nullptr;
+    if (l->tag == BTOR2_TAG_state) {
+      BtorSimState init = simulate(inits[id]->args[1]);
+      update_current_state(id, init);
+    } else {
+      BtorSimState res = simulate(id);
+      res.remove();
+    }
+    bool changed;
+    if (old.type == BtorSimState::BITVEC)
+      changed = btorsim_bv_compare(old.bv_state, current_state[id].bv_state) != 0;
+    else
+      changed = !(*old.array_state == *current_state[id].array_state);
+    old.remove();
+    if (changed) schedule(id);
+  }
+  return check_step(k);
+}
+
+/* simulate the steps from 'first' to 'last', the first one evaluates the
+ * whole cone, every further one only what its new inputs change */
+void Simulator::event_simulation(int64_t first, int64_t last) {
+  draw_keys(event_key1, event_key2);
+  event_sum = std::make_pair(0, 0);
+  event_since.assign(num_format_lines + 1, event_sum);
+  event_queued.assign(num_format_lines + 1, 0);
+  bool valid = false;
+  for (int64_t step = first; step <= last; ++step) {
+    if (stop_at_bads && !bads.empty() && !num_unreached_bads) break;
+    uint64_t key1, key2;
+    draw_keys(key1, key2);
+    bool ok = valid ? event_step(step) : run_step(step, 1);
+    valid = true;
+    if (ok) {
+      ++succ;
+      event_sum.first += key1, event_sum.second += key2;
+      log.print("[simubtor] constraints satisfied at time %" PRId64 "\n", step);
+      print_pattern();
+    } else
+      log.print("[simubtor] constraints violated at time %" PRId64 "\n", step);
+  }
+  if (!valid) return;
+  auto start = std::chrono::steady_clock::now();
+  for (int64_t i : cone) event_flush(i);
+  hash_time += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  reset_state();
+}
+
+/* simulate frames 0 to 'bound' of transition 'k' from the initial states,
+ * the inputs of all frames are printed to 'log' */
+bool Simulator::run_frames(int64_t k, uint64_t key1, uint64_t key2) {
+  std::vector<BtorSimState> next_state(states.size());
+  /* the states of all frames follow the inputs, as in the unrolled model */
+  LogBuffer state_log;
+  initialize_states(1);
+  for (int64_t t = 0; t <= bound; ++t) {
+    if (t) {
+      /* states without next function are free in every frame */
+      for (size_t j = 0; j < states.size(); ++j) {
+        Btor2Line *state = states[j];
+        if (nexts[state->id]) {
+          update_current_state(state->id, next_state[j]);
+          next_state[j] = BtorSimState();
+        } else if (state->sort.tag == BTOR2_TAG_SORT_bitvec)
+          update_current_state(state->id, btorsim_bv_new_random(&rng, state->sort.bitvec.width));
+        else {
+          Btor2Line *li = btor2parser_get_line_by_id(model, state->sort.array.index);
+          Btor2Line *le = btor2parser_get_line_by_id(model, state->sort.array.element);
+          BtorSimArrayModel *am = new BtorSimArrayModel(li->sort.bitvec.width, le->sort.bitvec.width);
+          am->random_seed = btorsim_rng_rand(&rng);
+          update_current_state(state->id, am);
+        }
+      }
+    }
+    initialize_inputs(k, 1);
+    if (!simulate_step(k)) {
+      reset_state();
+      return 0;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    const std::vector<int64_t> &ids = expand_id[t];
+    for (int64_t i = 1; i <= num_format_lines; ++i) {
+      if (!ids[i] || current_state[i].type != BtorSimState::BITVEC) continue;
+      BtorSimBitVector *bv = current_state[i].bv_state;
+      if (!bv) continue;
+      hash_bv(ids[i], bv, key1, key2);
+    }
+    if (!t) {
+      for (auto &z : expand_zero) {
+        BtorSimBitVector *zero = btorsim_bv_new(z.second);
+        hash_bv(z.first, zero, key1, key2);
+        btorsim_bv_free(zero);
+      }
+    }
+    hash_time += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    /* the step is numbered once it is known to be successful */
+    for (size_t i = 0, n = inputs.size(); i < n; ++i)
+      print_state_or_input(inputs[i]->id, t * n + i, succ + 1, 1, inputs[i]->symbol);
+    if (print_states) {
+      std::swap(state_log, log);
+      for (size_t i = t * states.size(), n = i + states.size(); i < n; ++i)
+        print_state_or_input(parse_states[i].first->id, i, succ + 1, 0, expand_symbol[i].c_str());
+      std::swap(state_log, log);
+    }
+
+    if (t < bound)
+      for (size_t j = 0; j < states.size(); ++j)
+        if (nexts[states[j]->id]) next_state[j] = simulate(nexts[states[j]->id]->args[1]);
+    reset_state();
+  }
+  if (print_states) {
+    log.put('#'), log.number(succ + 1), log.put('\n');
+    log.append(state_log);
+  }
+  return 1;
+}
+
+void Simulator::sequential_simulation(int64_t first, int64_t last) {
+  std::vector<std::tuple<int64_t, uint64_t, uint64_t>> hashed;
+  hash_trail = &hashed;
+  for (int64_t step = first; step <= last; ++step) {
+    if (stop_at_bads && !bads.empty() && !num_unreached_bads) break;
+    uint64_t key1, key2;
+    draw_keys(key1, key2);
+    /* the frames are printed to a buffer first, to be dropped on violation */
+    LogBuffer trace;
+    std::swap(trace, log);
+    hash_step = step;
+    bool ok = run_frames(step, key1, key2);
+    std::swap(trace, log);
+    if (ok) {
+      ++succ;
+      log.print("[simubtor] constraints satisfied at time %" PRId64 "\n", step);
+      log.put('@'), log.number(succ), log.put('\n');
+      log.append(trace);
+    } else {
+      /* a violated constraint in any frame discards the whole transition */
+      for (auto &h : hashed) {
+        hash_value[std::get<0>(h)].first ^= std::get<1>(h);
+        hash_value[std::get<0>(h)].second ^= std::get<2>(h);
+        if (exact && signatures.recorded(std::get<0>(h))) signatures.clear(std::get<0>(h), step - 1);
+      }
+      log.print("[simubtor] constraints violated at time %" PRId64 "\n", step);
+    }
+    hashed.clear();
+  }
+  hash_trail = nullptr;
+}
+
+/*------------------------------------------------------------------------*/
+
+/* in multithreaded mode the transitions are cut into blocks of a fixed
+ * size, each seeded from its index, so that the result does not depend on
+ * the number of threads or on the order in which the blocks finish */
+static const int64_t block_steps = 1024;
+
+static uint32_t block_seed(uint32_t seed, int64_t block) {
+  uint64_t z = ((uint64_t) seed << 32 | (uint64_t) block) + 0x9e3779b97f4a7c15ull;
+  z = (z ^ z >> 30) * 0xbf58476d1ce4e5b9ull;
+  z = (z ^ z >> 27) * 0x94d049bb133111ebull;
+  return (uint32_t) (z ^ z >> 31);
+}
+
+/* simulate the transitions of block 'b' of 'k' transitions on 'sim' */
+static void simulate_block(Simulator *sim, int64_t b, int64_t k, uint32_t s, uint32_t hash_seed) {
+  int64_t first = b * block_steps + 1, last = std::min(k, first + block_steps - 1);
+  sim->seed(block_seed(s, b), block_seed(hash_seed, b));
+  sim->succ = 0;
+  if (bound >= 0) sim->sequential_simulation(first, last);
+  else if (lanes) sim->lane_simulation(first, last);
+  else if (flips) sim->event_simulation(first, last);
+  else sim->scalar_simulation(first, last);
+}
+
+/* add the hashes, reached bads and hashing time of a worker to the totals */
+static void merge_simulator(Simulator *sim) {
+  for (int64_t i = 1; i < num_hash_ids; ++i) {
+    if (flips) {
+      hash_value[i].first += sim->hash_value[i].first;
+      hash_value[i].second += sim->hash_value[i].second;
+      continue;
+    }
+    hash_value[i].first ^= sim->hash_value[i].first;
+    hash_value[i].second ^= sim->hash_value[i].second;
+  }
+  for (size_t i = 0; i < bads.size(); ++i) {
+    int64_t r = sim->reached_bads[i];
+    if (r < 0) continue;
+    if (reached_bads[i] < 0) --num_unreached_bads;
+    if (reached_bads[i] < 0 || r < reached_bads[i]) reached_bads[i] = r;
+  }
+  hash_time += sim->hash_time;
+}
+
+static int64_t parallel_simulation(int64_t k, uint32_t s, uint32_t hash_seed) {
+  struct Block {
+    LogBuffer log;
+    int64_t succ = 0;
+    bool done = false;
+  };
+  int64_t num_blocks = (k + block_steps - 1) / block_steps;
+  std::vector<Block> blocks(num_blocks);
+  std::vector<Simulator *> sims(threads);
+  for (auto &sim : sims) sim = new Simulator();
+
+  std::mutex mutex;
+  std::condition_variable finished;
+  std::atomic<int64_t> next_block(0);
+  auto worker = [&](Simulator *sim) {
+    sim->stop_at_bads = false;
+    for (int64_t b; (b = next_block++) < num_blocks;) {
+      simulate_block(sim, b, k, s, hash_seed);
+
+      std::lock_guard<std::mutex> lock(mutex);
+      std::swap(blocks[b].log, sim->log);
+      blocks[b].succ = sim->succ;
+      blocks[b].done = true;
+      finished.notify_one();
+    }
+    btorsim_bv_pool_release();
+  };
+  std::vector<std::thread> pool;
+  for (auto sim : sims) pool.emplace_back(worker, sim);
+
+  /* the log is written in block order while later blocks are running */
+  int64_t succ = 0;
+  for (int64_t b = 0; b < num_blocks; ++b) {
+    std::unique_lock<std::mutex> lock(mutex);
+    finished.wait(lock, [&] { return blocks[b].done; });
+    LogBuffer log;
+    std::swap(log, blocks[b].log);
+    lock.unlock();
+    log.flush(log_file, succ);
+    succ += blocks[b].succ;
+  }
+  for (auto &t : pool) t.join();
+
+  for (auto sim : sims) {
+    merge_simulator(sim);
+    delete sim;
+  }
+  return succ;
+}
+
+/* in stress mode every thread simulates all blocks on a simulator of its
+ * own at the same time as the others, which checks that simulators share
+ * no mutable state: all runs have to agree, the first one is reported */
+static int64_t stress_simulation(int64_t k, uint32_t s, uint32_t hash_seed) {
+  struct Run {
+    Simulator *sim = nullptr;
+    std::vector<LogBuffer> logs;
+    std::vector<int64_t> succ;
+  };
+  int64_t num_blocks = (k + block_steps - 1) / block_steps;
+  std::vector<Run> runs(stress);
+  for (auto &run : runs) {
+    run.sim = new Simulator();
+    run.logs.resize(num_blocks);
+    run.succ.resize(num_blocks);
+  }
+
+  auto worker = [&](Run *run) {
+    run->sim->stop_at_bads = false;
+    for (int64_t b = 0; b < num_blocks; ++b) {
+      simulate_block(run->sim, b, k, s, hash_seed);
+      std::swap(run->logs[b], run->sim->log);
+      run->succ[b] = run->sim->succ;
+    }
+    btorsim_bv_pool_release();
+  };
+  std::vector<std::thread> pool;
+  for (auto &run : runs) pool.emplace_back(worker, &run);
+  for (auto &t : pool) t.join();
+
+  Run &first = runs[0];
+  for (uint32_t r = 1; r < stress; ++r) {
+    Run &run = runs[r];
+    for (int64_t b = 0; b < num_blocks; ++b) {
+      if (run.succ[b] == first.succ[b] && run.logs[b].text == first.logs[b].text &&
+          run.logs[b].numbers == first.logs[b].numbers)
+        continue;
+      fprintf(stderr, "*** 'simubtor' error: stress thread %u disagrees with thread 0 in block %" PRId64 "\n", r, b);
+      exit(1);
+    }
+    if (run.sim->hash_value != first.sim->hash_value || run.sim->reached_bads != first.sim->reached_bads) {
+      fprintf(stderr, "*** 'simubtor' error: stress thread %u disagrees with thread 0 in the hashes\n", r);
+      exit(1);
+    }
+  }
+  msg(1, "%u stress threads agree on %" PRId64 " blocks", stress, num_blocks);
+
+  int64_t succ = 0;
+  for (int64_t b = 0; b < num_blocks; ++b) {
+    first.logs[b].flush(log_file, succ);
+    succ += first.succ[b];
+  }
+  merge_simulator(first.sim);
+  for (auto &run : runs) delete run.sim;
+  return succ;
+}
+
+/* translate the model into native code if all its nodes are supported */
+static void setup_native() {
+  for (int64_t i = 1; i <= num_format_lines; ++i) {
+    if (lane_kind[i] == LANE_NONE) continue;
+    Btor2Line *l = btor2parser_get_line_by_id(model, i);
+    if (btorsim_codegen_supported(l)) continue;
+    fprintf(log_file, "[simubtor] native code: unsupported node %" PRId64 " '%s', interpreting\n", i, l->name);
+    return;
+  }
+  std::string dir, error;
+  bool private_dir = false;
+  if (cache_dir)
+    dir = cache_dir;
+  else if (getenv("HOME"))
+    dir = std::string(getenv("HOME")) + "/.cache/simubtor";
+  else {
+    /* a shared directory like '/tmp/simubtor' would let other users plant
+     * the object, so compile into a directory of this run only */
+    const char *tmpdir = getenv("TMPDIR");
+    std::string templ = std::string(tmpdir && *tmpdir ? tmpdir : "/tmp") + "/simubtor-XXXXXX";
+    if (!mkdtemp(&templ[0])) {
+      fprintf(log_file, "[simubtor] native code: can not create a directory in '%s', interpreting\n",
+              tmpdir && *tmpdir ? tmpdir : "/tmp");
+      return;
+    }
+    dir = templ, private_dir = true;
+  }
+  compiled_model = btorsim_codegen_load(btorsim_codegen_source(model, lane_order, inits), dir, error);
+  if (!compiled_model)
+    fprintf(log_file, "[simubtor] native code: %s, interpreting\n", error.c_str());
+  if (private_dir) {
+    /* the loaded object stays mapped after it is removed */
+    if (DIR *d = opendir(dir.c_str())) {
+      while (struct dirent *e = readdir(d))
+        if (strcmp(e->d_name, ".") && strcmp(e->d_name, ".."))
+          unlink((dir + "/" + e->d_name).c_str());
+      closedir(d);
+    }
+    rmdir(dir.c_str());
+  }
+}
+
+static void setup_cone() {
+  in_cone.assign(num_format_lines + 1, 0);
+  std::vector<int64_t> stack;
+  auto push = [&](int64_t id) {
+    id = labs(id);
+    if (!in_cone[id]) in_cone[id] = 1, stack.push_back(id);
+  };
+  for (int64_t i = 1; i <= num_format_lines; ++i) {
+    Btor2Line *l = btor2parser_get_line_by_id(model, i);
+    if (!l || !is_evaluated(l)) continue;
+    if (all_hash || l->tag == BTOR2_TAG_input || l->tag == BTOR2_TAG_state) push(i);
+  }
+  for (auto &p : parse_states) push(p.first->id);
+  for (Btor2Line *l : constraints) push(l->args[0]);
+  for (Btor2Line *l : bads) push(l->args[0]);
+  while (!stack.empty()) {
+    Btor2Line *l = btor2parser_get_line_by_id(model, stack.back());
+    stack.pop_back();
+    if (l->tag == BTOR2_TAG_state) {
+      /* in sequential mode the next states are hashed in the next frame */
+      if (inits[l->id]) push(inits[l->id]->args[1]);
+      if (bound >= 0 && nexts[l->id]) push(nexts[l->id]->args[1]);
+    } else if (l->tag != BTOR2_TAG_input)
+      for (uint32_t j = 0; j < l->nargs; ++j) push(l->args[j]);
+  }
+
+  for (int64_t i = 1; i <= num_format_lines; ++i)
+    if (in_cone[i]) cone.push_back(i);
+  if (!all_hash)
+    msg(1, "simulating %zu nodes in the cone of influence of the states", cone.size());
+}
+
+/* the leaves, ranks and fanout of the cone for '--flip', the inputs fixed
+ * by 'setup_sampling' never change */
+static void setup_events() {
+  /* the 'j'-th node the value of 'l' is computed from, 0 after the last */
+  auto dep = [](int64_t i, uint32_t j) -> int64_t {
+    Btor2Line *l = btor2parser_get_line_by_id(model, i);
+    if (l->tag == BTOR2_TAG_state) return !j && inits[i] ? labs(inits[i]->args[1]) : 0;
+    if (l->tag == BTOR2_TAG_input || j >= l->nargs) return 0;
+    return labs(l->args[j]);
+  };
+
+  /* ranks in topological order, the initial value of a state may refer to
+   * nodes with larger ids */
+  event_rank.assign(num_format_lines + 1, -1);
+  int64_t rank = 0;
+  std::vector<std::pair<int64_t, uint32_t>> stack;
+  for (int64_t r : cone) {
+    if (event_rank[r] != -1) continue;
+    stack.emplace_back(r, 0);
+    event_rank[r] = -2;
+    while (!stack.empty()) {
+      int64_t i = stack.back().first, next = dep(i, stack.back().second++);
+      if (next) {
+        if (event_rank[next] == -1) event_rank[next] = -2, stack.emplace_back(next, 0);
+        continue;
+      }
+      stack.pop_back();
+      event_rank[i] = rank++;
+    }
+  }
+
+  fanout_start.assign(num_format_lines + 2, 0);
+  for (int64_t i : cone)
+    for (uint32_t j = 0; int64_t a = dep(i, j); ++j) ++fanout_start[a + 1];
+  for (int64_t i = 1; i <= num_format_lines + 1; ++i) fanout_start[i] += fanout_start[i - 1];
+  fanout.resize(fanout_start.back());
+  std::vector<int64_t> pos(fanout_start.begin(), fanout_start.end() - 1);
+  for (int64_t i : cone)
+    for (uint32_t j = 0; int64_t a = dep(i, j); ++j) fanout[pos[a]++] = i;
+
+  for (int64_t i : cone) {
+    Btor2Line *l = btor2parser_get_line_by_id(model, i);
+    if ((l->tag == BTOR2_TAG_input && !l->next) || (l->tag == BTOR2_TAG_state && !inits[i]))
+      event_leaves.push_back(i);
+  }
+  msg(1, "redrawing %u of %zu leaves per step", flips, event_leaves.size());
+}
+
+/* number the nodes of every frame as 'btorexpand -e <bound>' does */
+static void setup_expand_ids() {
+  expand_id.assign(bound + 1, std::vector<int64_t>(num_format_lines + 1, 0));
+  int64_t line_id = 0;
+  for (int64_t t = 0; t <= bound; ++t)
+    for (int64_t i = 1; i <= num_format_lines; ++i) {
+      Btor2Line *l = btor2parser_get_line_by_id(model, i);
+      if (!l) continue;
+      switch (l->tag) {
+        case BTOR2_TAG_sort:
+          /* the sort and a zero of it are only written once */
+          if (t) break;
+          line_id += 2;
+          if (l->sort.tag == BTOR2_TAG_SORT_bitvec)
+            expand_zero.emplace_back(line_id, l->sort.bitvec.width);
+          break;
+        case BTOR2_TAG_init:
+        case BTOR2_TAG_next:break;
+        case BTOR2_TAG_const:
+        case BTOR2_TAG_constd:
+        case BTOR2_TAG_consth:
+        case BTOR2_TAG_one:
+        case BTOR2_TAG_ones:
+        case BTOR2_TAG_zero:
+          if (!t) expand_id[t][i] = ++line_id;
+          break;
+        default:expand_id[t][i] = ++line_id;
+          break;
+      }
+      /* properties and outputs are numbered but not simulated */
+      if (!is_evaluated(l)) expand_id[t][i] = 0;
+    }
+  num_hash_ids = line_id + 1;
+
+  /* the state of every frame stands for a state of the unrolled model */
+  for (int t = 0; t <= bound; ++t)
+    for (Btor2Line *state : states) {
+      parse_states.emplace_back(state, std::make_pair((int) state->id, t));
+      std::string symbol = state->symbol ? std::string(state->symbol) + "." : "";
+      expand_symbol.push_back(symbol + "state.id_" + std::to_string(state->id) + ".time_" + std::to_string(t));
+    }
+}
+
+/* the node and frame every hash id stands for, sliced as set by '--slices' */
+static void setup_slices() {
+  hash_width.assign(num_hash_ids, 0);
+  hash_node.assign(num_hash_ids, std::make_pair(0, 0));
+  for (int64_t t = 0; t <= std::max<int64_t>(bound, 0); ++t)
+    for (int64_t i = 1; i <= num_format_lines; ++i) {
+      int64_t id = bound >= 0 ? expand_id[t][i] : i;
+      if (!id || !has_hash(i)) continue;
+      hash_width[id] = btor2parser_get_line_by_id(model, i)->sort.bitvec.width;
+      hash_node[id] = std::make_pair(i, t);
+    }
+  for (auto &z : expand_zero) hash_width[z.first] = z.second;
+
+  slice_base.assign(num_hash_ids, 0);
+  for (int64_t i = 1; i < first_slice_id; ++i) {
+    if (hash_width[i] <= slice_width) continue;
+    slice_base[i] = num_hash_ids;
+    for (uint32_t lower = 0; lower < hash_width[i]; lower += slice_width, ++num_hash_ids)
+      slice_parent.push_back(i);
+  }
+  msg(1, "hashing %" PRId64 " slices of at most %u bits", num_hash_ids - first_slice_id, slice_width);
+}
+
+/* the hash id of the node a slice is cut from and its bounds */
+static int64_t slice_bounds(int64_t id, uint32_t &upper, uint32_t &lower) {
+  int64_t parent = slice_parent[id - first_slice_id];
+  lower = (uint32_t) (id - slice_base[parent]) * slice_width;
+  upper = std::min(lower + slice_width, hash_width[parent]) - 1;
+  return parent;
+}
+
+/* the nodes whose classes are reported, as (hash id, width, printed id) */
+static std::vector<std::tuple<int64_t, uint32_t, int64_t>> reported_nodes() {
+  std::vector<std::tuple<int64_t, uint32_t, int64_t>> res;
+  int64_t number_of_lines = btor2parser_max_id(model);
+  if (bound >= 0) {
+    for (int64_t t = 0; t <= bound; ++t)
+      for (int64_t i = 1; i <= number_of_lines; ++i) {
+        int64_t id = expand_id[t][i];
+        Btor2Line *line = btor2parser_get_line_by_id(model, i);
+        if (!id || !has_hash(i)) continue;
+        if (!all_hash && line->tag != BTOR2_TAG_state) continue;
+        res.emplace_back(id, line->sort.bitvec.width, all_hash ? id : i);
+      }
+    if (all_hash)
+      for (auto &z : expand_zero) res.emplace_back(z.first, z.second, z.first);
+  } else if (all_hash) {
+    for (int64_t i = 1; i <= number_of_lines; ++i) {
+      if (!has_hash(i)) continue;
+      res.emplace_back(i, btor2parser_get_line_by_id(model, i)->sort.bitvec.width, i);
+    }
+  } else {
+    for (auto &p : parse_states)
+      res.emplace_back(p.first->id, p.first->sort.bitvec.width, p.second.first);
+  }
+  for (int64_t id = first_slice_id; id < num_hash_ids; ++id) {
+    uint32_t upper, lower;
+    slice_bounds(id, upper, lower);
+    res.emplace_back(id, upper - lower + 1, id);
+  }
+  return res;
+}
+
+/* reserve the signatures of the reported nodes for 'steps' steps */
+static void setup_exact(int64_t steps) {
+  std::vector<uint32_t> widths(num_hash_ids, 0);
+  for (auto &r : reported_nodes()) widths[std::get<0>(r)] = std::get<1>(r);
+  std::string error;
+  if (!signatures.init(widths, steps, exact_dir, error)) {
+    fprintf(stderr, "*** 'simubtor' error: %s\n", error.c_str());
+    exit(1);
+  }
+  msg(1, "keeping exact signatures in %.1f MB%s%s", signatures.bytes() / (double) (1 << 20),
+      exact_dir ? " in " : "", exact_dir ? exact_dir : "");
+}
+
+static void print_candidate(int64_t id) {
+  if (id < first_slice_id) {
+    fprintf(output_file, "%" PRId64, id);
+    return;
+  }
+  uint32_t upper, lower;
+  int64_t parent = slice_bounds(id, upper, lower);
+  fprintf(output_file, "%" PRId64 "[%u:%u]", parent, upper, lower);
+}
+
+/* whether the equivalence of 'x < y', where 'y' is a slice, follows from
+ * the one of the whole nodes, i.e. the representatives in 'class_rep', or
+ * 'x' is a 'slice' line cutting out 'y' */
+static bool implied_candidate(int64_t x, int64_t y, const std::vector<int64_t> &class_rep) {
+  uint32_t yu, yl;
+  int64_t py = slice_bounds(y, yu, yl);
+  if (x >= first_slice_id) {
+    uint32_t xu, xl;
+    int64_t px = slice_bounds(x, xu, xl);
+    return xl == yl && xu == yu && class_rep[px] && class_rep[px] == class_rep[py];
+  }
+  if (!hash_node[x].first) return 0;
+  Btor2Line *l = btor2parser_get_line_by_id(model, hash_node[x].first);
+  if (l->tag != BTOR2_TAG_slice || l->args[0] < 0 || l->args[1] != yu || l->args[2] != yl) return 0;
+  if (bound < 0) return l->args[0] == py;
+  int64_t t = hash_node[x].second, id = expand_id[t][l->args[0]];
+  return (id ? id : expand_id[0][l->args[0]]) == py;
+}
+
+/* restrict an input to the values satisfying 'x op c' (unsigned) */
+static void restrict_input(Btor2Line *input, Btor2Tag op, uint64_t c) {
+  InputRange &r = input_range[input->id];
+  if (!r.restricted)
+    r.restricted = true, r.lo = 0, r.hi = btorsim_lane_mask(input->sort.bitvec.width);
+  switch (op) {
+    case BTOR2_TAG_ult:
+      if (!c) r.lo = 1, r.hi = 0;
+      else r.hi = std::min(r.hi, c - 1);
+      break;
+    case BTOR2_TAG_ulte:r.hi = std::min(r.hi, c);
+      break;
+    case BTOR2_TAG_ugt:
+      if (c == ~0ull) r.lo = 1, r.hi = 0;
+      else r.lo = std::max(r.lo, c + 1);
+      break;
+    default:assert (op == BTOR2_TAG_ugte);
+      r.lo = std::max(r.lo, c);
+      break;
+  }
+}
+
+/* Derive from the constraints which values the inputs can take: starting at
+ * the constraints, polarities are propagated through 'and', 'or' and 'not',
+ * and every equality or unsigned comparison of an input with a constant
+ * that has to hold fixes the input or narrows its range.  The inputs are
+ * then only sampled from these values, the constraints are still checked
+ * in every step.  'sim' has simulated step 0, where the constants are set.
+ */
+static void setup_sampling(Simulator *sim) {
+  std::vector<char> is_const(num_format_lines + 1, 0);
+  for (int64_t i = 1; i <= num_format_lines; ++i) {
+    Btor2Line *line = btor2parser_get_line_by_id(model, i);
+    if (!line || line->tag == BTOR2_TAG_input || line->tag == BTOR2_TAG_state) continue;
+    if (line->sort.tag != BTOR2_TAG_SORT_bitvec) continue;
+    bool c = true;
+    for (uint32_t j = 0; j < line->nargs; ++j) c = c && is_const[labs(line->args[j])];
+    is_const[i] = c;
+  }
+  auto free_input = [&](int64_t id) {
+    Btor2Line *line = btor2parser_get_line_by_id(model, labs(id));
+    return line->tag == BTOR2_TAG_input && line->sort.tag == BTOR2_TAG_SORT_bitvec
+        && !line->next;
+  };
+  /* inputs without symbol are named by their id */
+  auto name = [](Btor2Line *line) {
+    return line->symbol ? std::string(line->symbol) : "input " + std::to_string(line->id);
+  };
+
+  std::vector<short> cons(num_format_lines + 1, 0);
+  for (int64_t i = num_format_lines; i > 0; --i) {
+    Btor2Line *line = btor2parser_get_line_by_id(model, i);
+    if (!line) continue;
+
+    if (line->tag == BTOR2_TAG_constraint) {
+      int64_t id = line->args[0];
+      cons[labs(id)] = id < 0 ? -1 : 1;
+    } else if (line->tag == BTOR2_TAG_and) {
+      if (cons[i] <= 0) continue;
+      for (int64_t j = 0; j < line->nargs; ++j) {
+        int id = labs(line->args[j]);
+        if (line->args[j] < 0) cons[id] = -1;
+        else cons[id] = 1;
+      }
+    } else if (line->tag == BTOR2_TAG_or) {
+      if (cons[i] >= 0) continue;
+      for (int64_t j = 0; j < line->nargs; ++j) {
+        int id = labs(line->args[j]);
+        if (line->args[j] < 0) cons[id] = 1;
+        else cons[id] = -1;
+      }
+    } else if (line->tag == BTOR2_TAG_not) {
+      int64_t id = line->args[0];
+      if (cons[i]) cons[labs(id)] = id < 0 ? cons[i] : -cons[i];
+    } else if (line->tag == BTOR2_TAG_eq || line->tag == BTOR2_TAG_neq) {
+      if (cons[i] != (line->tag == BTOR2_TAG_eq ? 1 : -1)) continue;
+      int64_t p = line->args[0], q = line->args[1];
+      if (free_input(q) && is_const[labs(p)]) std::swap(p, q);
+      if (!free_input(p) || !is_const[labs(q)]) continue;
+
+      Btor2Line *model_p = btor2parser_get_line_by_id(model, labs(p));
+      model_p->next = fixed_input.size();
+
+      BtorSimBitVector *bv = btorsim_bv_copy(sim->current_state[labs(q)].bv_state);
+      if ((p < 0) != (q < 0)) {
+        BtorSimBitVector *neg = btorsim_bv_not(bv);
+        btorsim_bv_free(bv);
+        bv = neg;
+      }
+      fixed_input.push_back(bv);
+
+      fprintf(log_file, "[simubtor] parse constraints: %s must equal to ", name(model_p).c_str());
+      for (int j = bv->width - 1; j >= 0; --j)
+        fprintf(log_file, "%d", btorsim_bv_get_bit(bv, j));
+      fprintf(log_file, "\n");
+    } else if (line->tag == BTOR2_TAG_ult || line->tag == BTOR2_TAG_ulte
+        || line->tag == BTOR2_TAG_ugt || line->tag == BTOR2_TAG_ugte) {
+      if (!cons[i]) continue;
+      int64_t p = line->args[0], q = line->args[1];
+      Btor2Tag op = line->tag;
+      if (q > 0 && free_input(q) && is_const[labs(p)]) {
+        /* 'c op x' is 'x op' c' with the operands swapped */
+        std::swap(p, q);
+        op = op == BTOR2_TAG_ult ? BTOR2_TAG_ugt
+            : op == BTOR2_TAG_ulte ? BTOR2_TAG_ugte
+            : op == BTOR2_TAG_ugt ? BTOR2_TAG_ult : BTOR2_TAG_ulte;
+      }
+      if (p < 0 || !free_input(p) || !is_const[labs(q)]) continue;
+      Btor2Line *input = btor2parser_get_line_by_id(model, p);
+      if (input->sort.bitvec.width > 64) continue;
+      if (cons[i] < 0)
+        op = op == BTOR2_TAG_ult ? BTOR2_TAG_ugte
+            : op == BTOR2_TAG_ulte ? BTOR2_TAG_ugt
+            : op == BTOR2_TAG_ugt ? BTOR2_TAG_ulte : BTOR2_TAG_ult;
+      BtorSimBitVector *c = sim->current_state[labs(q)].bv_state;
+      uint64_t value = btorsim_bv_to_uint64(c);
+      if (q < 0) value = ~value & btorsim_lane_mask(c->width);
+      restrict_input(input, op, value);
+    }
+  }
+
+  int64_t restricted = 0;
+  for (Btor2Line *input : inputs) {
+    InputRange &r = input_range[input->id];
+    if (!r.restricted || input->next) {
+      r.restricted = false;
+      continue;
+    }
+    if (r.lo > r.hi) {
+      fprintf(log_file, "[simubtor] parse constraints: %s has no admissible value\n", name(input).c_str());
+      r.restricted = false;
+      continue;
+    }
+    ++restricted;
+    fprintf(log_file, "[simubtor] parse constraints: %s must be in [%" PRIu64 ", %" PRIu64 "]\n",
+            name(input).c_str(), r.lo, r.hi);
+  }
+  msg(1, "sampling %" PRId64 " of %zu inputs from a restricted range", restricted, inputs.size());
+}
+
+static void random_simulation(int64_t k, uint32_t s, uint32_t hash_seed) {
+  hash_value.resize(num_hash_ids, std::make_pair(0ull, 0ull));
+  if (bound >= 0 && flips) {
+    msg(1, "sequential mode redraws all inputs");
+    flips = 0;
+  }
+  if (exact && flips) {
+    msg(1, "exact signatures need every node in every step, disabling event-driven mode");
+    flips = 0;
+  }
+  if ((bound >= 0 || flips) && (lanes || native)) {
+    msg(1, "%s mode simulates one pattern at once", flips ? "event-driven" : "sequential");
+    lanes = 0, native = false;
+  }
+  if (native && !lanes) lanes = 64;
+  if (lanes && !setup_lanes()) {
+    msg(1, "arrays are not supported in lane-parallel mode, simulating one pattern at once");
+    lanes = 0;
+  }
+  if (lanes && native) setup_native();
+
+  input_range.assign(num_format_lines + 1, InputRange());
+  Simulator *sim = new Simulator();
+  sim->seed(s, hash_seed);
+  sim->log.file = log_file;
+
+  int64_t succ = 0;
+  sim->run_step(0, 1);
+  setup_sampling(sim);
+  sim->reset_state();
+  if (flips) setup_events();
+
+  if (stress) {
+    delete sim;
+    succ = stress_simulation(k, s, hash_seed);
+  } else if (threads) {
+    delete sim;
+    succ = parallel_simulation(k, s, hash_seed);
+  } else {
+    if (bound >= 0) sim->sequential_simulation(1, k);
+    else if (lanes) sim->lane_simulation(1, k);
+    else if (flips) sim->event_simulation(1, k);
+    else sim->scalar_simulation(1, k);
+    succ = sim->succ;
+    hash_value.swap(sim->hash_value);
+    hash_time = sim->hash_time;
+    reached_bads.swap(sim->reached_bads);
+    num_unreached_bads = sim->num_unreached_bads;
+    delete sim;
+  }
+
+  if (print_hash) {
+    fprintf(log_file, "$hash value\n");
+    print_all_hash(succ);
+  }
+  report();
+  fprintf(log_file, "[simubtor] successful simulation: %" PRId64 "/%" PRId64 "\n", succ, k);
+  fprintf(log_file, "[simubtor] accepted patterns: %.2f%%\n", k ? 100.0 * succ / k : 0.0);
+  fprintf(log_file, "[simubtor] time spent hashing: %.3fs (%s)\n",
+          hash_time, poly_hash ? "polynomial" : "word-wise");
 }
 
 int main(int argc, char const *argv[]) {
@@ -995,6 +2829,28 @@ int main(int argc, char const *argv[]) {
         fprintf(stderr, "*** 'simubtor' error: invalid number in '-r %s'", argv[i]);
         exit(1);
       }
+    } else if (!strcmp(argv[i], "-l")) {
+      int32_t l;
+      if (++i >= argc) {
+        fprintf(stderr, "*** 'simubtor' error: argument to '-l' missing\n");
+        exit(1);
+      }
+      if (!parse_int(argv[i], &l)) {
+        fprintf(stderr, "*** 'simubtor' error: invalid number in '-l %s'", argv[i]);
+        exit(1);
+      }
+      lanes = (uint32_t) l;
+    } else if (!strcmp(argv[i], "-t")) {
+      int32_t t;
+      if (++i >= argc) {
+        fprintf(stderr, "*** 'simubtor' error: argument to '-t' missing\n");
+        exit(1);
+      }
+      if (!parse_int(argv[i], &t)) {
+        fprintf(stderr, "*** 'simubtor' error: invalid number in '-t %s'", argv[i]);
+        exit(1);
+      }
+      threads = (uint32_t) t;
     } else if (!strcmp(argv[i], "-c")) {
       if (++i >= argc) {
         fprintf(stderr, "*** 'simubtor' error: argument to '-c' missing\n");
@@ -1035,9 +2891,72 @@ int main(int argc, char const *argv[]) {
       print_states = true;
     else if (!strcmp(argv[i], "--hash"))
       print_hash = true;
+    else if (!strcmp(argv[i], "--native"))
+      native = true;
+    else if (!strcmp(argv[i], "--cache")) {
+      if (++i == argc) {
+        fprintf(stderr, "*** 'simubtor' error: argument to '--cache' missing\n");
+        exit(1);
+      }
+      cache_dir = argv[i];
+    } else if (!strcmp(argv[i], "--poly-hash"))
+      poly_hash = true;
     else if (!strcmp(argv[i], "--check-all"))
       all_hash = true;
-    else {
+    else if (!strcmp(argv[i], "--bound")) {
+      int32_t b;
+      if (++i == argc) {
+        fprintf(stderr, "*** 'simubtor' error: argument to '--bound' missing\n");
+        exit(1);
+      }
+      if (!parse_int(argv[i], &b)) {
+        fprintf(stderr, "*** 'simubtor' error: invalid number in '--bound %s'", argv[i]);
+        exit(1);
+      }
+      bound = b;
+    } else if (!strcmp(argv[i], "--flip")) {
+      int32_t f;
+      if (++i == argc) {
+        fprintf(stderr, "*** 'simubtor' error: argument to '--flip' missing\n");
+        exit(1);
+      }
+      if (!parse_int(argv[i], &f)) {
+        fprintf(stderr, "*** 'simubtor' error: invalid number in '--flip %s'", argv[i]);
+        exit(1);
+      }
+      flips = (uint32_t) f;
+    } else if (!strcmp(argv[i], "--slices")) {
+      int32_t w;
+      if (++i == argc) {
+        fprintf(stderr, "*** 'simubtor' error: argument to '--slices' missing\n");
+        exit(1);
+      }
+      if (!parse_int(argv[i], &w) || w < 1 || w > 64) {
+        fprintf(stderr, "*** 'simubtor' error: invalid number in '--slices %s'", argv[i]);
+        exit(1);
+      }
+      slice_width = (uint32_t) w;
+    } else if (!strcmp(argv[i], "--stress")) {
+      int32_t n;
+      if (++i == argc) {
+        fprintf(stderr, "*** 'simubtor' error: argument to '--stress' missing\n");
+        exit(1);
+      }
+      if (!parse_int(argv[i], &n) || n < 1) {
+        fprintf(stderr, "*** 'simubtor' error: invalid number in '--stress %s'", argv[i]);
+        exit(1);
+      }
+      stress = (uint32_t) n;
+    } else if (!strcmp(argv[i], "--exact"))
+      exact = true;
+    else if (!strcmp(argv[i], "--exact-dir")) {
+      if (++i == argc) {
+        fprintf(stderr, "*** 'simubtor' error: argument to '--exact-dir' missing\n");
+        exit(1);
+      }
+      exact = true;
+      exact_dir = argv[i];
+    } else {
       fprintf(stderr, "*** 'simubtor' error: invalid command line option '%s'", argv[i]);
       exit(1);
     }
@@ -1048,9 +2967,26 @@ int main(int argc, char const *argv[]) {
 
   parse_model();
   fixed_input.resize(1);
+  if (bound >= 0) setup_expand_ids();
+  else num_hash_ids = num_format_lines + 1;
+  first_slice_id = num_hash_ids;
+  if (slice_width && !all_hash) {
+    fprintf(stderr, "*** 'simubtor' error: '--slices' requires '--check-all'\n");
+    exit(1);
+  }
+  if (slice_width) setup_slices();
+  if (stress && threads) {
+    fprintf(stderr, "*** 'simubtor' error: '--stress' and '-t' exclude each other\n");
+    exit(1);
+  }
+  if (stress && exact) {
+    fprintf(stderr, "*** 'simubtor' error: '--stress' does not support '--exact'\n");
+    exit(1);
+  }
 
   int64_t number_of_lines = btor2parser_max_id(model);
-  for (int i = 1; i <= number_of_lines; ++i) {
+  /* the states of an unrolled model are recognized by their symbols */
+  for (int i = 1; i <= number_of_lines && bound < 0; ++i) {
     Btor2Line *line = btor2parser_get_line_by_id(model, i);
     if (!line || !line->symbol) continue;
 
@@ -1077,52 +3013,71 @@ int main(int argc, char const *argv[]) {
       parse_states.emplace_back(line, info);
   }
 
+  setup_cone();
+  if (exact) setup_exact(step);
   if (s < 0) s = 0;
   if (hash_seed < 0) hash_seed = 0;
-  setup_states();
-  btorsim_rng_init(&rng, (uint32_t) s);
-  btorsim_rng_init(&base_rng, (uint32_t) hash_seed);
-  random_simulation(step);
-
-  std::vector<std::tuple<uint64_t, uint64_t, uint32_t, int>> hash_set;
-  if (all_hash) {
-    for (size_t i = 1; i <= number_of_lines; ++i) {
-      if (current_state[i].type != BtorSimState::BITVEC) continue;
-      if (!current_state[i].bv_state) continue;
-      Btor2Line *line = btor2parser_get_line_by_id(model, i);
-      hash_set.emplace_back(hash_value[i].first, hash_value[i].second,
-                            line->sort.bitvec.width, i);
-    }
-  } else {
-    for (size_t i = 0, n = parse_states.size(); i < n; ++i) {
-      Btor2Line *line = parse_states[i].first;
-      hash_set.emplace_back(hash_value[line->id].first, hash_value[line->id].second,
-                            line->sort.bitvec.width, parse_states[i].second.first);
-    }
+  random_simulation(step, (uint32_t) s, (uint32_t) hash_seed);
+
+  /* (hash, width, printed id, hash id) */
+  std::vector<std::tuple<uint64_t, uint64_t, uint32_t, int64_t, int64_t>> hash_set;
+  for (auto &r : reported_nodes()) {
+    int64_t id = std::get<0>(r);
+    hash_set.emplace_back(hash_value[id].first, hash_value[id].second, std::get<1>(r), std::get<2>(r), id);
   }
   std::sort(hash_set.begin(), hash_set.end());
+  /* with exact signatures the nodes of equal hashes are split further by
+   * their simulation vectors */
+  auto same_signature = [&](size_t a, size_t b) {
+    return !exact || !signatures.compare(std::get<4>(hash_set[a]), std::get<4>(hash_set[b]));
+  };
+  if (exact) {
+    int64_t collisions = 0;
+    for (size_t i = 0, j, n = hash_set.size(); i < n; i = j + 1) {
+      for (j = i; j + 1 < n && std::get<0>(hash_set[i]) == std::get<0>(hash_set[j + 1])
+          && std::get<1>(hash_set[i]) == std::get<1>(hash_set[j + 1])
+          && std::get<2>(hash_set[i]) == std::get<2>(hash_set[j + 1]); ++j);
+      if (i == j) continue;
+      std::sort(hash_set.begin() + i, hash_set.begin() + j + 1, [](const auto &x, const auto &y) {
+        int c = signatures.compare(std::get<4>(x), std::get<4>(y));
+        return c ? c < 0 : x < y;
+      });
+      for (size_t k = i; k < j; ++k)
+        if (!same_signature(k, k + 1)) ++collisions;
+    }
+    msg(1, "split %" PRId64 " hash collisions by exact signatures", collisions);
+  }
 
-  int group = 0;
-  std::set<std::pair<int, int>> candidate;
-  for (size_t i = 0, n = hash_set.size(); i < n;) {
-    size_t j;
-    std::set<int> set_id;
+  /* the ids of a class are sorted and may repeat (states of several frames
+   * in state-only mode), a class of 2 to 'capacity' members is written as a
+   * star, pairing every member with the representative, its smallest id */
+  std::vector<std::pair<size_t, size_t>> classes;
+  for (size_t i = 0, j, n = hash_set.size(); i < n; i = j + 1) {
+    size_t members = 1;
     for (j = i; j + 1 < n && std::get<0>(hash_set[i]) == std::get<0>(hash_set[j + 1])
         && std::get<1>(hash_set[i]) == std::get<1>(hash_set[j + 1])
-        && std::get<2>(hash_set[i]) == std::get<2>(hash_set[j + 1]); ++j);
-
-    for (size_t k = i; k <= j; ++k) set_id.insert(std::get<3>(hash_set[k]));
-    if (1 < set_id.size() && set_id.size() <= capacity) {
-      for (auto x : set_id)
-        for (auto y : set_id)
-          if (x != y) candidate.insert(std::make_pair(std::min(x, y), std::max(x, y)));
-      ++group;
+        && std::get<2>(hash_set[i]) == std::get<2>(hash_set[j + 1]) && same_signature(i, j + 1); ++j)
+      if (std::get<3>(hash_set[j]) != std::get<3>(hash_set[j + 1])) ++members;
+    if (1 < members && members <= (size_t) capacity) classes.emplace_back(i, j);
+  }
+  std::vector<int64_t> class_rep(num_hash_ids, 0);
+  for (auto &c : classes)
+    for (size_t k = c.first; k <= c.second; ++k)
+      class_rep[std::get<3>(hash_set[k])] = std::get<3>(hash_set[c.first]);
+
+  int64_t num_candidates = 0;
+  for (auto &c : classes) {
+    int64_t x = std::get<3>(hash_set[c.first]);
+    for (size_t k = c.first + 1; k <= c.second; ++k) {
+      int64_t y = std::get<3>(hash_set[k]);
+      if (y == std::get<3>(hash_set[k - 1])) continue;
+      if (y >= first_slice_id && implied_candidate(x, y, class_rep)) continue;
+      print_candidate(x), fputc(' ', output_file);
+      print_candidate(y), fputc('\n', output_file);
+      ++num_candidates;
     }
-    i = j + 1;
   }
-  for (auto x : candidate)
-    fprintf(output_file, "%d %d\n", x.first, x.second);
-  printf("candidate: %d\ngroup: %d\n", candidate.size(), group);
+  printf("candidate: %" PRId64 "\ngroup: %zu\n", num_candidates, classes.size());
 
   btor2parser_delete(model);
 
@@ -21,6 +21,22 @@
 
 /*------------------------------------------------------------------------*/
 
+#ifdef BTOR2_MEM_STATS
+/* number of allocations and bytes requested, defined by the benchmarks */
+#ifdef __cplusplus
+extern "C" {
+#endif
+extern size_t btor2_mem_allocs, btor2_mem_bytes;
+#ifdef __cplusplus
+}
+#endif
+#define BTOR2_MEM_COUNT(size) (btor2_mem_allocs++, btor2_mem_bytes += (size))
+#else
+#define BTOR2_MEM_COUNT(size) ((void) 0)
+#endif
+
+/*------------------------------------------------------------------------*/
+
 #define BTOR2_NEWN(ptr, nelems) \
   ((ptr) = (typeof(ptr)) btorsim_malloc ((nelems) * sizeof *(ptr)))
 
@@ -45,6 +61,7 @@ btorsim_malloc (size_t size)
 {
   void *res;
   if (!size) return 0;
+  BTOR2_MEM_COUNT (size);
   res = malloc (size);
   if (!res)
   {
@@ -58,6 +75,7 @@ static inline void *
 btorsim_calloc (size_t nobj, size_t size)
 {
   void *res;
+  BTOR2_MEM_COUNT (nobj * size);
   res = calloc (nobj, size);
   if (!res)
   {
@@ -71,6 +89,7 @@ static inline void *
 btorsim_realloc (void *p, size_t new_size)
 {
   void *res;
+  BTOR2_MEM_COUNT (new_size);
   res = realloc (p, new_size);
   if (!res)
   {